@@ -0,0 +1,69 @@
+/**
+ * Per-device noise-gate calibration, persisted across app restarts.
+ *
+ * The native engine learns the room's noise floor during the first ~2 s
+ * of every start. addon.getCalibration() returns what it learned after
+ * stop(); saving that per input device and handing it back through
+ * addon.setCalibration() before the next start() lets the gate work from
+ * the first frame.
+ *
+ * File layout (JSON):
+ *   { version: 1, devices: { "<device key>": { savedAt, calibration } } }
+ */
+
+const { createJsonStore } = require("./json-store");
+
+const FILE_VERSION = 1;
+
+/* A calibration older than this is dropped: the room has likely changed. */
+const DEFAULT_MAX_AGE_MS = 30 * 24 * 60 * 60 * 1000;
+
+const FIELDS = ["noiseFloor", "calibratedFrames", "residualFloor", "gateGain"];
+
+/** Key for an input device: its name, or "default" for the system default. */
+function deviceKey(devices, inputIdx) {
+  if (inputIdx === undefined || inputIdx < 0) return "default";
+  const inputs = (devices && devices.inputs) || [];
+  const match = inputs.find((d) => d.index === inputIdx);
+  return match ? match.name : "default";
+}
+
+function isCalibration(value) {
+  return (
+    value !== null &&
+    typeof value === "object" &&
+    FIELDS.every((k) => typeof value[k] === "number" && Number.isFinite(value[k]))
+  );
+}
+
+function createCalibrationStore(filePath, options = {}) {
+  const maxAgeMs = options.maxAgeMs !== undefined ? options.maxAgeMs : DEFAULT_MAX_AGE_MS;
+  const now = options.now || Date.now;
+
+  const file = createJsonStore(filePath, FILE_VERSION);
+
+  /** Saved calibration for `key`, or null if none / stale / malformed. */
+  function load(key) {
+    const entry = file.read().devices[key];
+    if (!entry || !isCalibration(entry.calibration)) return null;
+    if (typeof entry.savedAt !== "number" || now() - entry.savedAt > maxAgeMs) return null;
+    const calibration = {};
+    for (const k of FIELDS) calibration[k] = entry.calibration[k];
+    return calibration;
+  }
+
+  /** Store `calibration` for `key`. Returns false (nothing written) if malformed. */
+  function save(key, calibration) {
+    if (!isCalibration(calibration)) return false;
+    const data = file.read();
+    const stored = {};
+    for (const k of FIELDS) stored[k] = calibration[k];
+    data.devices[key] = { savedAt: now(), calibration: stored };
+    file.write(data);
+    return true;
+  }
+
+  return { load, save };
+}
+
+module.exports = { createCalibrationStore, deviceKey, DEFAULT_MAX_AGE_MS };
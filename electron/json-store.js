@@ -0,0 +1,40 @@
+/**
+ * Versioned JSON file of per-device entries, the storage under the
+ * calibration and latency-profile stores.
+ *
+ * File layout (JSON):
+ *   { version: <n>, devices: { "<key>": <entry> } }
+ *
+ * A missing or corrupt file, or one written with another version, reads
+ * as empty. Writes go to a temp file that is then renamed over the old
+ * one.
+ */
+
+const fs = require("fs");
+const path = require("path");
+
+function createJsonStore(filePath, version) {
+  /** The whole file: { version, devices }. */
+  function read() {
+    try {
+      const data = JSON.parse(fs.readFileSync(filePath, "utf8"));
+      if (data && data.version === version && data.devices && typeof data.devices === "object") {
+        return data;
+      }
+    } catch (_err) {
+      /* Missing or corrupt file: start over. */
+    }
+    return { version, devices: {} };
+  }
+
+  function write(data) {
+    fs.mkdirSync(path.dirname(filePath), { recursive: true });
+    const tmp = filePath + ".tmp";
+    fs.writeFileSync(tmp, JSON.stringify(data, null, 2));
+    fs.renameSync(tmp, filePath); /* Never leave a half-written file behind */
+  }
+
+  return { read, write };
+}
+
+module.exports = { createJsonStore };
@@ -0,0 +1,209 @@
+/**
+ * Per-device latency profiles: auto-tuned, persisted across app restarts.
+ *
+ * The right host buffer size and suggested latency differ per device and
+ * host API: a pro interface runs cleanly at 128 frames / low latency,
+ * while a Bluetooth headset or a busy WASAPI shared-mode endpoint needs
+ * the larger, high-latency settings. runAutoTune() starts the engine with
+ * each candidate in turn, measures callback jitter, xruns, underruns and
+ * deadline misses, and picks the lowest-latency profile that ran clean.
+ * The result is saved per (input, output, host API) and handed to
+ * addon.start() as options on later starts.
+ *
+ * Ring depths need no tuning of their own: the engine sizes its rings
+ * from framesPerBuffer and grows the output cushion on underruns.
+ *
+ * File layout (JSON):
+ *   { version: 1, devices: { "<profile key>": { savedAt, profile } } }
+ */
+
+const { createJsonStore } = require("./json-store");
+
+const FILE_VERSION = 1;
+
+const SAMPLE_RATE = 48000;
+
+/* Host buffer sizes tried, in frames (2.7 ms, 5.3 ms, one RNNoise frame). */
+const FRAMES_PER_BUFFER = [128, 256, 480];
+
+/* Stability limits for one trial. */
+const MAX_UNDERRUN_RATIO = 0.005; /* Output samples concealed / played */
+const MAX_MISS_RATIO = 0.01; /* Frames past their deadline / timed */
+
+const FIELDS = ["framesPerBuffer", "inputLatencyMs", "outputLatencyMs"];
+
+function findDevice(list, idx) {
+  if (idx === undefined || idx < 0) return null;
+  return (list || []).find((d) => d.index === idx) || null;
+}
+
+/**
+ * Key for an input/output pair: device names plus host API, or "default"
+ * for the system default. The same device behind another host API (e.g.
+ * MME vs WASAPI) tunes differently, so it gets its own profile.
+ */
+function profileKey(devices, inputIdx, outputIdx) {
+  const input = findDevice(devices && devices.inputs, inputIdx);
+  const output = findDevice(devices && devices.outputs, outputIdx);
+  const name = (d) => (d ? `${d.name} [${d.hostApi || "?"}]` : "default");
+  return `${name(input)} -> ${name(output)}`;
+}
+
+/**
+ * Candidate settings for a device pair, ordered by expected latency
+ * (suggested latencies plus one host buffer each way). Unknown devices
+ * (system default) get 0, which the engine reads as "device default low".
+ */
+function candidateProfiles(devices, inputIdx, outputIdx) {
+  const input = findDevice(devices && devices.inputs, inputIdx);
+  const output = findDevice(devices && devices.outputs, outputIdx);
+  const tiers = [
+    { inputLatencyMs: input ? input.lowLatencyMs : 0, outputLatencyMs: output ? output.lowLatencyMs : 0 },
+    { inputLatencyMs: input ? input.highLatencyMs : 0, outputLatencyMs: output ? output.highLatencyMs : 0 },
+  ];
+  const seen = new Set();
+  const candidates = [];
+  for (const framesPerBuffer of FRAMES_PER_BUFFER) {
+    for (const tier of tiers) {
+      const profile = { framesPerBuffer, ...tier };
+      const id = FIELDS.map((k) => profile[k]).join("/");
+      if (seen.has(id)) continue; /* Low == high (or unknown device) */
+      seen.add(id);
+      candidates.push(profile);
+    }
+  }
+  const expectedMs = (p) => p.inputLatencyMs + p.outputLatencyMs + (2 * p.framesPerBuffer * 1000) / SAMPLE_RATE;
+  return candidates.sort((a, b) => expectedMs(a) - expectedMs(b));
+}
+
+/**
+ * A trial is stable when the devices reported no xruns, the engine did
+ * not restart, underruns and deadline misses stay under their limits and
+ * no callback arrived more than one host period late.
+ */
+function isStable(trial) {
+  const periodMs = (trial.profile.framesPerBuffer * 1000) / SAMPLE_RATE;
+  const played = (trial.durationMs * SAMPLE_RATE) / 1000;
+  return (
+    trial.xruns === 0 &&
+    trial.restarts === 0 &&
+    trial.framesTimed > 0 &&
+    trial.underrunSamples <= MAX_UNDERRUN_RATIO * played &&
+    trial.deadlineMisses <= MAX_MISS_RATIO * trial.framesTimed &&
+    trial.jitterMaxMs < periodMs
+  );
+}
+
+/** Lowest measured latency among the stable trials, or null if none ran clean. */
+function pickProfile(trials) {
+  const stable = trials.filter(isStable).sort((a, b) => a.latencyMs - b.latencyMs);
+  return stable.length > 0 ? { ...stable[0].profile, latencyMs: stable[0].latencyMs } : null;
+}
+
+function xrunCount(x) {
+  return x ? x.inputUnderflow + x.inputOverflow + x.outputUnderflow + x.outputOverflow : 0;
+}
+
+const defaultSleep = (ms) => new Promise((resolve) => setTimeout(resolve, ms));
+
+/**
+ * Try every candidate on the given devices. The engine must be stopped;
+ * it is left stopped. Each trial starts the engine with the candidate,
+ * skips `warmupMs` (stream start-up and the output cushion settling),
+ * then measures for `trialMs`.
+ *
+ * Resolves to { profile, trials }; profile is null when nothing ran clean.
+ */
+async function runAutoTune(addon, inputIdx, outputIdx, options = {}) {
+  const trialMs = options.trialMs !== undefined ? options.trialMs : 3000;
+  const warmupMs = options.warmupMs !== undefined ? options.warmupMs : 1000;
+  const sleep = options.sleep || defaultSleep;
+
+  const trials = [];
+  for (const profile of candidateProfiles(addon.getDevices(), inputIdx, outputIdx)) {
+    const errMsg = addon.start(inputIdx, outputIdx, { ...profile });
+    if (errMsg && errMsg.length > 0) {
+      trials.push({ profile, error: errMsg });
+      continue;
+    }
+    try {
+      await sleep(warmupMs);
+      addon.getCallbackTiming(true);
+      const before = addon.getAnomalies();
+      await sleep(trialMs);
+      const after = addon.getAnomalies();
+      const timing = addon.getCallbackTiming();
+      trials.push({
+        profile,
+        durationMs: trialMs,
+        latencyMs: addon.getLatency().totalMs,
+        jitterMaxMs: Math.max(timing.captureJitterMaxMs, timing.outputJitterMaxMs),
+        jitterMeanMs: Math.max(timing.captureJitterMeanMs, timing.outputJitterMeanMs),
+        xruns: xrunCount(after.xruns) - xrunCount(before.xruns),
+        restarts: after.xruns.restarts - before.xruns.restarts,
+        underrunSamples: after.underrunSamples - before.underrunSamples,
+        deadlineMisses: after.deadlineMisses - before.deadlineMisses,
+        framesTimed: after.framesTimed - before.framesTimed,
+      });
+    } finally {
+      addon.stop();
+    }
+  }
+  const measured = trials.filter((t) => !t.error);
+  return { profile: pickProfile(measured), trials };
+}
+
+function isProfile(value) {
+  return (
+    value !== null &&
+    typeof value === "object" &&
+    FIELDS.every((k) => typeof value[k] === "number" && Number.isFinite(value[k]) && value[k] >= 0)
+  );
+}
+
+function createProfileStore(filePath, options = {}) {
+  const now = options.now || Date.now;
+
+  const file = createJsonStore(filePath, FILE_VERSION);
+
+  /** Start options saved for `key` ({ framesPerBuffer, inputLatencyMs, outputLatencyMs }), or null. */
+  function load(key) {
+    const entry = file.read().devices[key];
+    if (!entry || !isProfile(entry.profile)) return null;
+    const profile = {};
+    for (const k of FIELDS) profile[k] = entry.profile[k];
+    return profile;
+  }
+
+  /** Store `profile` for `key`. Returns false (nothing written) if malformed. */
+  function save(key, profile) {
+    if (!isProfile(profile)) return false;
+    const data = file.read();
+    const stored = {};
+    for (const k of FIELDS) stored[k] = profile[k];
+    if (typeof profile.latencyMs === "number") stored.latencyMs = profile.latencyMs;
+    data.devices[key] = { savedAt: now(), profile: stored };
+    file.write(data);
+    return true;
+  }
+
+  /** Forget the profile for `key` (e.g. to fall back to the defaults). */
+  function remove(key) {
+    const data = file.read();
+    if (!(key in data.devices)) return false;
+    delete data.devices[key];
+    file.write(data);
+    return true;
+  }
+
+  return { load, save, remove };
+}
+
+module.exports = {
+  candidateProfiles,
+  createProfileStore,
+  isStable,
+  pickProfile,
+  profileKey,
+  runAutoTune,
+};
@@ -5,6 +5,8 @@
  * - Load the native C++ addon (ainoiceguard.node)
  * - Create system tray icon (no visible window by default)
  * - Handle IPC from renderer for start/stop/device selection
+ * - Persist the learned noise-gate calibration per input device
+ * - Auto-tune and persist host buffer / latency settings per device pair
  * - Ensure clean shutdown of audio engine on app exit
  */
 
@@ -12,6 +14,8 @@ const { app, BrowserWindow, ipcMain, shell } = require("electron");
 const path = require("path");
 const fs = require("fs");
 const { createTray, destroyTray, updateTrayMenu } = require("./tray");
+const { createCalibrationStore, deviceKey } = require("./calibration-store");
+const { createProfileStore, profileKey, runAutoTune } = require("./latency-profiles");
 
 /* ── Load native addon ─────────────────────────────────────────────────────── */
 let addon;
@@ -46,6 +50,62 @@ try {
 
 /* ── State ─────────────────────────────────────────────────────────────────── */
 let mainWindow = null;
+let calibrationStore = null;
+let profileStore = null;
+let autoTuning = false; /* The engine is busy with auto-tune trials */
+let activeDeviceKey = null; /* Input device of the running engine */
+
+/* ── Calibration (warm start) ──────────────────────────────────────────────── */
+
+function getCalibrationStore() {
+  if (!calibrationStore) {
+    calibrationStore = createCalibrationStore(path.join(app.getPath("userData"), "calibration.json"));
+  }
+  return calibrationStore;
+}
+
+/* Hand the saved calibration for this input to the engine before start(). */
+function restoreCalibration(devices, inputIdx) {
+  try {
+    activeDeviceKey = deviceKey(devices, inputIdx);
+    const calibration = getCalibrationStore().load(activeDeviceKey);
+    if (calibration) addon.setCalibration(calibration);
+  } catch (err) {
+    console.error("Failed to restore calibration:", err.message);
+  }
+}
+
+/* Save what the gate learned. Call right after addon.stop(). */
+function saveCalibration() {
+  if (activeDeviceKey === null) return;
+  try {
+    const calibration = addon.getCalibration();
+    if (calibration) getCalibrationStore().save(activeDeviceKey, calibration);
+  } catch (err) {
+    console.error("Failed to save calibration:", err.message);
+  }
+  activeDeviceKey = null;
+}
+
+/* ── Latency profiles (auto-tuned) ─────────────────────────────────────────── */
+
+function getProfileStore() {
+  if (!profileStore) {
+    profileStore = createProfileStore(path.join(app.getPath("userData"), "latency-profiles.json"));
+  }
+  return profileStore;
+}
+
+/* Start options saved for this device pair by the last auto-tune, or {}. */
+function savedProfile(devices, inputIdx, outputIdx) {
+  try {
+    const key = profileKey(devices, inputIdx, outputIdx);
+    return getProfileStore().load(key) || {};
+  } catch (err) {
+    console.error("Failed to load latency profile:", err.message);
+    return {};
+  }
+}
 
 /* ── App Lifecycle ─────────────────────────────────────────────────────────── */
 
@@ -66,6 +126,7 @@ app.on("before-quit", () => {
   try {
     if (addon.isRunning()) {
       addon.stop();
+      saveCalibration();
     }
   } catch (err) {
     console.error("Error stopping audio engine:", err.message);
@@ -120,10 +181,12 @@ function createMainWindow() {
 
 /**
  * audio:get-devices -> { inputs: [...], outputs: [...] }
+ * The one place that asks the addon to re-scan (re-initializing PortAudio
+ * when stopped), so devices plugged in since launch show up.
  */
 ipcMain.handle("audio:get-devices", () => {
   try {
-    return addon.getDevices();
+    return addon.getDevices(true);
   } catch (err) {
     return { inputs: [], outputs: [], error: err.message };
   }
@@ -135,12 +198,16 @@ ipcMain.handle("audio:get-devices", () => {
  * @param {number} outputIdx - Output device index (-1 for default)
  */
 ipcMain.handle("audio:start", (_event, inputIdx, outputIdx) => {
+  if (autoTuning) return { success: false, error: "Auto-tune in progress" };
   try {
-    const errMsg = addon.start(
-      inputIdx !== undefined ? inputIdx : -1,
-      outputIdx !== undefined ? outputIdx : -1,
-    );
+    const input = inputIdx !== undefined ? inputIdx : -1;
+    const output = outputIdx !== undefined ? outputIdx : -1;
+    /* One listing per start, shared by the calibration and profile keys. */
+    const devices = addon.getDevices();
+    restoreCalibration(devices, input);
+    const errMsg = addon.start(input, output, savedProfile(devices, input, output));
     if (errMsg && errMsg.length > 0) {
+      activeDeviceKey = null;
       updateTrayMenu(false);
       return { success: false, error: errMsg };
     }
@@ -151,12 +218,41 @@ ipcMain.handle("audio:start", (_event, inputIdx, outputIdx) => {
   }
 });
 
+/**
+ * audio:auto-tune -> { success: boolean, profile?, trials?, error? }
+ * Tries each candidate buffer size / suggested latency on the device pair
+ * (~4 s each) and saves the lowest-latency one that ran clean; later
+ * audio:start calls on the same pair use it. The engine must be stopped.
+ * @param {number} inputIdx  - Input device index (-1 for default)
+ * @param {number} outputIdx - Output device index (-1 for default)
+ */
+ipcMain.handle("audio:auto-tune", async (_event, inputIdx, outputIdx) => {
+  if (autoTuning) return { success: false, error: "Auto-tune in progress" };
+  if (addon.isRunning()) return { success: false, error: "Stop noise cancellation before auto-tuning" };
+  const input = inputIdx !== undefined ? inputIdx : -1;
+  const output = outputIdx !== undefined ? outputIdx : -1;
+  autoTuning = true;
+  try {
+    const { profile, trials } = await runAutoTune(addon, input, output);
+    if (!profile) {
+      return { success: false, trials, error: "No candidate ran without xruns or underruns" };
+    }
+    getProfileStore().save(profileKey(addon.getDevices(), input, output), profile);
+    return { success: true, profile, trials };
+  } catch (err) {
+    return { success: false, error: err.message };
+  } finally {
+    autoTuning = false;
+  }
+});
+
 /**
  * audio:stop -> { success: boolean }
  */
 ipcMain.handle("audio:stop", () => {
   try {
     addon.stop();
+    saveCalibration();
     updateTrayMenu(false);
     return { success: true };
   } catch (err) {
@@ -209,6 +305,30 @@ ipcMain.handle("audio:get-metrics", () => {
   }
 });
 
+/**
+ * audio:get-latency -> { totalMs, inputDeviceMs, outputQueueMs, ... }
+ * Mic-to-output latency breakdown of the running engine.
+ */
+ipcMain.handle("audio:get-latency", () => {
+  try {
+    return addon.getLatency();
+  } catch (err) {
+    return { totalMs: 0, error: err.message };
+  }
+});
+
+/**
+ * audio:get-anomalies -> { deadlineMisses, worstLatencyMs, records, ... }
+ * Deadline counters and the native anomaly log, for bug reports.
+ */
+ipcMain.handle("audio:get-anomalies", () => {
+  try {
+    return addon.getAnomalies();
+  } catch (err) {
+    return { deadlineMisses: 0, records: [], error: err.message };
+  }
+});
+
 /**
  * audio:set-vad-threshold -> { success: boolean }
  * @param {number} threshold - VAD gate threshold [0.0, 1.0]
@@ -13,9 +13,13 @@ contextBridge.exposeInMainWorld("ainoiceguard", {
   start: (inputIdx, outputIdx) =>
     ipcRenderer.invoke("audio:start", inputIdx, outputIdx),
   stop: () => ipcRenderer.invoke("audio:stop"),
+  autoTune: (inputIdx, outputIdx) =>
+    ipcRenderer.invoke("audio:auto-tune", inputIdx, outputIdx),
   setLevel: (level) => ipcRenderer.invoke("audio:set-level", level),
   getStatus: () => ipcRenderer.invoke("audio:get-status"),
   getMetrics: () => ipcRenderer.invoke("audio:get-metrics"),
+  getAnomalies: () => ipcRenderer.invoke("audio:get-anomalies"),
+  getLatency: () => ipcRenderer.invoke("audio:get-latency"),
   setVadThreshold: (threshold) =>
     ipcRenderer.invoke("audio:set-vad-threshold", threshold),
   openExternal: (url) => ipcRenderer.invoke("app:open-external", url),
@@ -12,6 +12,8 @@ const toggleHint = document.getElementById("toggleHint");
 const statusDot = document.getElementById("statusDot");
 const inputSelect = document.getElementById("inputSelect");
 const outputSelect = document.getElementById("outputSelect");
+const autoTuneBtn = document.getElementById("autoTuneBtn");
+const autoTuneHint = document.getElementById("autoTuneHint");
 const levelSlider = document.getElementById("levelSlider");
 const levelValue = document.getElementById("levelValue");
 const vadThreshSlider = document.getElementById("vadThreshSlider");
@@ -171,6 +173,39 @@ toggleBtn.addEventListener("click", async () => {
   }
 });
 
+/* ── Latency Auto-Tune ───────────────────────────────────────────────────── */
+
+autoTuneBtn.addEventListener("click", async () => {
+  if (!bridge || isRunning) return;
+
+  autoTuneBtn.disabled = true;
+  toggleBtn.disabled = true;
+  statusText.textContent = "Tuning...";
+  autoTuneHint.textContent = "Trying buffer sizes, about 25 s...";
+
+  try {
+    const inputIdx = parseInt(inputSelect.value, 10);
+    const outputIdx = parseInt(outputSelect.value, 10);
+    const result = await bridge.autoTune(inputIdx, outputIdx);
+
+    if (result.success) {
+      const p = result.profile;
+      const latency = Number.isFinite(p.latencyMs) ? `, ~${p.latencyMs.toFixed(0)} ms` : "";
+      autoTuneHint.textContent = `Saved: ${p.framesPerBuffer} samples${latency}. Used on every start with these devices.`;
+      hideError();
+    } else {
+      autoTuneHint.textContent = "Auto-tune found no stable setting; the defaults stay in use.";
+      showError(result.error || "Auto-tune failed");
+    }
+  } catch (err) {
+    showError("Auto-tune error: " + err.message);
+  } finally {
+    statusText.textContent = "Idle";
+    toggleBtn.disabled = false;
+    autoTuneBtn.disabled = isRunning;
+  }
+});
+
 /* ── Suppression Level Slider ────────────────────────────────────────────── */
 
 levelSlider.addEventListener("input", () => {
@@ -329,6 +364,7 @@ function updateUI(running, level) {
   toggleHint.textContent = running ? "Click to disable" : "Click to enable";
   statusDot.classList.toggle("active", running);
   statusText.textContent = running ? "Active" : "Idle";
+  autoTuneBtn.disabled = running; /* Auto-tune needs the engine stopped */
 
   if (!running) {
     latencyText.textContent = "-- ms";
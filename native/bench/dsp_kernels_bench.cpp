@@ -0,0 +1,65 @@
+/**
+ * Per-frame cost of the RNNoise post-processing element-wise loops, for
+ * each kernel table this CPU supports.
+ *
+ * Runs the same sequence processFrame() does around the two RNNoise
+ * passes: input RMS, scale+copy, rescale, blend, gate gain, clamp, output
+ * RMS -- on one 480-sample frame -- and reports ns/frame.
+ *
+ * Build with -DNOISEGUARD_BUILD_BENCHMARKS=ON, then run dsp_kernels_bench.
+ */
+
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <vector>
+
+#include "dsp_kernels.h"
+
+using ainoiceguard::DspKernels;
+
+namespace {
+
+constexpr size_t kFrame = 480;
+constexpr int kIterations = 200000;
+
+volatile float g_sink = 0.0f;  /* Defeats dead-code elimination. */
+
+double benchTable(const DspKernels& k) {
+  alignas(32) float frame[kFrame];
+  alignas(32) float original[kFrame];
+  for (size_t i = 0; i < kFrame; i++) {
+    frame[i] = 0.1f * std::sin(0.05f * static_cast<float>(i));
+  }
+
+  auto t0 = std::chrono::steady_clock::now();
+  float acc = 0.0f;
+  for (int it = 0; it < kIterations; it++) {
+    acc += k.sumSquares(frame, kFrame);
+    k.scaleCopy(frame, original, 32767.0f, kFrame);
+    k.scale(frame, 1.0f / 32767.0f, kFrame);
+    k.blend(frame, original, 0.8f, 0.2f, kFrame);
+    k.scale(frame, 0.999f, kFrame);
+    k.clampBelow(frame, 1e-6f, kFrame);
+    acc += k.sumSquares(frame, kFrame);
+  }
+  auto t1 = std::chrono::steady_clock::now();
+  g_sink = acc;
+
+  double ns = std::chrono::duration<double, std::nano>(t1 - t0).count();
+  return ns / kIterations;
+}
+
+}  // namespace
+
+int main() {
+  std::printf("%-8s %12s %10s\n", "kernels", "ns/frame", "speedup");
+  double scalarNs = 0.0;
+  for (const DspKernels* k : ainoiceguard::supportedDspKernels()) {
+    double ns = benchTable(*k);
+    if (scalarNs == 0.0) scalarNs = ns;
+    std::printf("%-8s %12.1f %9.2fx\n", k->name, ns, scalarNs / ns);
+  }
+  std::printf("dispatch selects: %s\n", ainoiceguard::dspKernels().name);
+  return 0;
+}
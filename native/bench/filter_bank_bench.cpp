@@ -0,0 +1,80 @@
+/**
+ * Cost of an N-section biquad cascade on one 480-sample frame: a plain
+ * per-sample TDF-II loop (section after section inside the sample loop)
+ * vs FilterBank's skewed block kernel.
+ *
+ * Build with -DNOISEGUARD_BUILD_BENCHMARKS=ON, then run filter_bank_bench.
+ */
+
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <vector>
+
+#include "filter_bank.h"
+
+using namespace ainoiceguard;
+
+namespace {
+
+constexpr size_t kFrame = 480;
+constexpr int kIterations = 100000;
+
+volatile float g_sink = 0.0f;  /* Defeats dead-code elimination. */
+
+template <typename Fn>
+double nsPerFrame(Fn fn) {
+  auto t0 = std::chrono::steady_clock::now();
+  for (int it = 0; it < kIterations; it++) fn();
+  auto t1 = std::chrono::steady_clock::now();
+  return std::chrono::duration<double, std::nano>(t1 - t0).count() / kIterations;
+}
+
+}  // namespace
+
+int main() {
+  /* HPF + LPF + 60 Hz hum notches: the shape of a real bank. */
+  std::vector<FilterSpec> specs;
+  FilterSpec hp;
+  hp.type = FilterType::kHighPass;
+  hp.frequency = 80.0;
+  specs.push_back(hp);
+  FilterSpec lp;
+  lp.type = FilterType::kLowPass;
+  lp.frequency = 8000.0;
+  specs.push_back(lp);
+  for (const FilterSpec& s : humNotches(60.0, 13, 24000.0)) specs.push_back(s);
+
+  std::vector<BiquadCoeffs> coeffs(specs.size());
+  for (size_t i = 0; i < specs.size(); i++) designBiquad(specs[i], 48000.0, &coeffs[i]);
+
+  float frame[kFrame];
+  for (size_t i = 0; i < kFrame; i++) {
+    frame[i] = 0.1f * std::sin(0.05f * static_cast<float>(i));
+  }
+
+  std::printf("%-9s %14s %14s\n", "sections", "scalar ns", "bank ns");
+  for (size_t count : {1, 2, 4, 8, 12, 16}) {
+    std::vector<BiquadState> scalar(count);
+    for (size_t k = 0; k < count; k++) scalar[k].setCoeffs(coeffs[k]);
+    FilterBank bank;
+    bank.setSections(coeffs.data(), count);
+
+    double scalarNs = nsPerFrame([&] {
+      float sum = 0.0f;
+      for (size_t i = 0; i < kFrame; i++) {
+        float v = frame[i];
+        for (size_t k = 0; k < count; k++) v = scalar[k].process(v);
+        sum += v * v;
+      }
+      g_sink = g_sink + sum;
+    });
+    double bankNs = nsPerFrame([&] {
+      float x[kFrame];
+      for (size_t i = 0; i < kFrame; i++) x[i] = frame[i];
+      g_sink = g_sink + bank.process(x, kFrame);
+    });
+    std::printf("%-9zu %14.0f %14.0f\n", count, scalarNs, bankNs);
+  }
+  return 0;
+}
@@ -0,0 +1,118 @@
+/**
+ * Per-tier CPU cost and VAD agreement.
+ *
+ * Runs the same synthetic corpus (speech-like tone bursts over white noise
+ * at several SNRs) through one RNNoiseWrapper per configuration:
+ *
+ *   standard          ModelTier::kStandard, SecondPassMode::kAlways
+ *   standard-adaptive ModelTier::kStandard, SecondPassMode::kAdaptive
+ *   little            ModelTier::kLittle (little model if given)
+ *
+ * and reports ns/frame, % of one core for a real-time stream, and how
+ * often each tier's VAD decision (> 0.5) agrees with the standard tier.
+ *
+ * Build with -DNOISEGUARD_BUILD_BENCHMARKS=ON, then run:
+ *   model_tier_bench [little-model-file]
+ */
+
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "rnnoise_model.h"
+#include "rnnoise_wrapper.h"
+#include "synthetic_corpus.h"
+
+using namespace ainoiceguard;
+
+namespace {
+
+constexpr int kFramesPerSnr = 1000;  /* 10 s per noise level */
+const float kNoiseLevels[] = {0.002f, 0.01f, 0.03f};
+
+struct Config {
+  const char* name;
+  ModelTier tier;
+  SecondPassMode mode;
+};
+
+/* The shared speech-like corpus with a 540 Hz overtone, once per noise level. */
+std::vector<float> makeCorpus() {
+  constexpr size_t kSamplesPerSnr = kFramesPerSnr * kRNNoiseFrameSize;
+  const size_t levels = sizeof(kNoiseLevels) / sizeof(kNoiseLevels[0]);
+  std::vector<float> pcm(levels * kSamplesPerSnr);
+  bench::SyntheticCorpus corpus;
+  corpus.overtoneLevel = 0.05f;
+  for (size_t l = 0; l < levels; l++) {
+    corpus.noiseLevel = kNoiseLevels[l];
+    corpus.pos = 0;
+    corpus.fill(pcm.data() + l * kSamplesPerSnr, kSamplesPerSnr);
+  }
+  return pcm;
+}
+
+/* Returns ns/frame; fills vads with the per-frame VAD. */
+double run(const Config& c, const std::vector<float>& corpus,
+           const std::shared_ptr<const RNNoiseModel>& little,
+           std::vector<float>& vads) {
+  RNNoiseWrapper w;
+  w.setModelTier(c.tier);
+  w.setSecondPassMode(c.mode);
+  w.init(nullptr, little);
+
+  const size_t frames = corpus.size() / kRNNoiseFrameSize;
+  vads.assign(frames, 0.0f);
+  float frame[kRNNoiseFrameSize];
+
+  auto t0 = std::chrono::steady_clock::now();
+  for (size_t f = 0; f < frames; f++) {
+    const float* src = corpus.data() + f * kRNNoiseFrameSize;
+    for (size_t i = 0; i < kRNNoiseFrameSize; i++) frame[i] = src[i];
+    vads[f] = w.processFrame(frame);
+  }
+  auto t1 = std::chrono::steady_clock::now();
+  return std::chrono::duration<double, std::nano>(t1 - t0).count() /
+         static_cast<double>(frames);
+}
+
+}  // namespace
+
+int main(int argc, char** argv) {
+  std::shared_ptr<const RNNoiseModel> little;
+  if (argc > 1) {
+    std::string err = RNNoiseModel::load(argv[1], &little);
+    if (!err.empty()) {
+      std::fprintf(stderr, "%s\n", err.c_str());
+      return 1;
+    }
+  }
+  std::printf("little tier model: %s\n\n", little ? argv[1] : "(primary model, single pass)");
+
+  const Config configs[] = {
+      {"standard", ModelTier::kStandard, SecondPassMode::kAlways},
+      {"standard-adaptive", ModelTier::kStandard, SecondPassMode::kAdaptive},
+      {"little", ModelTier::kLittle, SecondPassMode::kAlways},
+  };
+
+  std::vector<float> corpus = makeCorpus();
+  std::vector<float> refVads, vads;
+
+  std::printf("%-18s %12s %10s %14s\n", "tier", "ns/frame", "% core",
+              "VAD agreement");
+  for (const Config& c : configs) {
+    double ns = run(c, corpus, little, vads);
+    if (refVads.empty()) refVads = vads;
+
+    size_t agree = 0;
+    for (size_t i = 0; i < vads.size(); i++) {
+      agree += (vads[i] > 0.5f) == (refVads[i] > 0.5f);
+    }
+    /* One stream produces 100 frames/s: % core = ns/frame * 100 / 1e9 * 100. */
+    std::printf("%-18s %12.0f %9.2f%% %13.1f%%\n", c.name, ns, ns * 1e-5,
+                100.0 * static_cast<double>(agree) / static_cast<double>(vads.size()));
+  }
+  return 0;
+}
@@ -0,0 +1,358 @@
+/**
+ * Pipeline benchmark suite with machine-readable output.
+ *
+ *   ring          RingBuffer write + read, per block size, for each thread
+ *                 placement: one thread, producer/consumer threads, and
+ *                 (Linux) the pair pinned to one core or to two cores.
+ *   processFrame  RNNoiseWrapper::processFrame per configuration: bypass,
+ *                 single / adaptive / double pass, comfort noise on / off.
+ *                 Per-frame latency percentiles on speech-like input.
+ *   engine        The full AudioEngine (rings, processing thread, event
+ *                 thread) on the simulated host of sim_portaudio.h, at
+ *                 real time and at 4x: startup timing, frames kept up with,
+ *                 output underruns, deadline misses, process CPU per frame.
+ *                 Then small host periods (64 / 128 / 256 samples) with
+ *                 cushioned vs immediate output release: mean latency
+ *                 budget and underrun (concealed) time.
+ *
+ * Prints one JSON document to stdout (progress goes to stderr), so runs
+ * can be archived per commit and diffed:
+ *   { "schema": 1, "kernels": ..., "rnnoiseIsa": ...,
+ *     "results": [ { "group", "name", "metrics": { ... } }, ... ] }
+ *
+ * Build with -DNOISEGUARD_BUILD_BENCHMARKS=ON, then run
+ * pipeline_bench [--quick] > results.json.
+ */
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cmath>
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <ctime>
+#include <string>
+#include <thread>
+#include <utility>
+#include <vector>
+
+#ifdef __linux__
+#include <pthread.h>
+#include <sched.h>
+#endif
+
+#include "audio.h"
+#include "dispatch_info.h"
+#include "ringbuffer.h"
+#include "rnnoise_wrapper.h"
+#include "sim_portaudio.h"
+#include "synthetic_corpus.h"
+
+using namespace ainoiceguard;
+using Clock = std::chrono::steady_clock;
+
+namespace {
+
+bool g_quick = false;  /* --quick: ~10x fewer iterations (CI smoke runs) */
+
+volatile float g_sink = 0.0f;  /* Defeats dead-code elimination. */
+
+/* ── JSON output ── */
+
+struct Result {
+  std::string group;
+  std::string name;
+  std::vector<std::pair<std::string, double>> metrics;
+};
+
+std::vector<Result> g_results;
+
+void record(const std::string& group, const std::string& name,
+            std::vector<std::pair<std::string, double>> metrics) {
+  std::fprintf(stderr, "  %-14s %s\n", group.c_str(), name.c_str());
+  g_results.push_back({group, name, std::move(metrics)});
+}
+
+void printJson() {
+  const DispatchInfo& d = dispatchInfo();
+  std::printf("{\n  \"schema\": 1,\n  \"kernels\": \"%s\",\n  \"rnnoiseIsa\": \"%s\",\n"
+              "  \"quick\": %s,\n  \"results\": [\n",
+              d.dspKernels, d.rnnoiseIsa, g_quick ? "true" : "false");
+  for (size_t i = 0; i < g_results.size(); i++) {
+    const Result& r = g_results[i];
+    std::printf("    { \"group\": \"%s\", \"name\": \"%s\", \"metrics\": {",
+                r.group.c_str(), r.name.c_str());
+    for (size_t m = 0; m < r.metrics.size(); m++) {
+      double v = r.metrics[m].second;
+      std::printf("%s\"%s\": %.6g", m ? ", " : " ", r.metrics[m].first.c_str(),
+                  std::isfinite(v) ? v : 0.0);
+    }
+    std::printf(" } }%s\n", i + 1 < g_results.size() ? "," : "");
+  }
+  std::printf("  ]\n}\n");
+}
+
+double secondsSince(Clock::time_point t0) {
+  return std::chrono::duration<double>(Clock::now() - t0).count();
+}
+
+/* ── RingBuffer ── */
+
+enum class Placement { kOneThread, kTwoThreads, kSameCore, kCrossCore };
+
+const char* placementName(Placement p) {
+  switch (p) {
+    case Placement::kOneThread: return "one_thread";
+    case Placement::kTwoThreads: return "two_threads";
+    case Placement::kSameCore: return "pinned_same_core";
+    default: return "pinned_cross_core";
+  }
+}
+
+/* Pin the calling thread to `cpu`. Returns false where unsupported. */
+bool pinTo(int cpu) {
+#ifdef __linux__
+  cpu_set_t set;
+  CPU_ZERO(&set);
+  CPU_SET(cpu, &set);
+  return pthread_setaffinity_np(pthread_self(), sizeof(set), &set) == 0;
+#else
+  (void)cpu;
+  return false;
+#endif
+}
+
+/* Undo pinTo(): allow the calling thread on every CPU again. */
+void unpin() {
+#ifdef __linux__
+  cpu_set_t set;
+  CPU_ZERO(&set);
+  for (unsigned c = 0; c < std::thread::hardware_concurrency() && c < CPU_SETSIZE; c++) {
+    CPU_SET(c, &set);
+  }
+  pthread_setaffinity_np(pthread_self(), sizeof(set), &set);
+#endif
+}
+
+/* Moves `total` samples through a 4096-sample ring in `block`-sized calls. */
+double ringMsamplesPerSec(size_t block, Placement placement, size_t total) {
+  RingBuffer ring(4096);
+  std::vector<float> src(block, 0.25f), dst(block);
+
+  if (placement == Placement::kOneThread) {
+    auto t0 = Clock::now();
+    for (size_t moved = 0; moved < total; moved += block) {
+      ring.write(src.data(), block);
+      ring.read(dst.data(), block);
+    }
+    g_sink = g_sink + dst[0];
+    return static_cast<double>(total) / secondsSince(t0) / 1e6;
+  }
+
+  const int consumerCpu = placement == Placement::kCrossCore ? 1 : 0;
+  std::atomic<bool> go{false};
+  std::thread producer([&] {
+    if (placement == Placement::kSameCore || placement == Placement::kCrossCore) pinTo(0);
+    while (!go.load(std::memory_order_acquire)) {}
+    size_t sent = 0;
+    while (sent < total) {
+      size_t n = ring.write(src.data(), std::min(block, total - sent));
+      if (n == 0) std::this_thread::yield();
+      sent += n;
+    }
+  });
+  if (placement == Placement::kSameCore || placement == Placement::kCrossCore) {
+    pinTo(consumerCpu);
+  }
+
+  auto t0 = Clock::now();
+  go.store(true, std::memory_order_release);
+  size_t received = 0;
+  while (received < total) {
+    size_t n = ring.read(dst.data(), block);
+    if (n == 0) std::this_thread::yield();
+    received += n;
+  }
+  double secs = secondsSince(t0);
+  producer.join();
+  g_sink = g_sink + dst[0];
+  return static_cast<double>(total) / secs / 1e6;
+}
+
+void benchRing() {
+  std::vector<Placement> placements = {Placement::kOneThread, Placement::kTwoThreads};
+#ifdef __linux__
+  if (std::thread::hardware_concurrency() >= 2) {
+    placements.push_back(Placement::kSameCore);
+    placements.push_back(Placement::kCrossCore);
+  }
+#endif
+  const size_t total = g_quick ? (1u << 22) : (1u << 25);
+  for (Placement p : placements) {
+    for (size_t block : {32, 128, 480, 1024}) {
+      double msps = ringMsamplesPerSec(block, p, total);
+      record("ring", std::string(placementName(p)) + "/" + std::to_string(block),
+             {{"msamplesPerSec", msps},
+              {"nsPerBlock", 1e3 * static_cast<double>(block) / msps}});
+    }
+    unpin();
+  }
+}
+
+/* ── processFrame ── */
+
+struct FrameConfig {
+  const char* name;
+  float level;
+  SecondPassMode pass;
+  bool comfortNoise;
+};
+
+void benchProcessFrame() {
+  const FrameConfig configs[] = {
+      {"bypass", 0.0f, SecondPassMode::kAlways, true},
+      {"single_pass/comfort_on", 1.0f, SecondPassMode::kNever, true},
+      {"single_pass/comfort_off", 1.0f, SecondPassMode::kNever, false},
+      {"adaptive_pass/comfort_on", 1.0f, SecondPassMode::kAdaptive, true},
+      {"double_pass/comfort_on", 1.0f, SecondPassMode::kAlways, true},
+      {"double_pass/comfort_off", 1.0f, SecondPassMode::kAlways, false},
+  };
+  const int frames = g_quick ? 300 : 3000;
+  const int warmup = 50;
+
+  for (const FrameConfig& c : configs) {
+    RNNoiseWrapper w;
+    w.setSuppressionLevel(c.level);
+    w.setSecondPassMode(c.pass);
+    w.setComfortNoise(c.comfortNoise);
+    if (!w.init()) {
+      std::fprintf(stderr, "RNNoise init failed\n");
+      continue;
+    }
+
+    std::vector<double> ns;
+    ns.reserve(frames);
+    float frame[kRNNoiseFrameSize];
+    bench::SyntheticCorpus corpus;
+    corpus.seed = 7;
+    for (int n = 0; n < warmup + frames; n++) {
+      corpus.fill(frame, kRNNoiseFrameSize);
+      auto t0 = Clock::now();
+      w.processFrame(frame);
+      auto t1 = Clock::now();
+      if (n >= warmup) ns.push_back(std::chrono::duration<double, std::nano>(t1 - t0).count());
+      g_sink = g_sink + frame[0];
+    }
+
+    std::sort(ns.begin(), ns.end());
+    double mean = 0.0;
+    for (double v : ns) mean += v;
+    mean /= static_cast<double>(ns.size());
+    auto pct = [&](double p) { return ns[static_cast<size_t>(p * (ns.size() - 1))]; };
+    record("processFrame", c.name,
+           {{"meanNs", mean}, {"p50Ns", pct(0.50)}, {"p99Ns", pct(0.99)},
+            {"maxNs", ns.back()},
+            {"realtimeFactor", 10e6 / mean},  /* 10 ms frame / mean cost */
+            {"pass2DutyCycle", w.metrics().pass2DutyCycle.load()}});
+  }
+}
+
+/* ── AudioEngine on the simulated host ── */
+
+struct EngineCase {
+  const char* name;
+  double speed;
+  unsigned long framesPerBuffer;
+  OutputRelease release;
+  bool pipelined = false;
+};
+
+void benchEngine() {
+  const double runSeconds = g_quick ? 0.5 : 2.0;
+  const EngineCase cases[] = {
+      {"sim_1x", 1.0, 480, OutputRelease::kCushioned},
+      {"sim_4x", 4.0, 480, OutputRelease::kCushioned},
+      {"host64/cushioned", 1.0, 64, OutputRelease::kCushioned},
+      {"host64/immediate", 1.0, 64, OutputRelease::kImmediate},
+      {"host128/cushioned", 1.0, 128, OutputRelease::kCushioned},
+      {"host128/immediate", 1.0, 128, OutputRelease::kImmediate},
+      {"host256/cushioned", 1.0, 256, OutputRelease::kCushioned},
+      {"host256/immediate", 1.0, 256, OutputRelease::kImmediate},
+      {"sim_1x/pipelined", 1.0, 480, OutputRelease::kCushioned, true},
+      {"sim_4x/pipelined", 4.0, 480, OutputRelease::kCushioned, true},
+  };
+  for (const EngineCase& c : cases) {
+    sim::setSpeed(c.speed);
+    AudioEngine engine;
+    sim::resetStats();
+
+    std::clock_t cpu0 = std::clock();
+    AudioConfig config;
+    config.framesPerBuffer = c.framesPerBuffer;
+    config.outputRelease = c.release;
+    config.pipelined = c.pipelined;
+    std::string err = engine.start(config);
+    if (!err.empty()) {
+      std::fprintf(stderr, "engine start failed: %s\n", err.c_str());
+      continue;
+    }
+    /* Sample the latency budget every 10 ms of (simulated) time. */
+    const auto end = std::chrono::steady_clock::now() + std::chrono::duration<double>(runSeconds);
+    double latencySum = 0.0, queueSum = 0.0;
+    size_t latencySamples = 0;
+    while (std::chrono::steady_clock::now() < end) {
+      std::this_thread::sleep_for(std::chrono::duration<double>(0.01 / c.speed));
+      LatencyBudget b = engine.latencyBudget();
+      if (b.outputBlock == 0) continue;
+      latencySum += b.totalMs;
+      queueSum += b.outputQueueMs;
+      latencySamples++;
+    }
+    LatencyBudget budget = engine.latencyBudget();
+    uint64_t frames = engine.metrics().framesProcessed.load();
+    StartupTiming t = engine.startupTiming();
+    DeadlineStats d = engine.deadlineStats();
+    PipelineStats p = engine.pipelineStats();
+    sim::Stats s = sim::stats();
+    engine.stop();
+    double cpuSeconds = static_cast<double>(std::clock() - cpu0) / CLOCKS_PER_SEC;
+
+    double delivered = static_cast<double>(s.captureSamples) / kRNNoiseFrameSize;
+    const double n = latencySamples ? static_cast<double>(latencySamples) : 1.0;
+    record("engine", c.name,
+           {{"startMs", t.startUs / 1000.0},
+            {"firstFrameMs", t.firstFrameUs / 1000.0},
+            {"framesProcessed", static_cast<double>(frames)},
+            {"framesDelivered", delivered},
+            {"keptUp", delivered > 0 ? static_cast<double>(frames) / delivered : 0.0},
+            {"silentOutputBlocks", static_cast<double>(s.silentOutputCallbacks)},
+            {"deadlineMisses", static_cast<double>(d.misses)},
+            {"worstLatencyMs", d.worstLatencyUs / 1000.0},
+            {"anomalies", static_cast<double>(d.anomalies)},
+            {"underrunMs", static_cast<double>(d.underrunSamples) / 48.0},
+            {"meanLatencyMs", latencySum / n},
+            {"meanOutputQueueMs", queueSum / n},
+            {"frameAssemblyMs", budget.frameAssemblyMs},
+            {"outputCushion", static_cast<double>(budget.outputCushion)},
+            {"cpuUsPerFrame", frames ? 1e6 * cpuSeconds / static_cast<double>(frames) : 0.0},
+            {"maxDepthPass1", static_cast<double>(p.maxDepth[0])},
+            {"maxDepthPass2", static_cast<double>(p.maxDepth[1])},
+            {"maxDepthPost", static_cast<double>(p.maxDepth[2])}});
+  }
+}
+
+}  // namespace
+
+int main(int argc, char** argv) {
+  for (int i = 1; i < argc; i++) {
+    if (std::strcmp(argv[i], "--quick") == 0) g_quick = true;
+  }
+
+  std::fprintf(stderr, "pipeline_bench%s\n", g_quick ? " (quick)" : "");
+  benchRing();
+  benchProcessFrame();
+  benchEngine();
+  printJson();
+  return 0;
+}
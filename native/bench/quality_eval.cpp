@@ -0,0 +1,379 @@
+/**
+ * Quality versus cost of RNNoiseWrapper configurations.
+ *
+ * Mixes a clean speech recording with a noise recording at several input
+ * SNRs, runs every configuration over each mixture, and scores the output
+ * against the clean signal:
+ *
+ *   SNRi      SNR improvement (output SNR - input SNR), dB
+ *   segSNR    Segmental SNR of the output, dB (speech frames only)
+ *   VAD acc   RNNoise VAD (>= the wrapper's threshold) against labels,
+ *             with miss and false-alarm rates
+ *   us/frame  Processing cost per 10 ms frame, and % of one core
+ *
+ * Scores are averaged over the mixtures. Rows marked '*' are on the
+ * Pareto front of SNRi against cost: no other configuration is both
+ * cheaper and better. The first 2 s of each run (gate calibration) are
+ * not scored.
+ *
+ * Configurations vary one knob at a time around the defaults (suppression
+ * level, pass mode, gate hold, floor multiplier, comfort noise); --grid
+ * runs the full cross product of level x pass x hold x floor instead.
+ *
+ * Without files the corpus is synthetic (harmonic tone bursts over
+ * low-passed noise), labelled from the clean signal. Inputs must be
+ * 48 kHz WAV; labels are Audacity label tracks of speech segments.
+ *
+ * Build with -DNOISEGUARD_BUILD_BENCHMARKS=ON, then run:
+ *   quality_eval [clean.wav noise.wav] [--labels speech.txt]
+ *                [--snr 0,5,10,20] [--grid]
+ */
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <string>
+#include <vector>
+
+#include "quality_metrics.h"
+#include "rnnoise_wrapper.h"
+
+using namespace ainoiceguard;
+
+namespace {
+
+constexpr double kSampleRate = 48000.0;
+
+/* Frames skipped before scoring: the gate's 2 s calibration period. */
+constexpr size_t kSkipFrames = 200;
+
+/* Largest pipeline delay searched when aligning output to the clean signal. */
+constexpr size_t kMaxDelay = 2 * kRNNoiseFrameSize;
+
+/* Samples used for the alignment search (5 s). */
+constexpr size_t kDelayWindow = 240000;
+
+struct Config {
+  std::string name;
+  float level = 1.0f;
+  SecondPassMode pass = SecondPassMode::kAlways;
+  int holdFrames = 15;
+  float floorMultiplier = 1.3f;
+  bool comfortNoise = true;
+};
+
+struct Score {
+  double snrImprovement = 0.0;
+  double segSnr = 0.0;
+  VadScore vad;
+  double nsPerFrame = 0.0;
+};
+
+const char* passName(SecondPassMode m) {
+  switch (m) {
+    case SecondPassMode::kNever: return "never";
+    case SecondPassMode::kAdaptive: return "adaptive";
+    default: return "always";
+  }
+}
+
+std::string describe(const Config& c) {
+  char buf[96];
+  std::snprintf(buf, sizeof(buf), "lvl=%.1f pass=%s hold=%d floor=%.1f cn=%s", c.level,
+                passName(c.pass), c.holdFrames, c.floorMultiplier,
+                c.comfortNoise ? "on" : "off");
+  return buf;
+}
+
+std::vector<Config> oneAtATime() {
+  std::vector<Config> configs;
+  Config base;
+  base.name = "default";
+  configs.push_back(base);
+  for (float level : {0.5f, 0.8f}) {
+    Config c = base;
+    c.name = "level";
+    c.level = level;
+    configs.push_back(c);
+  }
+  for (SecondPassMode m : {SecondPassMode::kNever, SecondPassMode::kAdaptive}) {
+    Config c = base;
+    c.name = "pass";
+    c.pass = m;
+    configs.push_back(c);
+  }
+  for (int hold : {5, 30}) {
+    Config c = base;
+    c.name = "hold";
+    c.holdFrames = hold;
+    configs.push_back(c);
+  }
+  for (float floor : {1.1f, 1.8f}) {
+    Config c = base;
+    c.name = "floor";
+    c.floorMultiplier = floor;
+    configs.push_back(c);
+  }
+  Config quiet = base;
+  quiet.name = "comfort";
+  quiet.comfortNoise = false;
+  configs.push_back(quiet);
+  return configs;
+}
+
+std::vector<Config> fullGrid() {
+  std::vector<Config> configs;
+  for (float level : {0.5f, 0.8f, 1.0f}) {
+    for (SecondPassMode m :
+         {SecondPassMode::kNever, SecondPassMode::kAdaptive, SecondPassMode::kAlways}) {
+      for (int hold : {5, 15, 30}) {
+        for (float floor : {1.1f, 1.3f, 1.8f}) {
+          Config c;
+          c.name = "grid";
+          c.level = level;
+          c.pass = m;
+          c.holdFrames = hold;
+          c.floorMultiplier = floor;
+          configs.push_back(c);
+        }
+      }
+    }
+  }
+  return configs;
+}
+
+/* 20 s of voiced bursts (200-700 ms) with pauses, plus matching noise. */
+void makeSyntheticCorpus(std::vector<float>* clean, std::vector<float>* noise) {
+  const size_t n = static_cast<size_t>(20.0 * kSampleRate);
+  clean->assign(n, 0.0f);
+  noise->assign(n, 0.0f);
+  uint32_t seed = 1;
+  auto rnd = [&seed] {
+    seed = seed * 1664525u + 1013904223u;
+    return static_cast<float>(static_cast<int32_t>(seed)) / 2147483648.0f;
+  };
+
+  size_t pos = static_cast<size_t>(0.3 * kSampleRate);
+  while (pos < n) {
+    size_t len = static_cast<size_t>((0.45 + 0.25 * rnd()) * kSampleRate);
+    float f0 = 140.0f + 40.0f * rnd();
+    for (size_t i = 0; i < len && pos + i < n; i++) {
+      float t = static_cast<float>(i) / static_cast<float>(kSampleRate);
+      float env = std::sin(3.1415927f * static_cast<float>(i) / static_cast<float>(len));
+      float v = 0.0f;
+      for (int h = 1; h <= 6; h++) {
+        v += std::sin(6.2831853f * f0 * static_cast<float>(h) * t) / static_cast<float>(h);
+      }
+      (*clean)[pos + i] = 0.08f * env * v;
+    }
+    pos += len + static_cast<size_t>((0.35 + 0.3 * rnd()) * kSampleRate);
+  }
+
+  /* One-pole low-passed white noise: more energy low, like fans and HVAC. */
+  float lp = 0.0f;
+  for (size_t i = 0; i < n; i++) {
+    lp += 0.2f * (rnd() - lp);
+    (*noise)[i] = lp;
+  }
+}
+
+/* clean + noise scaled to `snrDbTarget` (noise looped if shorter). */
+std::vector<float> mix(const std::vector<float>& clean, const std::vector<float>& noise,
+                       double snrDbTarget) {
+  double cleanPower = 0.0, noisePower = 0.0;
+  for (size_t i = 0; i < clean.size(); i++) {
+    double s = clean[i], v = noise[i % noise.size()];
+    cleanPower += s * s;
+    noisePower += v * v;
+  }
+  double gain = noisePower > 0.0
+                    ? std::sqrt(cleanPower / noisePower / std::pow(10.0, snrDbTarget / 10.0))
+                    : 0.0;
+  std::vector<float> out(clean.size());
+  for (size_t i = 0; i < clean.size(); i++) {
+    out[i] = clean[i] + static_cast<float>(gain) * noise[i % noise.size()];
+  }
+  return out;
+}
+
+Score evaluate(const Config& c, const std::vector<float>& clean,
+               const std::vector<float>& noisy, const std::vector<uint8_t>& labels) {
+  RNNoiseWrapper w;
+  w.setSuppressionLevel(c.level);
+  w.setSecondPassMode(c.pass);
+  w.setGateHoldFrames(c.holdFrames);
+  w.setGateFloorMultiplier(c.floorMultiplier);
+  w.setComfortNoise(c.comfortNoise);
+  Score s;
+  if (!w.init()) {
+    std::fprintf(stderr, "RNNoise init failed\n");
+    return s;
+  }
+
+  const size_t frames = noisy.size() / kRNNoiseFrameSize;
+  std::vector<float> out(frames * kRNNoiseFrameSize);
+  std::vector<float> vad(frames);
+  double ns = 0.0;
+  for (size_t f = 0; f < frames; f++) {
+    float* frame = out.data() + f * kRNNoiseFrameSize;
+    std::copy_n(noisy.data() + f * kRNNoiseFrameSize, kRNNoiseFrameSize, frame);
+    auto t0 = std::chrono::steady_clock::now();
+    vad[f] = w.processFrame(frame);
+    ns += std::chrono::duration<double, std::nano>(std::chrono::steady_clock::now() - t0)
+              .count();
+  }
+  s.nsPerFrame = ns / static_cast<double>(frames);
+
+  /* Score from the end of calibration, output shifted by the pipeline delay. */
+  const size_t skip = std::min(kSkipFrames * kRNNoiseFrameSize, out.size());
+  const size_t delay = estimateDelay(clean.data() + skip, out.data() + skip,
+                                     out.size() - skip, kMaxDelay, kDelayWindow);
+  const size_t n = out.size() - skip - delay;
+  const float* ref = clean.data() + skip;
+  s.snrImprovement = snrDb(ref, out.data() + skip + delay, n) -
+                     snrDb(ref, noisy.data() + skip, n);
+  s.segSnr = segmentalSnrDb(ref, out.data() + skip + delay, n, kRNNoiseFrameSize);
+
+  std::vector<float> scoredVad(vad.begin() + std::min(kSkipFrames, frames), vad.end());
+  std::vector<uint8_t> scoredLabels(labels.begin() + std::min(kSkipFrames, labels.size()),
+                                    labels.end());
+  s.vad = scoreVad(scoredVad, scoredLabels, w.getVadThreshold());
+  return s;
+}
+
+bool parseSnrs(const char* arg, std::vector<double>* snrs) {
+  snrs->clear();
+  const char* p = arg;
+  while (*p) {
+    char* end = nullptr;
+    double v = std::strtod(p, &end);
+    if (end == p) return false;
+    snrs->push_back(v);
+    p = *end == ',' ? end + 1 : end;
+  }
+  return !snrs->empty();
+}
+
+}  // namespace
+
+int main(int argc, char** argv) {
+  std::vector<std::string> files;
+  std::string labelPath;
+  std::vector<double> snrs = {0.0, 5.0, 10.0, 20.0};
+  bool grid = false;
+  for (int i = 1; i < argc; i++) {
+    if (std::strcmp(argv[i], "--grid") == 0) {
+      grid = true;
+    } else if (std::strcmp(argv[i], "--labels") == 0 && i + 1 < argc) {
+      labelPath = argv[++i];
+    } else if (std::strcmp(argv[i], "--snr") == 0 && i + 1 < argc) {
+      if (!parseSnrs(argv[++i], &snrs)) {
+        std::fprintf(stderr, "--snr expects a list like 0,5,10\n");
+        return 1;
+      }
+    } else {
+      files.push_back(argv[i]);
+    }
+  }
+  if (!files.empty() && files.size() != 2) {
+    std::fprintf(stderr, "usage: quality_eval [clean.wav noise.wav] [--labels speech.txt] "
+                         "[--snr 0,5,10,20] [--grid]\n");
+    return 1;
+  }
+
+  std::vector<float> clean, noise;
+  if (files.empty()) {
+    makeSyntheticCorpus(&clean, &noise);
+    std::printf("corpus: synthetic (20 s)\n");
+  } else {
+    WavData wav[2];
+    for (int k = 0; k < 2; k++) {
+      std::string err = readWav(files[k], &wav[k]);
+      if (err.empty() && wav[k].sampleRate != 48000) {
+        err = files[k] + ": sample rate " + std::to_string(wav[k].sampleRate) +
+              " Hz, expected 48000";
+      }
+      if (err.empty() && wav[k].samples.empty()) err = files[k] + ": no samples";
+      if (!err.empty()) {
+        std::fprintf(stderr, "%s\n", err.c_str());
+        return 1;
+      }
+    }
+    clean = std::move(wav[0].samples);
+    noise = std::move(wav[1].samples);
+    std::printf("corpus: %s + %s (%.1f s)\n", files[0].c_str(), files[1].c_str(),
+                static_cast<double>(clean.size()) / kSampleRate);
+  }
+
+  const size_t frames = clean.size() / kRNNoiseFrameSize;
+  if (frames <= kSkipFrames) {
+    std::fprintf(stderr, "corpus too short: need more than %zu frames\n", kSkipFrames);
+    return 1;
+  }
+  std::vector<uint8_t> labels;
+  if (!labelPath.empty()) {
+    std::string err = readLabels(labelPath, kSampleRate, kRNNoiseFrameSize, frames, &labels);
+    if (!err.empty()) {
+      std::fprintf(stderr, "%s\n", err.c_str());
+      return 1;
+    }
+  } else {
+    labels = energyLabels(clean.data(), clean.size(), kRNNoiseFrameSize);
+  }
+
+  std::vector<std::vector<float>> mixtures;
+  std::printf("input SNR:");
+  for (double snr : snrs) {
+    mixtures.push_back(mix(clean, noise, snr));
+    std::printf(" %g", snr);
+  }
+  std::printf(" dB; labels: %s\n\n", labelPath.empty() ? "from clean energy" : labelPath.c_str());
+
+  std::vector<Config> configs = grid ? fullGrid() : oneAtATime();
+  std::vector<Score> scores;
+  for (const Config& c : configs) {
+    Score mean;
+    for (const std::vector<float>& noisy : mixtures) {
+      Score s = evaluate(c, clean, noisy, labels);
+      mean.snrImprovement += s.snrImprovement;
+      mean.segSnr += s.segSnr;
+      mean.vad.accuracy += s.vad.accuracy;
+      mean.vad.missRate += s.vad.missRate;
+      mean.vad.falseAlarmRate += s.vad.falseAlarmRate;
+      mean.nsPerFrame += s.nsPerFrame;
+    }
+    const double k = 1.0 / static_cast<double>(mixtures.size());
+    mean.snrImprovement *= k;
+    mean.segSnr *= k;
+    mean.vad.accuracy *= k;
+    mean.vad.missRate *= k;
+    mean.vad.falseAlarmRate *= k;
+    mean.nsPerFrame *= k;
+    scores.push_back(mean);
+  }
+
+  std::printf("%-8s %-46s %7s %7s %7s %6s %6s %9s %7s\n", "", "config", "SNRi", "segSNR",
+              "VADacc", "miss", "FA", "us/frame", "% core");
+  for (size_t i = 0; i < configs.size(); i++) {
+    const Score& s = scores[i];
+    bool dominated = false;
+    for (const Score& o : scores) {
+      if (o.nsPerFrame <= s.nsPerFrame && o.snrImprovement >= s.snrImprovement &&
+          (o.nsPerFrame < s.nsPerFrame || o.snrImprovement > s.snrImprovement)) {
+        dominated = true;
+        break;
+      }
+    }
+    /* One stream produces 100 frames/s: % core = ns/frame * 1e-5. */
+    std::printf("%-8s %-46s %7.2f %7.2f %6.1f%% %5.1f%% %5.1f%% %9.1f %6.2f%%%s\n",
+                configs[i].name.c_str(), describe(configs[i]).c_str(), s.snrImprovement,
+                s.segSnr, 100.0 * s.vad.accuracy, 100.0 * s.vad.missRate,
+                100.0 * s.vad.falseAlarmRate, s.nsPerFrame * 1e-3, s.nsPerFrame * 1e-5,
+                dominated ? "" : " *");
+  }
+  return 0;
+}
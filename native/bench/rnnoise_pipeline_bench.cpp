@@ -0,0 +1,118 @@
+/**
+ * Per-stream throughput: processFrame() vs RNNoisePipeline.
+ *
+ * Runs the same input through two identically configured wrappers, one
+ * frame at a time on one thread and through the three-stage pipeline,
+ * and reports frames per second for each, the speed-up, and the peak
+ * queue depth in front of each stage. Outputs must match bit for bit
+ * (a model hot-swap mid-run exercises the pass 1 → pass 2 hand-off);
+ * the bench exits non-zero if they do not.
+ *
+ * Build with -DNOISEGUARD_BUILD_BENCHMARKS=ON, then run rnnoise_pipeline_bench.
+ */
+
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <vector>
+
+#include "rnnoise_pipeline.h"
+#include "rnnoise_wrapper.h"
+#include "synthetic_corpus.h"
+
+using namespace ainoiceguard;
+
+namespace {
+
+constexpr size_t kFrames = 1000;      /* 10 s of audio */
+constexpr size_t kSwapAtFrame = 400;  /* Model hot-swap published here */
+
+/* The shared speech-like corpus, with a muted stretch. */
+void fillSignal(std::vector<float>& buf) {
+  bench::SyntheticCorpus corpus;
+  corpus.seed = 0x1234567u;
+  corpus.muteBegin = 700 * kRNNoiseFrameSize;  /* Digital-silence fast path */
+  corpus.muteEnd = 760 * kRNNoiseFrameSize;
+  corpus.fill(buf.data(), buf.size());
+}
+
+struct Config {
+  const char* name;
+  SecondPassMode mode;
+  size_t bankSections;
+};
+
+void configure(RNNoiseWrapper& w, const Config& c) {
+  w.init();
+  w.setSecondPassMode(c.mode);
+  std::vector<FilterSpec> bank(c.bankSections);
+  for (size_t i = 0; i < bank.size(); i++) {
+    bank[i].type = FilterType::kPeaking;
+    bank[i].frequency = 200.0 * static_cast<double>(i + 1);
+    bank[i].gainDb = 2.0;
+  }
+  w.setFilterBank(bank);
+  w.reclaimRetired();
+}
+
+double seconds(std::chrono::steady_clock::time_point t0) {
+  return std::chrono::duration<double>(std::chrono::steady_clock::now() - t0).count();
+}
+
+bool run(const Config& c, const std::vector<float>& input) {
+  const size_t split = kSwapAtFrame * kRNNoiseFrameSize;
+
+  RNNoiseWrapper serial;
+  configure(serial, c);
+  std::vector<float> a = input;
+  auto t0 = std::chrono::steady_clock::now();
+  for (size_t f = 0; f < kFrames; f++) {
+    if (f == kSwapAtFrame) serial.prepareModelSwap(nullptr);
+    serial.processFrame(a.data() + f * kRNNoiseFrameSize);
+  }
+  const double serialS = seconds(t0);
+  serial.reclaimRetired();
+
+  RNNoiseWrapper piped;
+  configure(piped, c);
+  RNNoisePipeline pipeline;
+  pipeline.start(&piped);
+  std::vector<float> b = input;
+  t0 = std::chrono::steady_clock::now();
+  pipeline.process(b.data(), kSwapAtFrame);
+  piped.prepareModelSwap(nullptr);  /* Drained: taken on the same frame as above */
+  pipeline.process(b.data() + split, kFrames - kSwapAtFrame);
+  const double pipedS = seconds(t0);
+  const PipelineStats st = pipeline.stats();
+  pipeline.stop();
+  piped.reclaimRetired();
+
+  const bool same = std::memcmp(a.data(), b.data(), a.size() * sizeof(float)) == 0;
+  const double serialFps = kFrames / serialS;
+  const double pipedFps = kFrames / pipedS;
+  std::printf("%-22s %12.0f %12.0f %7.2fx   %u/%u/%u   %s\n", c.name, serialFps, pipedFps,
+              pipedFps / serialFps, st.maxDepth[0], st.maxDepth[1], st.maxDepth[2],
+              same ? "identical" : "MISMATCH");
+  return same;
+}
+
+}  // namespace
+
+int main() {
+  std::vector<float> input(kFrames * kRNNoiseFrameSize);
+  fillSignal(input);
+
+  const Config configs[] = {
+      {"default", SecondPassMode::kAlways, 0},
+      {"adaptive pass 2", SecondPassMode::kAdaptive, 0},
+      {"heavy (8-section EQ)", SecondPassMode::kAlways, 8},
+  };
+
+  std::printf("%-22s %12s %12s %8s   %s\n", "chain", "serial fps", "piped fps", "gain",
+              "max depth p1/p2/post");
+  bool ok = true;
+  for (const Config& c : configs) ok = run(c, input) && ok;
+  return ok ? EXIT_SUCCESS : EXIT_FAILURE;
+}
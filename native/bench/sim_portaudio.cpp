@@ -0,0 +1,175 @@
+/**
+ * Simulated PortAudio host. See sim_portaudio.h.
+ */
+
+#include "sim_portaudio.h"
+
+#include <atomic>
+#include <chrono>
+#include <thread>
+#include <vector>
+
+#include "portaudio.h"
+#include "synthetic_corpus.h"
+
+namespace ainoiceguard {
+namespace sim {
+namespace {
+
+constexpr double kSampleRate = 48000.0;
+
+std::atomic<double> g_speed{1.0};
+std::atomic<uint64_t> g_captureCallbacks{0};
+std::atomic<uint64_t> g_captureSamples{0};
+std::atomic<uint64_t> g_outputCallbacks{0};
+std::atomic<uint64_t> g_silentOutputCallbacks{0};
+int g_initCount = 0;
+
+const PaHostApiInfo kHostApi = {1, paInDevelopment, "Simulated", 2, 0, 1};
+const PaDeviceInfo kDevices[2] = {
+    {2, "Sim Input", 0, 1, 0, 0.01, 0.01, 0.1, 0.1, kSampleRate},
+    {2, "Sim Output", 0, 0, 1, 0.01, 0.01, 0.1, 0.1, kSampleRate},
+};
+
+struct Stream {
+  PaStreamCallback* callback = nullptr;
+  void* userData = nullptr;
+  bool capture = false;
+  unsigned long framesPerBuffer = 0;
+  PaStreamInfo info = {};
+  std::atomic<bool> running{false};
+  std::thread clock;
+};
+
+void runClock(Stream* s) {
+  std::vector<float> buf(s->framesPerBuffer);
+  bench::SyntheticCorpus capture;  /* -40 dBFS noise, 180 Hz bursts */
+  capture.seed = 12345;
+  auto next = std::chrono::steady_clock::now();
+
+  while (s->running.load(std::memory_order_acquire)) {
+    if (s->capture) {
+      capture.fill(buf.data(), s->framesPerBuffer);
+      s->callback(buf.data(), nullptr, s->framesPerBuffer, nullptr, 0, s->userData);
+      g_captureCallbacks.fetch_add(1, std::memory_order_relaxed);
+      g_captureSamples.fetch_add(s->framesPerBuffer, std::memory_order_relaxed);
+    } else {
+      s->callback(nullptr, buf.data(), s->framesPerBuffer, nullptr, 0, s->userData);
+      bool silent = true;
+      for (float v : buf) silent = silent && v == 0.0f;
+      g_outputCallbacks.fetch_add(1, std::memory_order_relaxed);
+      if (silent) g_silentOutputCallbacks.fetch_add(1, std::memory_order_relaxed);
+    }
+
+    double periodUs = static_cast<double>(s->framesPerBuffer) * 1e6 / kSampleRate /
+                      g_speed.load(std::memory_order_relaxed);
+    next += std::chrono::microseconds(static_cast<int64_t>(periodUs));
+    std::this_thread::sleep_until(next);
+  }
+}
+
+}  // namespace
+
+void setSpeed(double speed) { g_speed.store(speed > 0.0 ? speed : 1.0); }
+
+Stats stats() {
+  Stats s;
+  s.captureCallbacks = g_captureCallbacks.load();
+  s.captureSamples = g_captureSamples.load();
+  s.outputCallbacks = g_outputCallbacks.load();
+  s.silentOutputCallbacks = g_silentOutputCallbacks.load();
+  return s;
+}
+
+void resetStats() {
+  g_captureCallbacks.store(0);
+  g_captureSamples.store(0);
+  g_outputCallbacks.store(0);
+  g_silentOutputCallbacks.store(0);
+}
+
+}  // namespace sim
+}  // namespace ainoiceguard
+
+/* ── PortAudio API surface used by audio.cpp ── */
+
+using ainoiceguard::sim::Stream;
+
+extern "C" {
+
+PaError Pa_Initialize(void) {
+  ainoiceguard::sim::g_initCount++;
+  return paNoError;
+}
+
+PaError Pa_Terminate(void) {
+  if (ainoiceguard::sim::g_initCount == 0) return paNotInitialized;
+  ainoiceguard::sim::g_initCount--;
+  return paNoError;
+}
+
+const char* Pa_GetErrorText(PaError errorCode) {
+  return errorCode == paNoError ? "Success" : "Simulated host error";
+}
+
+PaDeviceIndex Pa_GetDeviceCount(void) { return 2; }
+PaDeviceIndex Pa_GetDefaultInputDevice(void) { return 0; }
+PaDeviceIndex Pa_GetDefaultOutputDevice(void) { return 1; }
+
+const PaDeviceInfo* Pa_GetDeviceInfo(PaDeviceIndex device) {
+  return (device == 0 || device == 1) ? &ainoiceguard::sim::kDevices[device] : nullptr;
+}
+
+PaHostApiIndex Pa_GetHostApiCount(void) { return 1; }
+
+const PaHostApiInfo* Pa_GetHostApiInfo(PaHostApiIndex hostApi) {
+  return hostApi == 0 ? &ainoiceguard::sim::kHostApi : nullptr;
+}
+
+PaError Pa_OpenStream(PaStream** stream, const PaStreamParameters* inputParameters,
+                      const PaStreamParameters* outputParameters, double /*sampleRate*/,
+                      unsigned long framesPerBuffer, PaStreamFlags /*streamFlags*/,
+                      PaStreamCallback* streamCallback, void* userData) {
+  if (!inputParameters == !outputParameters) return paInvalidDevice;
+  auto* s = new Stream;
+  s->callback = streamCallback;
+  s->userData = userData;
+  s->capture = inputParameters != nullptr;
+  s->framesPerBuffer = framesPerBuffer ? framesPerBuffer : 480;
+  /* Reported latency: one host buffer each way. */
+  double bufferSeconds = static_cast<double>(s->framesPerBuffer) / ainoiceguard::sim::kSampleRate;
+  s->info = {1, s->capture ? bufferSeconds : 0.0, s->capture ? 0.0 : bufferSeconds,
+             ainoiceguard::sim::kSampleRate};
+  *stream = s;
+  return paNoError;
+}
+
+PaError Pa_StartStream(PaStream* stream) {
+  auto* s = static_cast<Stream*>(stream);
+  if (s->running.exchange(true)) return paStreamIsNotStopped;
+  s->clock = std::thread(ainoiceguard::sim::runClock, s);
+  return paNoError;
+}
+
+PaError Pa_StopStream(PaStream* stream) {
+  auto* s = static_cast<Stream*>(stream);
+  s->running.store(false, std::memory_order_release);
+  if (s->clock.joinable()) s->clock.join();
+  return paNoError;
+}
+
+PaError Pa_IsStreamActive(PaStream* stream) {
+  return static_cast<Stream*>(stream)->running.load(std::memory_order_acquire) ? 1 : 0;
+}
+
+const PaStreamInfo* Pa_GetStreamInfo(PaStream* stream) {
+  return &static_cast<Stream*>(stream)->info;
+}
+
+PaError Pa_CloseStream(PaStream* stream) {
+  Pa_StopStream(stream);
+  delete static_cast<Stream*>(stream);
+  return paNoError;
+}
+
+}  // extern "C"
@@ -0,0 +1,40 @@
+/**
+ * Simulated PortAudio host for benchmarks.
+ *
+ * sim_portaudio.cpp implements the Pa_* calls audio.cpp makes, against one
+ * in-process device pair ("Sim Input" / "Sim Output", 48 kHz mono). Each
+ * started stream gets a clock thread that invokes its callback every
+ * framesPerBuffer samples of simulated time, so the real AudioEngine --
+ * rings, processing thread, RNNoise, event thread -- runs unchanged
+ * without audio hardware. Link it INSTEAD of the PortAudio library.
+ *
+ * The capture side delivers speech-like tone bursts over noise. The clock
+ * can run faster than real time (setSpeed) to stress the processing thread.
+ */
+
+#ifndef AINOICEGUARD_SIM_PORTAUDIO_H
+#define AINOICEGUARD_SIM_PORTAUDIO_H
+
+#include <cstdint>
+
+namespace ainoiceguard {
+namespace sim {
+
+struct Stats {
+  uint64_t captureCallbacks = 0;
+  uint64_t captureSamples = 0;
+  uint64_t outputCallbacks = 0;
+  uint64_t silentOutputCallbacks = 0;  /* Whole block zero: engine underrun */
+};
+
+/** Simulated-time rate: 1 = real time, 4 = four times faster. */
+void setSpeed(double speed);
+
+/** Counters since the last resetStats(). */
+Stats stats();
+void resetStats();
+
+}  // namespace sim
+}  // namespace ainoiceguard
+
+#endif  // AINOICEGUARD_SIM_PORTAUDIO_H
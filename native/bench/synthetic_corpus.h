@@ -0,0 +1,54 @@
+/**
+ * Speech-like synthetic input shared by the benchmarks: 180 Hz tone
+ * bursts, 500 ms on / 500 ms off, over LCG white noise (-40 dBFS by
+ * default), at 48 kHz.
+ *
+ * The generator is a sample position plus an LCG seed, so any block size
+ * (a 480-sample frame, a host period of the simulated device) continues
+ * the same signal. An optional mute range emits exact zeros, as a hardware
+ * mute would (the wrapper's digital-silence fast path).
+ */
+
+#ifndef AINOICEGUARD_SYNTHETIC_CORPUS_H
+#define AINOICEGUARD_SYNTHETIC_CORPUS_H
+
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+
+namespace ainoiceguard {
+namespace bench {
+
+struct SyntheticCorpus {
+  float noiseLevel = 0.01f;    /* White-noise amplitude (0.01 = -40 dBFS) */
+  float toneLevel = 0.1f;      /* 180 Hz amplitude while voiced */
+  float overtoneLevel = 0.0f;  /* 540 Hz amplitude while voiced */
+
+  uint64_t muteBegin = 0;      /* Samples [muteBegin, muteEnd) are zeros */
+  uint64_t muteEnd = 0;
+
+  uint64_t pos = 0;            /* Next sample; voicing and phase follow it */
+  uint32_t seed = 1;
+
+  /* Writes the next n samples. */
+  void fill(float* buf, size_t n) {
+    for (size_t i = 0; i < n; i++, pos++) {
+      seed = seed * 1664525u + 1013904223u;
+      float noise = static_cast<float>(static_cast<int32_t>(seed)) / 2147483648.0f;
+      bool voiced = (pos / 24000) % 2 == 0;
+      float t = static_cast<float>(pos) / 48000.0f;
+      float tone = 0.0f;
+      if (voiced) {
+        tone = toneLevel * std::sin(6.2831853f * 180.0f * t);
+        if (overtoneLevel != 0.0f) tone += overtoneLevel * std::sin(6.2831853f * 540.0f * t);
+      }
+      const bool muted = pos >= muteBegin && pos < muteEnd;
+      buf[i] = muted ? 0.0f : tone + noiseLevel * noise;
+    }
+  }
+};
+
+}  // namespace bench
+}  // namespace ainoiceguard
+
+#endif  // AINOICEGUARD_SYNTHETIC_CORPUS_H
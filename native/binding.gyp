@@ -4,7 +4,23 @@
       "target_name": "ainoiceguard",
       "cflags!": ["-fno-exceptions"],
       "cflags_cc!": ["-fno-exceptions"],
-      "sources": ["src/addon.cc", "src/audio.cpp", "src/rnnoise_wrapper.cpp"],
+      "sources": [
+        "src/addon.cc",
+        "src/audio.cpp",
+        "src/backlog_bound.cpp",
+        "src/concealment.cpp",
+        "src/cpu_governor.cpp",
+        "src/rnnoise_kernels.cpp",
+        "src/rnnoise_wrapper.cpp",
+        "src/rnnoise_model.cpp",
+        "src/rnnoise_pipeline.cpp",
+        "src/cpu_features.cpp",
+        "src/dispatch_info.cpp",
+        "src/dsp_kernels.cpp",
+        "src/filter_bank.cpp",
+        "src/post_filter.cpp",
+        "src/stage_chain.cpp"
+      ],
       "include_dirs": [
         "<!@(node -p \"require('node-addon-api').include\")",
         "src",
@@ -0,0 +1,71 @@
+# ──────────────────────────────────────────────────────────────────────────────
+# NoiseGuard - symbol-prefix header for an extra RNNoise copy
+#
+# Lists the global symbols the generic RNNoise objects define and writes a
+# header that #defines each one to PREFIX<name>. Force-included into every
+# RNNoise source of another copy (AVX2, AVX-512), it renames that copy's
+# definitions and internal references alike, so the copies link side by
+# side in one librnnoise without patching RNNoise.
+#
+# Run at build time by native/CMakeLists.txt:
+#   cmake -DSYMBOL_TOOL=<nm | dumpbin> -DOBJECTS=<a.o|b.o|...>
+#         -DPREFIX=noiseguard_avx2_ -DOUTPUT=<header>
+#         [-DSTRIP_UNDERSCORE=ON] -P rnnoise_prefix.cmake
+# STRIP_UNDERSCORE drops the leading underscore Mach-O adds to C names.
+# ──────────────────────────────────────────────────────────────────────────────
+
+foreach(_var SYMBOL_TOOL OBJECTS PREFIX OUTPUT)
+  if(NOT ${_var})
+    message(FATAL_ERROR "rnnoise_prefix.cmake: ${_var} is not set")
+  endif()
+endforeach()
+
+string(REPLACE "|" ";" _objects "${OBJECTS}")
+set(_table "${OUTPUT}.symbols")
+
+get_filename_component(_tool_name "${SYMBOL_TOOL}" NAME_WE)
+string(TOLOWER "${_tool_name}" _tool_name)
+if(_tool_name STREQUAL "dumpbin")
+  # "008 00000000 SECT3  notype ()    External     | rnnoise_create"
+  execute_process(COMMAND "${SYMBOL_TOOL}" /nologo /symbols ${_objects}
+    OUTPUT_FILE "${_table}" RESULT_VARIABLE _result)
+  set(_line_regex "SECT[0-9A-F]+ [^|]* External +\\| +[A-Za-z_][A-Za-z0-9_]*")
+  set(_name_regex ".*\\| +([A-Za-z_][A-Za-z0-9_]*).*")
+else()
+  # "0000000000000000 T rnnoise_create"
+  execute_process(COMMAND "${SYMBOL_TOOL}" -g --defined-only ${_objects}
+    OUTPUT_FILE "${_table}" RESULT_VARIABLE _result)
+  set(_line_regex "^[0-9a-fA-F]* *[A-Z] [A-Za-z_][A-Za-z0-9_]*")
+  set(_name_regex "^[0-9a-fA-F]* *[A-Z] ([A-Za-z_][A-Za-z0-9_]*).*")
+endif()
+if(NOT _result EQUAL 0)
+  message(FATAL_ERROR "rnnoise_prefix.cmake: ${SYMBOL_TOOL} failed (${_result})")
+endif()
+
+file(STRINGS "${_table}" _lines REGEX "${_line_regex}")
+set(_symbols "")
+foreach(_line IN LISTS _lines)
+  string(REGEX REPLACE "${_name_regex}" "\\1" _name "${_line}")
+  if(STRIP_UNDERSCORE)
+    string(REGEX REPLACE "^_" "" _name "${_name}")
+  endif()
+  # Reserved names (__x, _X) belong to the compiler and runtime.
+  if(NOT _name MATCHES "^_[_A-Z]")
+    list(APPEND _symbols "${_name}")
+  endif()
+endforeach()
+list(REMOVE_DUPLICATES _symbols)
+list(SORT _symbols)
+
+# The public API must be among them, or the table was not parsed.
+list(FIND _symbols rnnoise_create _create_index)
+if(_create_index EQUAL -1)
+  message(FATAL_ERROR "rnnoise_prefix.cmake: no rnnoise_create in the ${SYMBOL_TOOL} "
+                      "output (${_table}); cannot prefix the RNNoise copy")
+endif()
+
+set(_header "/* Generated by native/cmake/rnnoise_prefix.cmake -- do not edit. */\n")
+foreach(_name IN LISTS _symbols)
+  string(APPEND _header "#define ${_name} ${PREFIX}${_name}\n")
+endforeach()
+file(WRITE "${OUTPUT}" "${_header}")
@@ -3,32 +3,73 @@
  *
  * Exposes the C++ AudioEngine to JavaScript via Node-API (N-API).
  * All heavy audio work stays in C++. JavaScript only calls:
- *   - getDevices()                -> list audio devices
+ *   - getDevices(refresh?)        -> list audio devices
  *   - start(inputIdx, outputIdx)  -> start noise cancellation
  *   - stop()                      -> stop noise cancellation
  *   - setNoiseLevel(level)        -> adjust suppression [0.0, 1.0]
  *   - getNoiseLevel()             -> read current suppression level
  *   - setVadThreshold(threshold)  -> adjust VAD gate threshold [0.0, 1.0]
  *   - getVadThreshold()           -> read current VAD threshold
+ *   - setSecondPassMode(mode)     -> "always" | "never" | "adaptive"
+ *   - getSecondPassMode()         -> read current second-pass mode
+ *   - setStages(names)            -> choose / reorder post-processing stages
+ *   - getStages()                 -> read current stage order
+ *   - setFilters(specs)           -> EQ / hum-notch filter bank
+ *   - getFilters()                -> read current filter sections
+ *   - setCalibration(cal)         -> warm-start the gate on the next start()
+ *   - getCalibration()            -> gate state captured by the last stop()
+ *   - setModelTier(tier)          -> "standard" | "little"
+ *   - getModelTier()              -> read current model tier
+ *   - setModelPath(path, tier?)   -> Promise: load / hot-swap an RNNoise model file
+ *   - getModelPath(tier?)         -> read current model file path
  *   - isRunning()                 -> check engine state
- *   - getMetrics()                -> real-time audio metrics
+ *   - getMetrics()                -> real-time audio metrics + last start() timing
+ *   - getDiagnostics()            -> selected kernels, RNNoise ISA, CPU features
+ *   - getAnomalies()              -> deadline misses, xruns and the anomaly log
+ *   - getLatency()                -> mic-to-output latency breakdown
+ *   - getCallbackTiming(reset?)   -> capture / output callback jitter
  */
 
 #include <napi.h>
+
+#include <algorithm>
+#include <cmath>
+#include <string>
+#include <utility>
+#include <vector>
+
 #include "audio.h"
+#include "dispatch_info.h"
 
 namespace {
 
 /* Single global engine instance. One engine per process is sufficient. */
 static ainoiceguard::AudioEngine g_engine;
 
+/* Indexed by QualityTier (start options, metrics, anomaly records). */
+const char* const kQualityTierNames[] = {
+    "full", "single-pass", "lean-filters", "little-model",
+};
+
+/* Indexed by PipelineStage (metrics). */
+const char* const kPipelineStageNames[] = {"pass1", "pass2", "post"};
+
 /**
- * getDevices() -> { inputs: [...], outputs: [...] }
+ * getDevices(refresh?) -> { inputs: [...], outputs: [...] }
+ *
+ * With refresh === true and the engine stopped, PortAudio is re-initialized
+ * first so hot-plugged devices show up; otherwise the list is the one taken
+ * when the PortAudio session opened.
+ *
+ * Each device: { index, name, hostApi, maxChannels, defaultSampleRate,
+ * lowLatencyMs, highLatencyMs } (PortAudio's default low / high
+ * suggested latency for that direction).
  */
 Napi::Value GetDevices(const Napi::CallbackInfo& info) {
   Napi::Env env = info.Env();
 
-  auto devices = ainoiceguard::AudioEngine::enumerateDevices();
+  bool refresh = info.Length() > 0 && info[0].IsBoolean() && info[0].As<Napi::Boolean>().Value();
+  auto devices = g_engine.enumerateDevices(refresh);
 
   Napi::Array inputs = Napi::Array::New(env);
   Napi::Array outputs = Napi::Array::New(env);
@@ -39,16 +80,22 @@ Napi::Value GetDevices(const Napi::CallbackInfo& info) {
       Napi::Object obj = Napi::Object::New(env);
       obj.Set("index", Napi::Number::New(env, d.index));
       obj.Set("name", Napi::String::New(env, d.name));
+      obj.Set("hostApi", Napi::String::New(env, d.hostApi));
       obj.Set("maxChannels", Napi::Number::New(env, d.maxInputChannels));
       obj.Set("defaultSampleRate", Napi::Number::New(env, d.defaultSampleRate));
+      obj.Set("lowLatencyMs", Napi::Number::New(env, d.defaultLowInputLatency * 1000.0));
+      obj.Set("highLatencyMs", Napi::Number::New(env, d.defaultHighInputLatency * 1000.0));
       inputs.Set(inIdx++, obj);
     }
     if (d.maxOutputChannels > 0) {
       Napi::Object obj = Napi::Object::New(env);
       obj.Set("index", Napi::Number::New(env, d.index));
       obj.Set("name", Napi::String::New(env, d.name));
+      obj.Set("hostApi", Napi::String::New(env, d.hostApi));
       obj.Set("maxChannels", Napi::Number::New(env, d.maxOutputChannels));
       obj.Set("defaultSampleRate", Napi::Number::New(env, d.defaultSampleRate));
+      obj.Set("lowLatencyMs", Napi::Number::New(env, d.defaultLowOutputLatency * 1000.0));
+      obj.Set("highLatencyMs", Napi::Number::New(env, d.defaultHighOutputLatency * 1000.0));
       outputs.Set(outIdx++, obj);
     }
   }
@@ -60,7 +107,19 @@ Napi::Value GetDevices(const Napi::CallbackInfo& info) {
 }
 
 /**
- * start(inputDeviceIndex, outputDeviceIndex) -> string
+ * start(inputDeviceIndex, outputDeviceIndex, options?) -> string
+ *
+ * options (all optional): { framesPerBuffer (host buffer, 0 = host's
+ * choice; default 480), inputLatencyMs, outputLatencyMs (suggested
+ * latency, 0 = device default low), outputRelease: "cushioned" |
+ * "immediate" },
+ * { starvationTimeoutMs, xrunRestartCount,
+ * xrunWindowMs } -- device-loss restart thresholds; { overflowPolicy:
+ * "drop-newest" | "drop-oldest" | "catch-up", maxBacklogFrames } --
+ * capture backlog bound; { governorFloor: "full" (no load shedding) |
+ * "single-pass" | "lean-filters" | "little-model" (default) } -- how far
+ * the CPU governor may step down; { pipelined } -- run the RNNoise passes
+ * and the post-filters on separate cores. See AudioConfig.
  */
 Napi::Value Start(const Napi::CallbackInfo& info) {
   Napi::Env env = info.Env();
@@ -82,6 +141,65 @@ Napi::Value Start(const Napi::CallbackInfo& info) {
   config.framesPerBuffer = ainoiceguard::kRNNoiseFrameSize;
   config.tryExclusiveMode = true;
 
+  if (info.Length() >= 3 && info[2].IsObject()) {
+    Napi::Object opts = info[2].As<Napi::Object>();
+    if (opts.Has("framesPerBuffer") && opts.Get("framesPerBuffer").IsNumber()) {
+      int frames = opts.Get("framesPerBuffer").As<Napi::Number>().Int32Value();
+      config.framesPerBuffer = static_cast<unsigned long>(std::clamp(frames, 0, 8192));
+    }
+    auto readMs = [&opts](const char* key, double& field) {
+      if (opts.Has(key) && opts.Get(key).IsNumber()) {
+        double ms = opts.Get(key).As<Napi::Number>().DoubleValue();
+        field = std::isfinite(ms) ? std::clamp(ms, 0.0, 1000.0) : 0.0;
+      }
+    };
+    readMs("inputLatencyMs", config.inputLatencyMs);
+    readMs("outputLatencyMs", config.outputLatencyMs);
+    if (opts.Has("outputRelease") && opts.Get("outputRelease").IsString()) {
+      std::string release = opts.Get("outputRelease").As<Napi::String>().Utf8Value();
+      if (release == "cushioned") {
+        config.outputRelease = ainoiceguard::OutputRelease::kCushioned;
+      } else if (release == "immediate") {
+        config.outputRelease = ainoiceguard::OutputRelease::kImmediate;
+      } else {
+        return Napi::String::New(env, "Unknown outputRelease: " + release);
+      }
+    }
+    auto readCount = [&opts](const char* key, uint32_t& field) {
+      if (opts.Has(key) && opts.Get(key).IsNumber()) {
+        field = static_cast<uint32_t>(std::max(0, opts.Get(key).As<Napi::Number>().Int32Value()));
+      }
+    };
+    readCount("starvationTimeoutMs", config.starvationTimeoutMs);
+    readCount("xrunRestartCount", config.xrunRestartCount);
+    readCount("xrunWindowMs", config.xrunWindowMs);
+    readCount("maxBacklogFrames", config.maxBacklogFrames);
+    if (opts.Has("overflowPolicy") && opts.Get("overflowPolicy").IsString()) {
+      std::string policy = opts.Get("overflowPolicy").As<Napi::String>().Utf8Value();
+      if (policy == "drop-newest") {
+        config.overflowPolicy = ainoiceguard::OverflowPolicy::kDropNewest;
+      } else if (policy == "drop-oldest") {
+        config.overflowPolicy = ainoiceguard::OverflowPolicy::kDropOldest;
+      } else if (policy == "catch-up") {
+        config.overflowPolicy = ainoiceguard::OverflowPolicy::kCatchUp;
+      } else {
+        return Napi::String::New(env, "Unknown overflowPolicy: " + policy);
+      }
+    }
+    if (opts.Has("governorFloor") && opts.Get("governorFloor").IsString()) {
+      std::string floor = opts.Get("governorFloor").As<Napi::String>().Utf8Value();
+      const auto* names = std::begin(kQualityTierNames);
+      const auto* found = std::find(names, std::end(kQualityTierNames), floor);
+      if (found == std::end(kQualityTierNames)) {
+        return Napi::String::New(env, "Unknown governorFloor: " + floor);
+      }
+      config.governorFloor = static_cast<ainoiceguard::QualityTier>(found - names);
+    }
+    if (opts.Has("pipelined") && opts.Get("pipelined").IsBoolean()) {
+      config.pipelined = opts.Get("pipelined").As<Napi::Boolean>().Value();
+    }
+  }
+
   std::string err = g_engine.start(config);
   return Napi::String::New(env, err);
 }
@@ -123,6 +241,314 @@ Napi::Value GetVadThreshold(const Napi::CallbackInfo& info) {
   return Napi::Number::New(info.Env(), g_engine.getVadThreshold());
 }
 
+/**
+ * setSecondPassMode(mode) -> void
+ * mode: "always" (double pass), "never" (single pass), "adaptive".
+ */
+void SetSecondPassMode(const Napi::CallbackInfo& info) {
+  if (info.Length() < 1 || !info[0].IsString()) return;
+  std::string mode = info[0].As<Napi::String>().Utf8Value();
+  if (mode == "always") {
+    g_engine.setSecondPassMode(ainoiceguard::SecondPassMode::kAlways);
+  } else if (mode == "never") {
+    g_engine.setSecondPassMode(ainoiceguard::SecondPassMode::kNever);
+  } else if (mode == "adaptive") {
+    g_engine.setSecondPassMode(ainoiceguard::SecondPassMode::kAdaptive);
+  }
+}
+
+/**
+ * getSecondPassMode() -> string
+ */
+Napi::Value GetSecondPassMode(const Napi::CallbackInfo& info) {
+  switch (g_engine.getSecondPassMode()) {
+    case ainoiceguard::SecondPassMode::kNever:
+      return Napi::String::New(info.Env(), "never");
+    case ainoiceguard::SecondPassMode::kAdaptive:
+      return Napi::String::New(info.Env(), "adaptive");
+    default:
+      return Napi::String::New(info.Env(), "always");
+  }
+}
+
+/**
+ * setStages(names) -> boolean
+ * names: ordered array of "highPass", "lowPass", "filterBank", "gate",
+ * "spectralClamp", "comfortNoise". Stages left out are dropped. Returns false (and changes
+ * nothing) on an unknown or repeated name.
+ */
+Napi::Value SetStages(const Napi::CallbackInfo& info) {
+  Napi::Env env = info.Env();
+  if (info.Length() < 1 || !info[0].IsArray()) return Napi::Boolean::New(env, false);
+
+  Napi::Array names = info[0].As<Napi::Array>();
+  ainoiceguard::StagePlan plan;
+  for (uint32_t i = 0; i < names.Length(); i++) {
+    Napi::Value v = names.Get(i);
+    ainoiceguard::StageId id;
+    if (!v.IsString() ||
+        !ainoiceguard::stageFromName(v.As<Napi::String>().Utf8Value(), &id) ||
+        !plan.append(id)) {
+      return Napi::Boolean::New(env, false);
+    }
+  }
+  g_engine.setStagePlan(plan);
+  return Napi::Boolean::New(env, true);
+}
+
+/**
+ * getStages() -> string[]
+ */
+Napi::Value GetStages(const Napi::CallbackInfo& info) {
+  Napi::Env env = info.Env();
+  ainoiceguard::StagePlan plan = g_engine.getStagePlan();
+  Napi::Array result = Napi::Array::New(env, plan.size());
+  for (size_t i = 0; i < plan.size(); i++) {
+    result.Set(static_cast<uint32_t>(i),
+               Napi::String::New(env, ainoiceguard::stageName(plan.at(i))));
+  }
+  return result;
+}
+
+/* Indexed by FilterType. */
+const char* const kFilterTypeNames[] = {
+    "lowPass", "highPass", "notch", "peaking", "lowShelf", "highShelf",
+};
+
+/**
+ * setFilters(specs) -> string
+ * specs: array of { type, frequency, q?, gainDb? } with type one of
+ * "lowPass", "highPass", "notch", "peaking", "lowShelf", "highShelf", or
+ * { type: "humNotch", frequency: 50 | 60, harmonics?, q? } for the mains
+ * fundamental plus `harmonics` multiples. Runs where "filterBank" sits in
+ * the stage list. Returns "" on success, or an error message (the
+ * previous bank stays).
+ */
+Napi::Value SetFilters(const Napi::CallbackInfo& info) {
+  Napi::Env env = info.Env();
+  if (info.Length() < 1 || !info[0].IsArray()) {
+    return Napi::String::New(env, "Expected an array of filters");
+  }
+
+  auto number = [](const Napi::Object& o, const char* key, double fallback) {
+    Napi::Value v = o.Get(key);
+    return v.IsNumber() ? v.As<Napi::Number>().DoubleValue() : fallback;
+  };
+
+  Napi::Array list = info[0].As<Napi::Array>();
+  std::vector<ainoiceguard::FilterSpec> specs;
+  for (uint32_t i = 0; i < list.Length(); i++) {
+    Napi::Value v = list.Get(i);
+    if (!v.IsObject()) return Napi::String::New(env, "Filter entries must be objects");
+    Napi::Object o = v.As<Napi::Object>();
+    Napi::Value typeValue = o.Get("type");
+    std::string type = typeValue.IsString() ? typeValue.As<Napi::String>().Utf8Value() : "";
+
+    ainoiceguard::FilterSpec spec;
+    spec.frequency = number(o, "frequency", 0.0);
+    spec.q = number(o, "q", spec.q);
+    spec.gainDb = number(o, "gainDb", 0.0);
+
+    if (type == "humNotch") {
+      double harmonics = number(o, "harmonics", 0.0);
+      if (!(spec.frequency > 0.0) || !std::isfinite(spec.frequency)) {
+        return Napi::String::New(env, "humNotch needs a positive frequency");
+      }
+      /* One notch for the fundamental plus one per harmonic, all in the bank. */
+      constexpr size_t kMaxHarmonics = ainoiceguard::FilterBank::kMaxSections - 1;
+      if (!(harmonics >= 0.0 && harmonics <= static_cast<double>(kMaxHarmonics))) {
+        return Napi::String::New(
+            env, "humNotch harmonics must be between 0 and " + std::to_string(kMaxHarmonics));
+      }
+      for (const auto& n : ainoiceguard::humNotches(
+               spec.frequency, static_cast<size_t>(harmonics),
+               ainoiceguard::kRNNoiseSampleRate / 2.0,
+               number(o, "q", ainoiceguard::kHumNotchQ))) {
+        specs.push_back(n);
+      }
+      continue;
+    }
+
+    bool known = false;
+    for (size_t t = 0; t < sizeof(kFilterTypeNames) / sizeof(kFilterTypeNames[0]); t++) {
+      if (type == kFilterTypeNames[t]) {
+        spec.type = static_cast<ainoiceguard::FilterType>(t);
+        known = true;
+      }
+    }
+    if (!known) return Napi::String::New(env, "Unknown filter type: " + type);
+    specs.push_back(spec);
+  }
+  return Napi::String::New(env, g_engine.setFilterBank(specs));
+}
+
+/**
+ * getFilters() -> { type, frequency, q, gainDb }[]
+ * Hum notches are listed as their individual "notch" sections.
+ */
+Napi::Value GetFilters(const Napi::CallbackInfo& info) {
+  Napi::Env env = info.Env();
+  std::vector<ainoiceguard::FilterSpec> specs = g_engine.getFilterBank();
+  Napi::Array result = Napi::Array::New(env, specs.size());
+  for (size_t i = 0; i < specs.size(); i++) {
+    Napi::Object o = Napi::Object::New(env);
+    o.Set("type", Napi::String::New(env, kFilterTypeNames[static_cast<int>(specs[i].type)]));
+    o.Set("frequency", Napi::Number::New(env, specs[i].frequency));
+    o.Set("q", Napi::Number::New(env, specs[i].q));
+    o.Set("gainDb", Napi::Number::New(env, specs[i].gainDb));
+    result.Set(static_cast<uint32_t>(i), o);
+  }
+  return result;
+}
+
+/**
+ * setCalibration({ noiseFloor, calibratedFrames, residualFloor, gateGain }) -> boolean
+ * Applied by the next start(). Returns false while running or when a
+ * value is missing or out of range.
+ */
+Napi::Value SetCalibration(const Napi::CallbackInfo& info) {
+  Napi::Env env = info.Env();
+  if (info.Length() < 1 || !info[0].IsObject()) return Napi::Boolean::New(env, false);
+  Napi::Object o = info[0].As<Napi::Object>();
+  for (const char* key : {"noiseFloor", "calibratedFrames", "residualFloor", "gateGain"}) {
+    if (!o.Get(key).IsNumber()) return Napi::Boolean::New(env, false);
+  }
+
+  double frames = o.Get("calibratedFrames").As<Napi::Number>().DoubleValue();
+  if (!(frames >= 0.0 && frames <= 4294967295.0)) return Napi::Boolean::New(env, false);
+
+  ainoiceguard::Calibration c;
+  c.noiseFloor = o.Get("noiseFloor").As<Napi::Number>().FloatValue();
+  c.calibratedFrames = static_cast<uint32_t>(frames);
+  c.residualFloor = o.Get("residualFloor").As<Napi::Number>().FloatValue();
+  c.gateGain = o.Get("gateGain").As<Napi::Number>().FloatValue();
+  return Napi::Boolean::New(env, g_engine.setCalibration(c));
+}
+
+/**
+ * getCalibration() -> { noiseFloor, calibratedFrames, residualFloor, gateGain } | null
+ */
+Napi::Value GetCalibration(const Napi::CallbackInfo& info) {
+  Napi::Env env = info.Env();
+  ainoiceguard::Calibration c;
+  if (!g_engine.getCalibration(&c)) return env.Null();
+  Napi::Object o = Napi::Object::New(env);
+  o.Set("noiseFloor", Napi::Number::New(env, c.noiseFloor));
+  o.Set("calibratedFrames", Napi::Number::New(env, c.calibratedFrames));
+  o.Set("residualFloor", Napi::Number::New(env, c.residualFloor));
+  o.Set("gateGain", Napi::Number::New(env, c.gateGain));
+  return o;
+}
+
+/* "little" -> kLittle; anything else -> kStandard. */
+ainoiceguard::ModelTier ParseTier(const Napi::CallbackInfo& info, size_t arg) {
+  if (info.Length() > arg && info[arg].IsString() &&
+      info[arg].As<Napi::String>().Utf8Value() == "little") {
+    return ainoiceguard::ModelTier::kLittle;
+  }
+  return ainoiceguard::ModelTier::kStandard;
+}
+
+/**
+ * setModelTier(tier) -> void
+ * tier: "standard" (double pass) or "little" (single pass, little model).
+ */
+void SetModelTier(const Napi::CallbackInfo& info) {
+  if (info.Length() < 1 || !info[0].IsString()) return;
+  std::string tier = info[0].As<Napi::String>().Utf8Value();
+  if (tier == "standard") {
+    g_engine.setModelTier(ainoiceguard::ModelTier::kStandard);
+  } else if (tier == "little") {
+    g_engine.setModelTier(ainoiceguard::ModelTier::kLittle);
+  }
+}
+
+/**
+ * getModelTier() -> string
+ */
+Napi::Value GetModelTier(const Napi::CallbackInfo& info) {
+  bool little = g_engine.getModelTier() == ainoiceguard::ModelTier::kLittle;
+  return Napi::String::New(info.Env(), little ? "little" : "standard");
+}
+
+/**
+ * Loads a model file and builds its RNNoise states on a libuv worker
+ * thread, so a hot-swap never blocks the JS thread.
+ */
+class ModelPathWorker : public Napi::AsyncWorker {
+ public:
+  ModelPathWorker(Napi::Env env, std::string path, ainoiceguard::ModelTier tier)
+      : Napi::AsyncWorker(env),
+        deferred_(Napi::Promise::Deferred::New(env)),
+        path_(std::move(path)),
+        tier_(tier) {}
+
+  Napi::Promise Promise() const { return deferred_.Promise(); }
+
+  void Execute() override { result_ = g_engine.setModelPath(path_, tier_); }
+
+  void OnOK() override {
+    deferred_.Resolve(Napi::String::New(Env(), result_));
+  }
+
+ private:
+  Napi::Promise::Deferred deferred_;
+  std::string path_;
+  ainoiceguard::ModelTier tier_;
+  std::string result_;
+};
+
+/**
+ * setModelPath(path, tier = "standard") -> Promise<string>
+ * Resolves to "" on success, or an error message. "" selects the built-in
+ * model (standard) or no little model. While running the new model is
+ * hot-swapped in (~100ms crossfade); otherwise it applies on start().
+ */
+Napi::Value SetModelPath(const Napi::CallbackInfo& info) {
+  Napi::Env env = info.Env();
+  std::string path;
+  if (info.Length() >= 1 && info[0].IsString()) {
+    path = info[0].As<Napi::String>().Utf8Value();
+  }
+  auto* worker = new ModelPathWorker(env, path, ParseTier(info, 1));
+  Napi::Promise promise = worker->Promise();
+  worker->Queue();  /* AsyncWorker deletes itself after OnOK */
+  return promise;
+}
+
+/**
+ * getModelPath(tier = "standard") -> string ("" = built-in / none)
+ */
+Napi::Value GetModelPath(const Napi::CallbackInfo& info) {
+  return Napi::String::New(info.Env(), g_engine.getModelPath(ParseTier(info, 0)));
+}
+
+/**
+ * getDiagnostics() -> { dspKernels, rnnoiseIsa,
+ *                       cpu: { sse2, avx2, fma, avx512f, avx512bw, neon } }
+ *
+ * Which SIMD paths the runtime dispatch selected for our kernels and for
+ * RNNoise. Static for the life of the process.
+ */
+Napi::Value GetDiagnostics(const Napi::CallbackInfo& info) {
+  Napi::Env env = info.Env();
+  const auto& d = ainoiceguard::dispatchInfo();
+
+  Napi::Object cpu = Napi::Object::New(env);
+  cpu.Set("sse2", Napi::Boolean::New(env, d.cpu.sse2));
+  cpu.Set("avx2", Napi::Boolean::New(env, d.cpu.avx2));
+  cpu.Set("fma", Napi::Boolean::New(env, d.cpu.fma));
+  cpu.Set("avx512f", Napi::Boolean::New(env, d.cpu.avx512f));
+  cpu.Set("avx512bw", Napi::Boolean::New(env, d.cpu.avx512bw));
+  cpu.Set("neon", Napi::Boolean::New(env, d.cpu.neon));
+
+  Napi::Object result = Napi::Object::New(env);
+  result.Set("dspKernels", Napi::String::New(env, d.dspKernels));
+  result.Set("rnnoiseIsa", Napi::String::New(env, d.rnnoiseIsa));
+  result.Set("cpu", cpu);
+  return result;
+}
+
 /**
  * isRunning() -> boolean
  */
@@ -131,7 +557,18 @@ Napi::Value IsRunning(const Napi::CallbackInfo& info) {
 }
 
 /**
- * getMetrics() -> { inputRms, outputRms, vadProbability, gateGain, framesProcessed }
+ * getMetrics() -> { inputRms, outputRms, vadProbability, gateGain, framesProcessed,
+ *                  noiseFloor, pass2DutyCycle, pass2Frames, silentFrames,
+ *                  modelTier, modelSwaps, qualityTier, qualityTierChanges,
+ *                  cpuLoad, governor: { floor, stepsDown, stepsUp,
+ *                  headroomWaitMs }, pipeline: { enabled, stages } }
+ *
+ * qualityTier is the CPU governor's current tier ("full", "single-pass",
+ * "lean-filters", "little-model"); cpuLoad its smoothed processing time
+ * per frame period (1.0 = no headroom). pipeline.stages lists the
+ * pipelined mode's stages in frame order ("pass1", "pass2", "post"), each
+ * { name, queueDepth, maxQueueDepth, lastMs }: frames waiting for the
+ * stage now and at most since start, and the last frame's time in it.
  *
  * Returns a snapshot of real-time audio metrics. Lock-free atomic reads.
  * Call this from a polling interval (e.g. every 100ms) to animate the UI meter.
@@ -154,7 +591,195 @@ Napi::Value GetMetrics(const Napi::CallbackInfo& info) {
       static_cast<double>(m.framesProcessed.load(std::memory_order_relaxed))));
   result.Set("noiseFloor", Napi::Number::New(env,
       static_cast<double>(m.noiseFloor.load(std::memory_order_relaxed))));
+  result.Set("pass2DutyCycle", Napi::Number::New(env,
+      static_cast<double>(m.pass2DutyCycle.load(std::memory_order_relaxed))));
+  result.Set("pass2Frames", Napi::Number::New(env,
+      static_cast<double>(m.pass2Frames.load(std::memory_order_relaxed))));
+  result.Set("silentFrames", Napi::Number::New(env,
+      static_cast<double>(m.silentFrames.load(std::memory_order_relaxed))));
+  result.Set("modelTier", Napi::String::New(env,
+      m.modelTier.load(std::memory_order_relaxed) == 1 ? "little" : "standard"));
+  result.Set("modelSwaps", Napi::Number::New(env,
+      static_cast<double>(m.modelSwaps.load(std::memory_order_relaxed))));
+  result.Set("qualityTier", Napi::String::New(env,
+      kQualityTierNames[m.qualityTier.load(std::memory_order_relaxed) & 3]));
+  result.Set("qualityTierChanges", Napi::Number::New(env,
+      static_cast<double>(m.qualityTierChanges.load(std::memory_order_relaxed))));
+
+  ainoiceguard::GovernorStats g = g_engine.governorStats();
+  result.Set("cpuLoad", Napi::Number::New(env, static_cast<double>(g.load)));
+  Napi::Object governor = Napi::Object::New(env);
+  governor.Set("floor", Napi::String::New(env, kQualityTierNames[static_cast<int>(g.floor) & 3]));
+  governor.Set("stepsDown", Napi::Number::New(env, static_cast<double>(g.stepsDown)));
+  governor.Set("stepsUp", Napi::Number::New(env, static_cast<double>(g.stepsUp)));
+  governor.Set("headroomWaitMs", Napi::Number::New(env, g.headroomWaitFrames * 10.0));
+  result.Set("governor", governor);
+
+  ainoiceguard::PipelineStats p = g_engine.pipelineStats();
+  Napi::Object pipeline = Napi::Object::New(env);
+  pipeline.Set("enabled", Napi::Boolean::New(env, p.running));
+  Napi::Array stages = Napi::Array::New(env, ainoiceguard::PipelineStats::kStageCount);
+  for (int i = 0; i < ainoiceguard::PipelineStats::kStageCount; i++) {
+    Napi::Object stage = Napi::Object::New(env);
+    stage.Set("name", Napi::String::New(env, kPipelineStageNames[i]));
+    stage.Set("queueDepth", Napi::Number::New(env, p.depth[i]));
+    stage.Set("maxQueueDepth", Napi::Number::New(env, p.maxDepth[i]));
+    stage.Set("lastMs", Napi::Number::New(env, p.stageUs[i] / 1000.0));
+    stages.Set(static_cast<uint32_t>(i), stage);
+  }
+  pipeline.Set("stages", stages);
+  result.Set("pipeline", pipeline);
+
+  /* Last start(), in milliseconds; firstFrameMs is 0 until a frame went through. */
+  ainoiceguard::StartupTiming t = g_engine.startupTiming();
+  Napi::Object startup = Napi::Object::New(env);
+  startup.Set("sessionMs", Napi::Number::New(env, t.sessionUs / 1000.0));
+  startup.Set("rnnoiseMs", Napi::Number::New(env, t.rnnoiseUs / 1000.0));
+  startup.Set("openMs", Napi::Number::New(env, t.openUs / 1000.0));
+  startup.Set("startMs", Napi::Number::New(env, t.startUs / 1000.0));
+  startup.Set("firstFrameMs", Napi::Number::New(env, t.firstFrameUs / 1000.0));
+  result.Set("startup", startup);
+
+  return result;
+}
+
+/**
+ * getAnomalies() -> { budgetMs, framesTimed, deadlineMisses, lastLatencyMs,
+ *                     worstLatencyMs, trimmedFrames, catchUpFrames,
+ *                     underrunSamples, total,
+ *                     records: [{ timeMs, frame, kinds, paStatusFlags,
+ *                     latencyMs, processMs, droppedSamples, underrunSamples,
+ *                     captureFill, outputFill, trimmedSamples, catchUpFrames,
+ *                     qualityTier, cpuLoad }],
+ *                     xruns: { inputUnderflow, inputOverflow, outputUnderflow,
+ *                     outputOverflow, restarts, lastRestartReason } }
+ *
+ * Deadline counters and the anomaly log (oldest first, last 256 records)
+ * since the last start(); kept after stop() for bug reports. `kinds`
+ * lists "deadline-miss", "capture-overflow", "output-underrun", "xrun",
+ * "backlog-trim", "tier-change".
+ * `xruns` counts PortAudio xrun callbacks by type and the device-loss
+ * restarts; lastRestartReason is "none", "stream-inactive",
+ * "capture-starved", "output-starved" or "xrun-storm".
+ */
+Napi::Value GetAnomalies(const Napi::CallbackInfo& info) {
+  Napi::Env env = info.Env();
+
+  ainoiceguard::DeadlineStats d = g_engine.deadlineStats();
+  Napi::Object result = Napi::Object::New(env);
+  result.Set("budgetMs", Napi::Number::New(env, d.budgetUs / 1000.0));
+  result.Set("framesTimed", Napi::Number::New(env, static_cast<double>(d.framesTimed)));
+  result.Set("deadlineMisses", Napi::Number::New(env, static_cast<double>(d.misses)));
+  result.Set("lastLatencyMs", Napi::Number::New(env, d.lastLatencyUs / 1000.0));
+  result.Set("worstLatencyMs", Napi::Number::New(env, d.worstLatencyUs / 1000.0));
+  result.Set("trimmedFrames", Napi::Number::New(env, static_cast<double>(d.trimmedFrames)));
+  result.Set("catchUpFrames", Napi::Number::New(env, static_cast<double>(d.catchUpFrames)));
+  result.Set("underrunSamples", Napi::Number::New(env, static_cast<double>(d.underrunSamples)));
+  result.Set("total", Napi::Number::New(env, static_cast<double>(d.anomalies)));
+
+  static const struct {
+    uint32_t bit;
+    const char* name;
+  } kKinds[] = {
+      {ainoiceguard::kAnomalyDeadlineMiss, "deadline-miss"},
+      {ainoiceguard::kAnomalyCaptureOverflow, "capture-overflow"},
+      {ainoiceguard::kAnomalyOutputUnderrun, "output-underrun"},
+      {ainoiceguard::kAnomalyXrun, "xrun"},
+      {ainoiceguard::kAnomalyBacklogTrim, "backlog-trim"},
+      {ainoiceguard::kAnomalyTierChange, "tier-change"},
+  };
+
+  std::vector<ainoiceguard::AnomalyRecord> log = g_engine.anomalyLog();
+  Napi::Array records = Napi::Array::New(env, log.size());
+  for (size_t i = 0; i < log.size(); i++) {
+    const ainoiceguard::AnomalyRecord& r = log[i];
+    Napi::Array kinds = Napi::Array::New(env);
+    for (const auto& k : kKinds) {
+      if (r.kinds & k.bit) kinds.Set(kinds.Length(), Napi::String::New(env, k.name));
+    }
+    Napi::Object o = Napi::Object::New(env);
+    o.Set("timeMs", Napi::Number::New(env, static_cast<double>(r.timeUs) / 1000.0));
+    o.Set("frame", Napi::Number::New(env, static_cast<double>(r.framesProcessed)));
+    o.Set("kinds", kinds);
+    o.Set("paStatusFlags", Napi::Number::New(env, r.paStatusFlags));
+    o.Set("latencyMs", Napi::Number::New(env, r.latencyUs / 1000.0));
+    o.Set("processMs", Napi::Number::New(env, r.processUs / 1000.0));
+    o.Set("droppedSamples", Napi::Number::New(env, r.droppedSamples));
+    o.Set("underrunSamples", Napi::Number::New(env, r.underrunSamples));
+    o.Set("captureFill", Napi::Number::New(env, r.captureFill));
+    o.Set("outputFill", Napi::Number::New(env, r.outputFill));
+    o.Set("trimmedSamples", Napi::Number::New(env, r.trimmedSamples));
+    o.Set("catchUpFrames", Napi::Number::New(env, r.catchUpFrames));
+    o.Set("qualityTier", Napi::String::New(env, kQualityTierNames[r.qualityTier & 3]));
+    o.Set("cpuLoad", Napi::Number::New(env, r.loadPermille / 1000.0));
+    records.Set(static_cast<uint32_t>(i), o);
+  }
+  result.Set("records", records);
 
+  static const char* const kReasons[] = {"none", "stream-inactive", "capture-starved",
+                                         "output-starved", "xrun-storm"};
+  ainoiceguard::XrunStats x = g_engine.xrunStats();
+  Napi::Object xruns = Napi::Object::New(env);
+  xruns.Set("inputUnderflow", Napi::Number::New(env, static_cast<double>(x.inputUnderflow)));
+  xruns.Set("inputOverflow", Napi::Number::New(env, static_cast<double>(x.inputOverflow)));
+  xruns.Set("outputUnderflow", Napi::Number::New(env, static_cast<double>(x.outputUnderflow)));
+  xruns.Set("outputOverflow", Napi::Number::New(env, static_cast<double>(x.outputOverflow)));
+  xruns.Set("restarts", Napi::Number::New(env, static_cast<double>(x.restarts)));
+  xruns.Set("lastRestartReason",
+            Napi::String::New(env, kReasons[static_cast<uint32_t>(x.lastRestartReason)]));
+  result.Set("xruns", xruns);
+  return result;
+}
+
+/**
+ * getLatency() -> { inputDeviceMs, frameAssemblyMs, processingMs,
+ *                   modelDelayMs, outputQueueMs, outputDeviceMs, totalMs,
+ *                   captureBlock, outputBlock, outputCushion }
+ *
+ * Mic-to-output latency breakdown of the running engine (see
+ * LatencyBudget in audio.h). Block sizes and the cushion are in samples.
+ */
+Napi::Value GetLatency(const Napi::CallbackInfo& info) {
+  Napi::Env env = info.Env();
+  ainoiceguard::LatencyBudget b = g_engine.latencyBudget();
+
+  Napi::Object result = Napi::Object::New(env);
+  result.Set("inputDeviceMs", Napi::Number::New(env, b.inputDeviceMs));
+  result.Set("frameAssemblyMs", Napi::Number::New(env, b.frameAssemblyMs));
+  result.Set("processingMs", Napi::Number::New(env, b.processingMs));
+  result.Set("modelDelayMs", Napi::Number::New(env, b.modelDelayMs));
+  result.Set("outputQueueMs", Napi::Number::New(env, b.outputQueueMs));
+  result.Set("outputDeviceMs", Napi::Number::New(env, b.outputDeviceMs));
+  result.Set("totalMs", Napi::Number::New(env, b.totalMs));
+  result.Set("captureBlock", Napi::Number::New(env, b.captureBlock));
+  result.Set("outputBlock", Napi::Number::New(env, b.outputBlock));
+  result.Set("outputCushion", Napi::Number::New(env, b.outputCushion));
+  return result;
+}
+
+/**
+ * getCallbackTiming(reset?) -> { captureCallbacks, captureJitterMeanMs,
+ *                                captureJitterMaxMs, outputCallbacks,
+ *                                outputJitterMeanMs, outputJitterMaxMs }
+ *
+ * How far callback intervals stray from the block duration, since start()
+ * or the last reset. Pass true to reset after reading (e.g. to skip the
+ * warm-up when auto-tuning).
+ */
+Napi::Value GetCallbackTiming(const Napi::CallbackInfo& info) {
+  Napi::Env env = info.Env();
+  ainoiceguard::CallbackTiming t = g_engine.callbackTiming();
+  if (info.Length() >= 1 && info[0].IsBoolean() && info[0].As<Napi::Boolean>().Value()) {
+    g_engine.resetCallbackTiming();
+  }
+
+  Napi::Object result = Napi::Object::New(env);
+  result.Set("captureCallbacks", Napi::Number::New(env, static_cast<double>(t.captureCallbacks)));
+  result.Set("captureJitterMeanMs", Napi::Number::New(env, t.captureJitterMeanUs / 1000.0));
+  result.Set("captureJitterMaxMs", Napi::Number::New(env, t.captureJitterMaxUs / 1000.0));
+  result.Set("outputCallbacks", Napi::Number::New(env, static_cast<double>(t.outputCallbacks)));
+  result.Set("outputJitterMeanMs", Napi::Number::New(env, t.outputJitterMeanUs / 1000.0));
+  result.Set("outputJitterMaxMs", Napi::Number::New(env, t.outputJitterMaxUs / 1000.0));
   return result;
 }
 
@@ -169,8 +794,24 @@ Napi::Object Init(Napi::Env env, Napi::Object exports) {
   exports.Set("getNoiseLevel", Napi::Function::New(env, GetNoiseLevel));
   exports.Set("setVadThreshold", Napi::Function::New(env, SetVadThreshold));
   exports.Set("getVadThreshold", Napi::Function::New(env, GetVadThreshold));
+  exports.Set("setSecondPassMode", Napi::Function::New(env, SetSecondPassMode));
+  exports.Set("getSecondPassMode", Napi::Function::New(env, GetSecondPassMode));
+  exports.Set("setStages", Napi::Function::New(env, SetStages));
+  exports.Set("getStages", Napi::Function::New(env, GetStages));
+  exports.Set("setFilters", Napi::Function::New(env, SetFilters));
+  exports.Set("getFilters", Napi::Function::New(env, GetFilters));
+  exports.Set("setCalibration", Napi::Function::New(env, SetCalibration));
+  exports.Set("getCalibration", Napi::Function::New(env, GetCalibration));
+  exports.Set("setModelTier", Napi::Function::New(env, SetModelTier));
+  exports.Set("getModelTier", Napi::Function::New(env, GetModelTier));
+  exports.Set("setModelPath", Napi::Function::New(env, SetModelPath));
+  exports.Set("getModelPath", Napi::Function::New(env, GetModelPath));
   exports.Set("isRunning", Napi::Function::New(env, IsRunning));
   exports.Set("getMetrics", Napi::Function::New(env, GetMetrics));
+  exports.Set("getDiagnostics", Napi::Function::New(env, GetDiagnostics));
+  exports.Set("getAnomalies", Napi::Function::New(env, GetAnomalies));
+  exports.Set("getLatency", Napi::Function::New(env, GetLatency));
+  exports.Set("getCallbackTiming", Napi::Function::New(env, GetCallbackTiming));
   return exports;
 }
 
@@ -9,14 +9,30 @@
  *   - Capture callback:    PortAudio's audio thread (real-time priority).
  *   - Output callback:     PortAudio's audio thread (real-time priority).
  *   - Processing loop:     Our own std::thread (elevated priority recommended).
+ *   - Event loop:          Our own std::thread (normal priority). The only place
+ *                          the status callback runs.
  *   - start()/stop():      Called from Node.js main thread via N-API.
+ *   - RNNoise init:        A short-lived std::thread inside start(), running
+ *                          while the streams open.
+ *
+ * PortAudio session:
+ *   Pa_Initialize() probes every host API and device, which is the slowest
+ *   part of a start. The engine initializes PortAudio once (on the first
+ *   start() or enumerateDevices()) and keeps it up across stop()/start();
+ *   Pa_Terminate() runs only in the destructor. PortAudio snapshots the
+ *   device list at initialization, so enumerateDevices(true) re-opens an
+ *   idle session to pick up hot-plugged devices; plain enumerateDevices()
+ *   reuses the open session.
  */
 
 #include "audio.h"
 
+#include <algorithm>
 #include <chrono>
 #include <cmath>
+#include <cstdint>
 #include <cstring>
+#include <utility>
 
 #include "portaudio.h"
 
@@ -33,22 +49,122 @@ namespace ainoiceguard {
  */
 static constexpr size_t kRingCapacity = 4096;
 
+/* Serial RNNoise passes, each delaying its output by one frame. */
+static constexpr size_t kModelDelayFrames = 2;
+
+/*
+ * Ring capacity for a host buffer size: kRingCapacity, or room for two
+ * host periods plus four frames when the host delivers larger blocks.
+ */
+static size_t ringCapacityFor(unsigned long framesPerBuffer) {
+  return std::max(kRingCapacity,
+                  nextPowerOf2(2 * framesPerBuffer + 4 * kRNNoiseFrameSize));
+}
+
+static size_t gcd(size_t a, size_t b) {
+  while (b) {
+    size_t t = a % b;
+    a = b;
+    b = t;
+  }
+  return a;
+}
+
+/*
+ * Fade-in after a backlog cut (1 ms at 48 kHz). The output ring has
+ * usually run dry during the stall that caused the backlog, so the first
+ * frame after the cut ramps up from the silence just played.
+ */
+static constexpr size_t kSpliceFadeSamples = 48;
+
+/*
+ * Pipelined frames carry their capture position (low 32 bits) and what
+ * the output does with them through RNNoisePipeline's tag.
+ */
+static constexpr uint64_t kTagEmit = 1ull << 32;    /* Played (not a catch-up frame) */
+static constexpr uint64_t kTagFadeIn = 1ull << 33;  /* First frame after a splice */
+
 /* Max restart attempts before giving up. */
 static constexpr int kMaxRestartAttempts = 5;
 
+/*
+ * Event thread poll interval. Status events are informational, so 20ms of
+ * delivery latency is irrelevant and keeps the thread nearly idle.
+ */
+static constexpr int kEventPollMs = 20;
+
+/*
+ * Synthetic frames RNNoiseWrapper::prewarm() runs during start(): enough
+ * to fault in the weights and every code path (both passes, gate, filters).
+ */
+static constexpr size_t kPrewarmFrames = 8;
+
+/* PortAudio xrun status bits (paInputUnderflow..paOutputOverflow). */
+static constexpr uint32_t kXrunFlagMask = 0x0000000F;
+
+/*
+ * Device health check interval (processing thread). Starvation timeouts
+ * are measured at this granularity; the check itself is a few atomic
+ * loads plus Pa_IsStreamActive() per stream.
+ */
+static constexpr int kHealthCheckMs = 100;
+
+/* Count each xrun bit in statusFlags. REAL-TIME SAFE. */
+static void countXruns(std::atomic<uint64_t>* counts, PaStreamCallbackFlags statusFlags) {
+  for (int bit = 0; bit < 4; bit++) {
+    if (statusFlags & (1ul << bit)) counts[bit].fetch_add(1, std::memory_order_relaxed);
+  }
+}
+
+/* Microseconds since `t0`, truncated to 32 bits (deadline maths is modular). */
+static uint32_t clockUs(std::chrono::steady_clock::time_point t0,
+                        std::chrono::steady_clock::time_point t) {
+  return static_cast<uint32_t>(
+      std::chrono::duration_cast<std::chrono::microseconds>(t - t0).count());
+}
+
 /* ───────────────────── Constructor / Destructor ───────────────────── */
 
 AudioEngine::AudioEngine() = default;
 
-AudioEngine::~AudioEngine() { stop(); }
+AudioEngine::~AudioEngine() {
+  stop();
+  closeSession();
+}
+
+/* Microseconds since `t0`, saturated to 32 bits. */
+static uint32_t elapsedUs(std::chrono::steady_clock::time_point t0) {
+  auto us = std::chrono::duration_cast<std::chrono::microseconds>(
+                std::chrono::steady_clock::now() - t0).count();
+  return static_cast<uint32_t>(std::min<int64_t>(us, UINT32_MAX));
+}
+
+/* ───────────────────── PortAudio Session ───────────────────── */
+
+std::string AudioEngine::openSession() {
+  if (paSession_) return "";
+  PaError err = Pa_Initialize();
+  if (err != paNoError) {
+    return std::string("Pa_Initialize failed: ") + Pa_GetErrorText(err);
+  }
+  paSession_ = true;
+  return "";
+}
+
+void AudioEngine::closeSession() {
+  if (!paSession_) return;
+  Pa_Terminate();
+  paSession_ = false;
+}
 
 /* ───────────────────── Device Enumeration ───────────────────── */
 
-std::vector<DeviceInfo> AudioEngine::enumerateDevices() {
+std::vector<DeviceInfo> AudioEngine::enumerateDevices(bool refresh) {
   std::vector<DeviceInfo> devices;
 
-  PaError err = Pa_Initialize();
-  if (err != paNoError) return devices;
+  /* Idle refresh: re-open the session so the list reflects hot-plugged devices. */
+  if (refresh && !running_.load(std::memory_order_acquire)) closeSession();
+  if (!openSession().empty()) return devices;
 
   int numDevices = Pa_GetDeviceCount();
   for (int i = 0; i < numDevices; i++) {
@@ -58,13 +174,18 @@ std::vector<DeviceInfo> AudioEngine::enumerateDevices() {
     DeviceInfo d;
     d.index = i;
     d.name = info->name ? info->name : "(unknown)";
+    const PaHostApiInfo* api = Pa_GetHostApiInfo(info->hostApi);
+    d.hostApi = api && api->name ? api->name : "(unknown)";
     d.maxInputChannels = info->maxInputChannels;
     d.maxOutputChannels = info->maxOutputChannels;
     d.defaultSampleRate = info->defaultSampleRate;
+    d.defaultLowInputLatency = info->defaultLowInputLatency;
+    d.defaultHighInputLatency = info->defaultHighInputLatency;
+    d.defaultLowOutputLatency = info->defaultLowOutputLatency;
+    d.defaultHighOutputLatency = info->defaultHighOutputLatency;
     devices.push_back(d);
   }
 
-  Pa_Terminate();
   return devices;
 }
 
@@ -77,36 +198,113 @@ std::string AudioEngine::start(const AudioConfig& config) {
 
   config_ = config;
 
-  /* Initialize PortAudio. */
-  PaError err = Pa_Initialize();
-  if (err != paNoError) {
-    return std::string("Pa_Initialize failed: ") + Pa_GetErrorText(err);
+  const auto t0 = std::chrono::steady_clock::now();
+  startTiming_ = StartupTiming();
+  firstFrameUs_.store(0, std::memory_order_relaxed);
+  startTime_ = t0;
+
+  /* Keep PortAudio initialized across starts (see PortAudio session above). */
+  std::string sessionErr = openSession();
+  if (!sessionErr.empty()) return sessionErr;
+  startTiming_.sessionUs = elapsedUs(t0);
+
+  /* Allocate ring buffers once (again if the host buffer outgrows them); later starts only empty them. */
+  const size_t ringCapacity = ringCapacityFor(config_.framesPerBuffer);
+  if (!captureRing_ || captureRing_->capacity() != ringCapacity) {
+    captureRing_ = std::make_unique<RingBuffer>(ringCapacity);
+    outputRing_ = std::make_unique<RingBuffer>(ringCapacity);
   }
+  captureRing_->reset();
+  outputRing_->reset();
 
-  /* Allocate ring buffers. Done once here, never in callbacks. */
-  captureRing_ = std::make_unique<RingBuffer>(kRingCapacity);
-  outputRing_ = std::make_unique<RingBuffer>(kRingCapacity);
+  /*
+   * Deadline watchdog: a frame is due one frame period after it arrives
+   * (two when pipelined: the stages hand it on a frame later).
+   */
+  framePeriodUs_ = static_cast<uint32_t>(
+      1e6 * static_cast<double>(kRNNoiseFrameSize) / config_.sampleRate);
+  deadlineBudgetUs_ = config_.pipelined ? 2 * framePeriodUs_ : framePeriodUs_;
+  captureClock_.store(0, std::memory_order_relaxed);
+  droppedSamples_.store(0, std::memory_order_relaxed);
+  underrunSamples_.store(0, std::memory_order_relaxed);
+  outputPrimed_.store(false, std::memory_order_relaxed);
+  underrunTotal_.store(0, std::memory_order_relaxed);
+  concealer_.reset();
+  outputHolding_ = true;
+  outputStarted_ = false;
+  captureBlock_.store(0, std::memory_order_relaxed);
+  outputBlock_.store(0, std::memory_order_relaxed);
+  outputCushion_.store(0, std::memory_order_relaxed);
+  resetCallbackTiming();
+  framesTimed_.store(0, std::memory_order_relaxed);
+  deadlineMisses_.store(0, std::memory_order_relaxed);
+  lastLatencyUs_.store(0, std::memory_order_relaxed);
+  worstLatencyUs_.store(0, std::memory_order_relaxed);
+  anomalyLog_.clear();
 
-  /* Initialize RNNoise. */
-  if (!rnnoise_.init()) {
-    Pa_Terminate();
-    return "RNNoise initialization failed";
-  }
+  /*
+   * Backlog bound: never below one host buffer plus a frame (a large
+   * buffer lands several frames at once), and below the frames the ring
+   * holds, so the policy acts before the capture callback has to drop.
+   */
+  const size_t ringFrames = (captureRing_->capacity() - 1) / kRNNoiseFrameSize;
+  const size_t hostFrames =
+      (config_.framesPerBuffer + kRNNoiseFrameSize - 1) / kRNNoiseFrameSize;
+  hostFrames_ = std::max<size_t>(hostFrames, 1);
+  size_t backlogLimit = std::max<size_t>(config_.maxBacklogFrames, hostFrames + 1);
+  backlogLimit = std::min<size_t>(backlogLimit, ringFrames - 2);
+  backlog_.configure(config_.overflowPolicy, backlogLimit, kRNNoiseFrameSize);
+  trimmedSince_ = 0;
+  catchUpSince_ = 0;
+  trimmedFrames_.store(0, std::memory_order_relaxed);
+  catchUpFrames_.store(0, std::memory_order_relaxed);
+  rnnoise_.setCatchUp(false);
+
+  /* Every session starts at full quality; the governor sheds from there. */
+  governor_.reset();
+  governor_.setFloor(config_.governorFloor);
+  rnnoise_.setQualityTier(QualityTier::kFull);
+  governorLoad_.store(0.0f, std::memory_order_relaxed);
+  governorStepsDown_.store(0, std::memory_order_relaxed);
+  governorStepsUp_.store(0, std::memory_order_relaxed);
+  governorWait_.store(governor_.headroomWait(), std::memory_order_relaxed);
+
+  /*
+   * Create the DenoiseStates and prewarm them on a helper thread while
+   * this one opens the streams: the two are independent, and each takes
+   * milliseconds. Nothing reads rnnoise_ until the join below.
+   */
+  bool rnnoiseOk = false;
+  std::thread initThread([this, &rnnoiseOk] {
+    const auto ti = std::chrono::steady_clock::now();
+    std::lock_guard<std::mutex> lock(modelMutex_);
+    rnnoiseOk = rnnoise_.init(model_, littleModel_);
+    rnnoiseLive_ = true;  /* From here on setModelPath() swaps, even before running_ */
+    if (rnnoiseOk) rnnoise_.prewarm(kPrewarmFrames);
+    startTiming_.rnnoiseUs = elapsedUs(ti);
+  });
 
   /* Open PortAudio streams. */
+  const auto to = std::chrono::steady_clock::now();
   std::string openErr = openStreams();
+  startTiming_.openUs = elapsedUs(to);
+  initThread.join();
+
+  if (!rnnoiseOk) {
+    closeStreams();
+    releaseRnnoise();
+    return "RNNoise initialization failed";
+  }
   if (!openErr.empty()) {
-    rnnoise_.destroy();
-    Pa_Terminate();
+    releaseRnnoise();
     return openErr;
   }
 
   /* Start streams. */
-  err = Pa_StartStream(captureStream_);
+  PaError err = Pa_StartStream(captureStream_);
   if (err != paNoError) {
     closeStreams();
-    rnnoise_.destroy();
-    Pa_Terminate();
+    releaseRnnoise();
     return std::string("Failed to start capture stream: ") + Pa_GetErrorText(err);
   }
 
@@ -116,16 +314,23 @@ std::string AudioEngine::start(const AudioConfig& config) {
     if (err != paNoError) {
       Pa_StopStream(captureStream_);
       closeStreams();
-      rnnoise_.destroy();
-      Pa_Terminate();
+      releaseRnnoise();
       return std::string("Failed to start output stream: ") + Pa_GetErrorText(err);
     }
   }
 
-  /* Launch processing thread. */
+  /* Launch processing thread + event delivery thread. */
+  pendingXrunFlags_.store(0, std::memory_order_relaxed);
+  for (auto& c : xrunCounts_) c.store(0, std::memory_order_relaxed);
+  restarts_.store(0, std::memory_order_relaxed);
+  lastRestartReason_.store(static_cast<uint32_t>(RestartReason::kNone), std::memory_order_relaxed);
+  resetDeviceHealth(std::chrono::steady_clock::now());
   running_.store(true, std::memory_order_release);
+  if (config_.pipelined) pipeline_.start(&rnnoise_);
   processingThread_ = std::thread(&AudioEngine::processingLoop, this);
+  eventThread_ = std::thread(&AudioEngine::eventLoop, this);
 
+  startTiming_.startUs = elapsedUs(t0);
   return "";  /* Success */
 }
 
@@ -135,22 +340,43 @@ void AudioEngine::stop() {
   /* Signal processing thread to exit. */
   running_.store(false, std::memory_order_release);
 
-  /* Wait for processing thread to finish. */
+  /* Wait for processing thread to finish, then the pipeline stages. */
   if (processingThread_.joinable()) {
     processingThread_.join();
   }
+  pipeline_.stop();
+
+  /* Event thread drains whatever the processing thread queued, then exits. */
+  if (eventThread_.joinable()) {
+    eventThread_.join();
+  }
 
   /* Stop and close streams. */
   if (captureStream_) Pa_StopStream(captureStream_);
   if (outputStream_) Pa_StopStream(outputStream_);
   closeStreams();
 
-  /* Cleanup. */
+  /* Cleanup. The processing thread is gone: keep what the gate learned. */
+  {
+    std::lock_guard<std::mutex> lock(modelMutex_);
+    lastCalibration_ = rnnoise_.exportCalibration();
+    hasCalibration_ = true;
+    rnnoiseLive_ = false;
+    rnnoise_.destroy();
+  }
+  /* Rings and the PortAudio session stay for the next start(). */
+}
+
+void AudioEngine::releaseRnnoise() {
+  std::lock_guard<std::mutex> lock(modelMutex_);
+  rnnoiseLive_ = false;
   rnnoise_.destroy();
-  captureRing_.reset();
-  outputRing_.reset();
+}
 
-  Pa_Terminate();
+StartupTiming AudioEngine::startupTiming() const {
+  StartupTiming t = startTiming_;
+  t.firstFrameUs = firstFrameUs_.load(std::memory_order_relaxed);
+  return t;
 }
 
 /* ───────────────────── Stream Setup ───────────────────── */
@@ -175,7 +401,8 @@ std::string AudioEngine::openStreams() {
   inputParams.channelCount = 1;  /* Mono -- RNNoise is mono only. */
   inputParams.sampleFormat = paFloat32;
   inputParams.suggestedLatency =
-      Pa_GetDeviceInfo(inputIdx)->defaultLowInputLatency;
+      config_.inputLatencyMs > 0.0 ? config_.inputLatencyMs / 1000.0
+                                   : Pa_GetDeviceInfo(inputIdx)->defaultLowInputLatency;
   inputParams.hostApiSpecificStreamInfo = nullptr;
 
   /* ── Output stream parameters (optional) ── */
@@ -185,7 +412,8 @@ std::string AudioEngine::openStreams() {
     outputParams.channelCount = 1;  /* Mono output. */
     outputParams.sampleFormat = paFloat32;
     outputParams.suggestedLatency =
-        Pa_GetDeviceInfo(outputIdx)->defaultLowOutputLatency;
+        config_.outputLatencyMs > 0.0 ? config_.outputLatencyMs / 1000.0
+                                      : Pa_GetDeviceInfo(outputIdx)->defaultLowOutputLatency;
     outputParams.hostApiSpecificStreamInfo = nullptr;
   }
 
@@ -259,6 +487,12 @@ std::string AudioEngine::openStreams() {
     }
   }
 
+  const PaStreamInfo* captureInfo = Pa_GetStreamInfo(captureStream_);
+  inputLatencyUs_.store(
+      captureInfo ? static_cast<uint32_t>(captureInfo->inputLatency * 1e6) : 0,
+      std::memory_order_relaxed);
+  outputLatencyUs_.store(0, std::memory_order_relaxed);
+
   if (!outputEnabled) {
     outputStream_ = nullptr;
     return ""; /* Success: capture-only (mute output) */
@@ -286,6 +520,10 @@ std::string AudioEngine::openStreams() {
     }
   }
 
+  const PaStreamInfo* outputInfo = Pa_GetStreamInfo(outputStream_);
+  outputLatencyUs_.store(
+      outputInfo ? static_cast<uint32_t>(outputInfo->outputLatency * 1e6) : 0,
+      std::memory_order_relaxed);
   return "";  /* Success */
 }
 
@@ -313,12 +551,14 @@ int AudioEngine::captureCallback(const void* input, void* /*output*/,
    * We only write to the lock-free ring buffer.
    */
   auto* engine = static_cast<AudioEngine*>(userData);
+  engine->captureCallbacks_.fetch_add(1, std::memory_order_relaxed);  /* Heartbeat */
 
   if (!input || !engine->running_.load(std::memory_order_relaxed)) {
     return paContinue;
   }
 
   const auto* samples = static_cast<const float*>(input);
+  engine->captureBlock_.store(static_cast<uint32_t>(frameCount), std::memory_order_relaxed);
 
   /*
    * Write captured samples to ring buffer.
@@ -326,12 +566,34 @@ int AudioEngine::captureCallback(const void* input, void* /*output*/,
    * This is intentional: in real-time audio, dropping frames is
    * better than blocking or introducing unbounded latency.
    */
-  engine->captureRing_->write(samples, frameCount);
+  size_t written = engine->captureRing_->write(samples, frameCount);
+  if (written < frameCount) {
+    engine->droppedSamples_.fetch_add(static_cast<uint32_t>(frameCount - written),
+                                      std::memory_order_relaxed);
+  }
 
-  /* Detect device issues via statusFlags. */
+  /*
+   * Date the newest sample for the deadline watchdog. steady_clock::now()
+   * is a vDSO / QueryPerformanceCounter read, not a blocking call.
+   */
+  uint64_t clock = engine->captureClock_.load(std::memory_order_relaxed);
+  uint32_t total = static_cast<uint32_t>(clock) + static_cast<uint32_t>(written);
+  uint32_t nowUs = clockUs(engine->startTime_, std::chrono::steady_clock::now());
+  engine->captureClock_.store((static_cast<uint64_t>(nowUs) << 32) | total,
+                              std::memory_order_release);
+  engine->captureJitter_.record(nowUs, frameCount, engine->config_.sampleRate);
+
+  /*
+   * Count and report xruns; do NOT restart for them. A transient xrun is
+   * one glitch, a restart is hundreds of ms of silence. Device loss is
+   * detected separately (see DEVICE HEALTH).
+   */
   if (statusFlags & 0x00000001 /* paInputUnderflow */ ||
       statusFlags & 0x00000002 /* paInputOverflow */) {
-    engine->shouldRestart_.store(true, std::memory_order_relaxed);
+    engine->pendingXrunFlags_.fetch_or(
+        static_cast<uint32_t>(statusFlags) & kXrunFlagMask,
+        std::memory_order_relaxed);
+    countXruns(engine->xrunCounts_, statusFlags & 0x00000003);
   }
 
   return paContinue;
@@ -347,27 +609,69 @@ int AudioEngine::outputCallback(const void* /*input*/, void* output,
   /*
    * REAL-TIME SAFE: Same rules as captureCallback.
    * Read processed samples from the output ring buffer.
-   * If not enough data is available, output silence (zero-fill).
+   * If not enough data is available, conceal the shortfall from recent
+   * output (or zero-fill when concealment is off).
    */
   auto* engine = static_cast<AudioEngine*>(userData);
   auto* out = static_cast<float*>(output);
+  engine->outputCallbacks_.fetch_add(1, std::memory_order_relaxed);  /* Heartbeat */
 
   if (!engine->running_.load(std::memory_order_relaxed)) {
     memset(out, 0, frameCount * sizeof(float));
     return paContinue;
   }
 
-  size_t read = engine->outputRing_->read(out, frameCount);
+  engine->outputBlock_.store(static_cast<uint32_t>(frameCount), std::memory_order_relaxed);
+  engine->outputJitter_.record(clockUs(engine->startTime_, std::chrono::steady_clock::now()),
+                               frameCount, engine->config_.sampleRate);
+
+  /* kCushioned: hold output (concealed) until the ring holds the cushion. */
+  const bool cushioned = engine->config_.outputRelease == OutputRelease::kCushioned;
+  uint32_t cushion = engine->outputCushion_.load(std::memory_order_relaxed);
+  if (cushion < frameCount) {
+    cushion = static_cast<uint32_t>(frameCount);
+    engine->outputCushion_.store(cushion, std::memory_order_relaxed);
+  }
+  if (cushioned && engine->outputHolding_ &&
+      engine->outputRing_->available_read() >= cushion) {
+    engine->outputHolding_ = false;
+    engine->outputStarted_ = true;
+  }
+  size_t read = (cushioned && engine->outputHolding_)
+                    ? 0
+                    : engine->outputRing_->read(out, frameCount);
 
-  /* Zero-fill remainder if underrun (not enough processed data yet). */
-  if (read < frameCount) {
+  /*
+   * Before the first processed frame (kCushioned: the first cushion),
+   * silence is expected, not an underrun.
+   */
+  const bool primed = engine->outputPrimed_.load(std::memory_order_relaxed);
+  if (engine->config_.concealUnderruns && primed) {
+    /* Also splices returning audio into a running concealment. */
+    engine->concealer_.process(out, read, frameCount);
+  } else if (read < frameCount) {
     memset(out + read, 0, (frameCount - read) * sizeof(float));
   }
+  if (read < frameCount && (cushioned ? engine->outputStarted_ : primed)) {
+    engine->underrunSamples_.fetch_add(static_cast<uint32_t>(frameCount - read),
+                                       std::memory_order_relaxed);
+    engine->underrunTotal_.fetch_add(frameCount - read, std::memory_order_relaxed);
+    if (cushioned && !engine->outputHolding_) {
+      /* Ran dry: rebuild a deeper cushion (one more period, capped). */
+      engine->outputHolding_ = true;
+      uint32_t cap = static_cast<uint32_t>(frameCount + 2 * kRNNoiseFrameSize);
+      engine->outputCushion_.store(std::min(cushion + static_cast<uint32_t>(frameCount), cap),
+                                   std::memory_order_relaxed);
+    }
+  }
 
-  /* Detect output issues. */
+  /* Count and report output xruns (no restart, see captureCallback). */
   if (statusFlags & 0x00000004 /* paOutputUnderflow */ ||
       statusFlags & 0x00000008 /* paOutputOverflow */) {
-    engine->shouldRestart_.store(true, std::memory_order_relaxed);
+    engine->pendingXrunFlags_.fetch_or(
+        static_cast<uint32_t>(statusFlags) & kXrunFlagMask,
+        std::memory_order_relaxed);
+    countXruns(engine->xrunCounts_, statusFlags & 0x0000000C);
   }
 
   return paContinue;
@@ -382,22 +686,88 @@ void AudioEngine::processingLoop() {
    * priority (PortAudio callbacks are higher priority).
    *
    * We process in chunks of kRNNoiseFrameSize (480 samples = 10ms).
+   * Pipelined, this thread submits frames to pipeline_ and runs the post
+   * stage of the frames that come back, in capture order.
    */
   float frame[kRNNoiseFrameSize];
+  bool firstFrame = true;
+  bool spliced = false;  /* Next emitted frame follows a backlog cut */
+  uint32_t readPos = 0;  /* Capture samples consumed, mod 2^32 (see captureClock_) */
+  const bool pipelined = config_.pipelined;
 
   while (running_.load(std::memory_order_acquire)) {
-    /* Check if we have a full RNNoise frame available. */
-    if (captureRing_->available_read() >= kRNNoiseFrameSize) {
+    uint32_t kinds = 0;
+    bool busy = false;
+
+    /* Fallen behind? Cut the backlog per config_.overflowPolicy. */
+    if (boundBacklog(&readPos)) {
+      kinds |= kAnomalyBacklogTrim;
+      spliced = true;
+    }
+
+    /* Check if we have a full RNNoise frame available (and room for it). */
+    if (captureRing_->available_read() >= kRNNoiseFrameSize &&
+        (!pipelined || pipeline_.canSubmit())) {
+      busy = true;
       captureRing_->read(frame, kRNNoiseFrameSize);
+      readPos += static_cast<uint32_t>(kRNNoiseFrameSize);
 
-      /* Run noise suppression. */
-      rnnoise_.processFrame(frame);
+      /* Catch-up frames keep the DSP state continuous but are not played. */
+      const bool emit = !backlog_.takeCatchUpFrame();
+      if (!emit) {
+        catchUpSince_++;
+        catchUpFrames_.fetch_add(1, std::memory_order_relaxed);
+      }
+
+      if (pipelined) {
+        /* Tag: capture position, emit, fade-in (decided in capture order). */
+        const bool fadeIn = emit && spliced && outputStream_;
+        if (fadeIn) spliced = false;
+        pipeline_.submit(frame, readPos | (emit ? kTagEmit : 0) | (fadeIn ? kTagFadeIn : 0));
+      } else {
+        /* Run noise suppression. */
+        const auto t0 = std::chrono::steady_clock::now();
+        rnnoise_.processFrame(frame);
+        const auto t1 = std::chrono::steady_clock::now();
+        if (timeFrame(readPos, clockUs(t0, t1), t1)) kinds |= kAnomalyDeadlineMiss;
+        if (updateGovernor()) kinds |= kAnomalyTierChange;
+        if (firstFrame) {
+          firstFrameUs_.store(elapsedUs(startTime_), std::memory_order_relaxed);
+          firstFrame = false;
+        }
+      }
+      if (!emit && backlog_.catchUpPending() == 0) {
+        rnnoise_.setCatchUp(false);  /* Backlog worked off: full tier again */
+        kinds |= kAnomalyBacklogTrim;
+        spliced = true;
+      }
 
       /* If output is disabled, discard processed audio (no monitoring). */
-      if (outputStream_) {
-        outputRing_->write(frame, kRNNoiseFrameSize);
+      if (!pipelined && outputStream_ && emit) {
+        emitFrame(frame, spliced);
+        spliced = false;
+      }
+    }
+
+    /* Pipelined: finish whatever has cleared pass 2. */
+    RNNoisePipeline::Result r;
+    while (pipelined && pipeline_.collect(frame, &r)) {
+      busy = true;
+      uint32_t slowestUs = 0;
+      for (uint32_t us : r.stageUs) slowestUs = std::max(slowestUs, us);
+      const auto done = std::chrono::steady_clock::now();
+      if (timeFrame(static_cast<uint32_t>(r.tag), slowestUs, done)) {
+        kinds |= kAnomalyDeadlineMiss;
       }
-    } else {
+      if (updateGovernor()) kinds |= kAnomalyTierChange;
+      if (firstFrame) {
+        firstFrameUs_.store(elapsedUs(startTime_), std::memory_order_relaxed);
+        firstFrame = false;
+      }
+      if (outputStream_ && (r.tag & kTagEmit)) emitFrame(frame, (r.tag & kTagFadeIn) != 0);
+    }
+
+    if (!busy) {
       /*
        * Not enough data yet. Sleep briefly to avoid spinning at 100% CPU.
        * 0.5ms sleep is fine: at 48kHz, a 480-sample frame arrives every 10ms,
@@ -407,20 +777,337 @@ void AudioEngine::processingLoop() {
       std::this_thread::sleep_for(std::chrono::microseconds(500));
     }
 
-    /* Handle device disconnect / restart. */
-    if (shouldRestart_.load(std::memory_order_relaxed)) {
-      shouldRestart_.store(false, std::memory_order_relaxed);
-      attemptRestart();
+    /* Report xruns flagged by the callbacks since the last iteration. */
+    uint32_t xrunFlags = pendingXrunFlags_.exchange(0, std::memory_order_relaxed);
+    if (xrunFlags != 0) {
+      postEvent(StatusEventType::kXrun, 0, xrunFlags);
+      kinds |= kAnomalyXrun;
+    }
+    recordAnomalies(kinds, xrunFlags);
+
+    /* Handle device loss: reopen the streams. */
+    const auto now = std::chrono::steady_clock::now();
+    if (now - health_.lastCheck >= std::chrono::milliseconds(kHealthCheckMs)) {
+      RestartReason reason = checkDeviceHealth(now);
+      if (reason != RestartReason::kNone) {
+        attemptRestart(reason);
+        resetDeviceHealth(std::chrono::steady_clock::now());
+      }
     }
   }
 }
 
-/* ───────────────────── Auto-Restart ───────────────────── */
+void AudioEngine::emitFrame(float* frame, bool fadeIn) {
+  if (fadeIn) {
+    for (size_t i = 0; i < kSpliceFadeSamples; i++) {
+      frame[i] *= static_cast<float>(i) / static_cast<float>(kSpliceFadeSamples);
+    }
+  }
+  outputRing_->write(frame, kRNNoiseFrameSize);
+  outputPrimed_.store(true, std::memory_order_relaxed);
+}
+
+/* ───────────────────── CPU Governor ───────────────────── */
+
+/*
+ * Feed the frame just timed to the governor and apply its tier to the
+ * next frame. The backlog allowance is one host buffer's worth of frames:
+ * a large buffer lands several at once without anyone being late, and a
+ * backlog being caught up on does not count (BacklogBound::pressureFrames).
+ * Pipelined, the slowest stage is what must fit in a frame period.
+ * Returns true when the tier changed.
+ */
+bool AudioEngine::updateGovernor() {
+  const QualityTier before = governor_.tier();
+  const size_t backlog = backlog_.pressureFrames(*captureRing_);
+  const QualityTier tier =
+      governor_.update(lastProcessUs_, framePeriodUs_, backlog, hostFrames_);
+  governorLoad_.store(governor_.load(), std::memory_order_relaxed);
+  governorWait_.store(governor_.headroomWait(), std::memory_order_relaxed);
+  if (tier == before) return false;
+
+  rnnoise_.setQualityTier(tier);
+  governorStepsDown_.store(governor_.stepsDown(), std::memory_order_relaxed);
+  governorStepsUp_.store(governor_.stepsUp(), std::memory_order_relaxed);
+  return true;
+}
+
+GovernorStats AudioEngine::governorStats() const {
+  GovernorStats s;
+  s.tier = rnnoise_.getQualityTier();
+  s.floor = config_.governorFloor;
+  s.load = governorLoad_.load(std::memory_order_relaxed);
+  s.stepsDown = governorStepsDown_.load(std::memory_order_relaxed);
+  s.stepsUp = governorStepsUp_.load(std::memory_order_relaxed);
+  s.headroomWaitFrames = governorWait_.load(std::memory_order_relaxed);
+  return s;
+}
 
-void AudioEngine::attemptRestart() {
-  if (statusCallback_) {
-    statusCallback_("Device issue detected, attempting restart...");
+/* ───────────────────── Backlog Bound ───────────────────── */
+
+/*
+ * The policy itself lives in BacklogBound (see backlog_bound.h); the
+ * engine keeps the read position, the counters and the RNNoise tier in
+ * step with it. A catch-up runs on the cheap tier until its last frame.
+ */
+bool AudioEngine::boundBacklog(uint32_t* readPos) {
+  const bool wasCatchingUp = backlog_.catchUpPending() > 0;
+  const size_t skip = backlog_.apply(*captureRing_);
+  const bool catchingUp = backlog_.catchUpPending() > 0;
+  if (catchingUp != wasCatchingUp) rnnoise_.setCatchUp(catchingUp);
+  if (skip == 0) return false;
+
+  *readPos += static_cast<uint32_t>(skip);
+  trimmedSince_ += static_cast<uint32_t>(skip);
+  trimmedFrames_.fetch_add(skip / kRNNoiseFrameSize, std::memory_order_relaxed);
+  return true;
+}
+
+/* ───────────────────── Device Health ───────────────────── */
+
+/*
+ * DEVICE HEALTH: what counts as a lost device.
+ *
+ *  - A stream PortAudio no longer reports active (Pa_IsStreamActive() != 1):
+ *    the host API stopped it, typically on unplug or a driver reset.
+ *  - A callback that has not run for starvationTimeoutMs: the device
+ *    stopped clocking without telling PortAudio (USB hubs, Bluetooth).
+ *  - Optionally, xrunRestartCount xruns within xrunWindowMs: a stream so
+ *    broken that a reopen is cheaper than the glitching.
+ *
+ * Single xruns are none of these; they are counted (xrunStats()) and
+ * reported as kXrun events only.
+ */
+RestartReason AudioEngine::checkDeviceHealth(std::chrono::steady_clock::time_point now) {
+  health_.lastCheck = now;
+
+  /* A failed restart (kRestartFailed) left no streams: the user restarts. */
+  if (!captureStream_) return RestartReason::kNone;
+
+  if (Pa_IsStreamActive(captureStream_) != 1) {
+    return RestartReason::kStreamInactive;
+  }
+  if (outputStream_ && Pa_IsStreamActive(outputStream_) != 1) {
+    return RestartReason::kStreamInactive;
+  }
+
+  const auto starvation = std::chrono::milliseconds(config_.starvationTimeoutMs);
+  uint64_t beats = captureCallbacks_.load(std::memory_order_relaxed);
+  if (beats != health_.captureBeats) {
+    health_.captureBeats = beats;
+    health_.captureSeen = now;
+  } else if (config_.starvationTimeoutMs && now - health_.captureSeen >= starvation) {
+    return RestartReason::kCaptureStarved;
+  }
+  if (outputStream_) {
+    beats = outputCallbacks_.load(std::memory_order_relaxed);
+    if (beats != health_.outputBeats) {
+      health_.outputBeats = beats;
+      health_.outputSeen = now;
+    } else if (config_.starvationTimeoutMs && now - health_.outputSeen >= starvation) {
+      return RestartReason::kOutputStarved;
+    }
+  }
+
+  if (config_.xrunRestartCount) {
+    uint64_t total = 0;
+    for (const auto& c : xrunCounts_) total += c.load(std::memory_order_relaxed);
+    if (now - health_.windowStart >= std::chrono::milliseconds(config_.xrunWindowMs)) {
+      health_.windowStart = now;
+      health_.windowXruns = total;
+    } else if (total - health_.windowXruns >= config_.xrunRestartCount) {
+      return RestartReason::kXrunStorm;
+    }
   }
+  return RestartReason::kNone;
+}
+
+void AudioEngine::resetDeviceHealth(std::chrono::steady_clock::time_point now) {
+  health_.lastCheck = now;
+  health_.captureSeen = now;
+  health_.outputSeen = now;
+  health_.captureBeats = captureCallbacks_.load(std::memory_order_relaxed);
+  health_.outputBeats = outputCallbacks_.load(std::memory_order_relaxed);
+  health_.windowStart = now;
+  health_.windowXruns = 0;
+  for (const auto& c : xrunCounts_) health_.windowXruns += c.load(std::memory_order_relaxed);
+}
+
+XrunStats AudioEngine::xrunStats() const {
+  XrunStats s;
+  s.inputUnderflow = xrunCounts_[0].load(std::memory_order_relaxed);
+  s.inputOverflow = xrunCounts_[1].load(std::memory_order_relaxed);
+  s.outputUnderflow = xrunCounts_[2].load(std::memory_order_relaxed);
+  s.outputOverflow = xrunCounts_[3].load(std::memory_order_relaxed);
+  s.restarts = restarts_.load(std::memory_order_relaxed);
+  s.lastRestartReason =
+      static_cast<RestartReason>(lastRestartReason_.load(std::memory_order_relaxed));
+  return s;
+}
+
+/* ───────────────────── Deadline Watchdog ───────────────────── */
+
+/*
+ * A frame is complete when the capture callback writes its last sample;
+ * it is due one frame period later, when the next frame is complete --
+ * finishing after that means the pipeline fell behind real time and the
+ * output ring is draining. captureClock_ holds the time of the newest
+ * callback and the running sample count, so the completion time of an
+ * older sample is that time minus the samples since, at the sample rate.
+ */
+bool AudioEngine::timeFrame(uint32_t frameEnd, uint32_t processUs,
+                            std::chrono::steady_clock::time_point done) {
+  uint64_t clock = captureClock_.load(std::memory_order_acquire);
+  uint32_t stampUs = static_cast<uint32_t>(clock >> 32);
+  uint32_t since = static_cast<uint32_t>(clock) - frameEnd;  /* Samples after the frame */
+  uint32_t arrivalUs = stampUs - static_cast<uint32_t>(
+      1e6 * static_cast<double>(since) / config_.sampleRate);
+
+  int32_t latency = static_cast<int32_t>(clockUs(startTime_, done) - arrivalUs);
+  uint32_t latencyUs = latency > 0 ? static_cast<uint32_t>(latency) : 0;
+  lastProcessUs_ = processUs;
+
+  framesTimed_.fetch_add(1, std::memory_order_relaxed);
+  lastLatencyUs_.store(latencyUs, std::memory_order_relaxed);
+  if (latencyUs > worstLatencyUs_.load(std::memory_order_relaxed)) {
+    worstLatencyUs_.store(latencyUs, std::memory_order_relaxed);
+  }
+  if (latencyUs <= deadlineBudgetUs_) return false;
+  deadlineMisses_.fetch_add(1, std::memory_order_relaxed);
+  return true;
+}
+
+void AudioEngine::recordAnomalies(uint32_t kinds, uint32_t paStatusFlags) {
+  /*
+   * REAL-TIME SAFE: two atomic exchanges, and on an anomaly one POD
+   * record into the fixed-size history ring (overwrites the oldest).
+   */
+  uint32_t dropped = droppedSamples_.exchange(0, std::memory_order_relaxed);
+  uint32_t underrun = underrunSamples_.exchange(0, std::memory_order_relaxed);
+  if (dropped) kinds |= kAnomalyCaptureOverflow;
+  if (underrun) kinds |= kAnomalyOutputUnderrun;
+  if (kinds == 0) return;
+
+  AnomalyRecord r;
+  r.timeUs = static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::microseconds>(
+      std::chrono::steady_clock::now() - startTime_).count());
+  r.framesProcessed = rnnoise_.metrics().framesProcessed.load(std::memory_order_relaxed);
+  r.kinds = kinds;
+  r.paStatusFlags = paStatusFlags;
+  r.latencyUs = lastLatencyUs_.load(std::memory_order_relaxed);
+  r.processUs = lastProcessUs_;
+  r.droppedSamples = dropped;
+  r.underrunSamples = underrun;
+  r.captureFill = static_cast<uint32_t>(captureRing_->available_read());
+  r.outputFill = static_cast<uint32_t>(outputRing_->available_read());
+  r.trimmedSamples = trimmedSince_;
+  r.catchUpFrames = catchUpSince_;
+  r.qualityTier = static_cast<uint32_t>(governor_.tier());
+  r.loadPermille = static_cast<uint32_t>(governor_.load() * 1000.0f);
+  trimmedSince_ = 0;
+  catchUpSince_ = 0;
+  anomalyLog_.push(r);
+}
+
+DeadlineStats AudioEngine::deadlineStats() const {
+  DeadlineStats s;
+  s.framesTimed = framesTimed_.load(std::memory_order_relaxed);
+  s.misses = deadlineMisses_.load(std::memory_order_relaxed);
+  s.anomalies = anomalyLog_.total();
+  s.budgetUs = deadlineBudgetUs_;
+  s.lastLatencyUs = lastLatencyUs_.load(std::memory_order_relaxed);
+  s.worstLatencyUs = worstLatencyUs_.load(std::memory_order_relaxed);
+  s.underrunSamples = underrunTotal_.load(std::memory_order_relaxed);
+  s.trimmedFrames = trimmedFrames_.load(std::memory_order_relaxed);
+  s.catchUpFrames = catchUpFrames_.load(std::memory_order_relaxed);
+  return s;
+}
+
+/*
+ * Frame assembly: with host blocks of b samples, the first sample of a
+ * frame waits max(480 - b, 0) samples beyond its own block for the frame
+ * to fill; when b does not divide 480, the block that completes a frame
+ * also carries up to b - gcd(b, 480) samples past it (half on average).
+ */
+LatencyBudget AudioEngine::latencyBudget() const {
+  LatencyBudget b;
+  const double msPerSample = 1000.0 / config_.sampleRate;
+  const double frame = static_cast<double>(kRNNoiseFrameSize);
+  b.captureBlock = captureBlock_.load(std::memory_order_relaxed);
+  b.outputBlock = outputBlock_.load(std::memory_order_relaxed);
+  b.outputCushion = outputCushion_.load(std::memory_order_relaxed);
+
+  b.inputDeviceMs = inputLatencyUs_.load(std::memory_order_relaxed) / 1000.0;
+  if (b.captureBlock) {
+    const double block = static_cast<double>(b.captureBlock);
+    const double misaligned = block - static_cast<double>(gcd(b.captureBlock, kRNNoiseFrameSize));
+    b.frameAssemblyMs = (std::max(frame - block, 0.0) + misaligned / 2.0) * msPerSample;
+  }
+  b.processingMs = lastLatencyUs_.load(std::memory_order_relaxed) / 1000.0;
+  b.modelDelayMs = static_cast<double>(kModelDelayFrames) * frame * msPerSample;
+  if (outputRing_ && config_.outputDeviceIndex != -2) {
+    b.outputQueueMs = static_cast<double>(outputRing_->available_read()) * msPerSample;
+  }
+  b.outputDeviceMs = outputLatencyUs_.load(std::memory_order_relaxed) / 1000.0;
+  b.totalMs = b.inputDeviceMs + b.frameAssemblyMs + b.processingMs + b.modelDelayMs +
+              b.outputQueueMs + b.outputDeviceMs;
+  return b;
+}
+
+/* ───────────────────── Callback Timing ───────────────────── */
+
+void AudioEngine::JitterStats::reset() {
+  lastUs.store(0, std::memory_order_relaxed);
+  count.store(0, std::memory_order_relaxed);
+  sumUs.store(0, std::memory_order_relaxed);
+  maxUs.store(0, std::memory_order_relaxed);
+}
+
+void AudioEngine::JitterStats::record(uint32_t nowUs, unsigned long frameCount,
+                                      double sampleRate) {
+  uint32_t last = lastUs.load(std::memory_order_relaxed);
+  lastUs.store(nowUs ? nowUs : 1, std::memory_order_relaxed);
+  if (last == 0) return;  /* First callback since start / reset */
+
+  int64_t interval = static_cast<int64_t>(static_cast<uint32_t>(nowUs - last));
+  int64_t expected = static_cast<int64_t>(1e6 * static_cast<double>(frameCount) / sampleRate);
+  uint32_t stray = static_cast<uint32_t>(std::min<int64_t>(
+      interval > expected ? interval - expected : expected - interval, UINT32_MAX));
+  count.fetch_add(1, std::memory_order_relaxed);
+  sumUs.fetch_add(stray, std::memory_order_relaxed);
+  if (stray > maxUs.load(std::memory_order_relaxed)) {
+    maxUs.store(stray, std::memory_order_relaxed);
+  }
+}
+
+CallbackTiming AudioEngine::callbackTiming() const {
+  CallbackTiming t;
+  t.captureCallbacks = captureJitter_.count.load(std::memory_order_relaxed);
+  t.captureJitterMeanUs = t.captureCallbacks
+      ? static_cast<double>(captureJitter_.sumUs.load(std::memory_order_relaxed)) /
+            static_cast<double>(t.captureCallbacks)
+      : 0.0;
+  t.captureJitterMaxUs = captureJitter_.maxUs.load(std::memory_order_relaxed);
+  t.outputCallbacks = outputJitter_.count.load(std::memory_order_relaxed);
+  t.outputJitterMeanUs = t.outputCallbacks
+      ? static_cast<double>(outputJitter_.sumUs.load(std::memory_order_relaxed)) /
+            static_cast<double>(t.outputCallbacks)
+      : 0.0;
+  t.outputJitterMaxUs = outputJitter_.maxUs.load(std::memory_order_relaxed);
+  return t;
+}
+
+void AudioEngine::resetCallbackTiming() {
+  captureJitter_.reset();
+  outputJitter_.reset();
+}
+
+/* ───────────────────── Auto-Restart ───────────────────── */
+
+void AudioEngine::attemptRestart(RestartReason reason) {
+  restarts_.fetch_add(1, std::memory_order_relaxed);
+  lastRestartReason_.store(static_cast<uint32_t>(reason), std::memory_order_relaxed);
+  postEvent(StatusEventType::kRestartBegin, 0, 0, reason);
 
   for (int attempt = 0; attempt < kMaxRestartAttempts; attempt++) {
     /* Exponential backoff: 100ms, 200ms, 400ms, 800ms, 1600ms */
@@ -453,15 +1140,92 @@ void AudioEngine::attemptRestart() {
       }
     }
 
+    postEvent(StatusEventType::kRestartSucceeded,
+              static_cast<uint32_t>(attempt + 1));
+    return;
+  }
+
+  postEvent(StatusEventType::kRestartFailed,
+            static_cast<uint32_t>(kMaxRestartAttempts));
+}
+
+/* ───────────────────── Status Events ───────────────────── */
+
+void AudioEngine::postEvent(StatusEventType type, uint32_t attempt,
+                            uint32_t xrunFlags, RestartReason reason) {
+  /*
+   * REAL-TIME SAFE: fills a POD record and pushes it into a fixed-size
+   * lock-free queue. If the consumer has fallen behind the event is
+   * dropped and counted -- the audio path never waits on the UI.
+   */
+  StatusEvent ev;
+  ev.type = type;
+  ev.attempt = attempt;
+  ev.xrunFlags = xrunFlags;
+  ev.reason = reason;
+  ev.framesProcessed =
+      rnnoise_.metrics().framesProcessed.load(std::memory_order_relaxed);
+
+  if (!eventQueue_.push(ev)) {
+    droppedEvents_.fetch_add(1, std::memory_order_relaxed);
+  }
+}
+
+void AudioEngine::eventLoop() {
+  /*
+   * Non-real-time consumer. Formatting strings and running the user's
+   * callback happen here, so the processing thread never allocates or
+   * calls out on behalf of status reporting.
+   */
+  while (running_.load(std::memory_order_acquire)) {
+    drainEvents();
+    rnnoise_.reclaimRetired();  /* Free swap / filter-bank records */
+    std::this_thread::sleep_for(std::chrono::milliseconds(kEventPollMs));
+  }
+
+  /* The processing thread has been joined: deliver the tail of the queue. */
+  drainEvents();
+}
+
+void AudioEngine::drainEvents() {
+  StatusEvent ev;
+  while (eventQueue_.pop(ev)) {
+    std::lock_guard<std::mutex> lock(callbackMutex_);
     if (statusCallback_) {
-      statusCallback_("Audio engine restarted successfully");
+      statusCallback_(ev, describeStatusEvent(ev));
     }
-    return;
   }
+}
 
-  if (statusCallback_) {
-    statusCallback_("Failed to restart audio engine after multiple attempts");
+std::string describeStatusEvent(const StatusEvent& event) {
+  switch (event.type) {
+    case StatusEventType::kRestartBegin:
+      switch (event.reason) {
+        case RestartReason::kStreamInactive:
+          return "Audio stream stopped, attempting restart...";
+        case RestartReason::kCaptureStarved:
+          return "Input device stopped delivering audio, attempting restart...";
+        case RestartReason::kOutputStarved:
+          return "Output device stopped requesting audio, attempting restart...";
+        case RestartReason::kXrunStorm:
+          return "Too many audio xruns, attempting restart...";
+        default:
+          return "Device issue detected, attempting restart...";
+      }
+    case StatusEventType::kRestartSucceeded:
+      return "Audio engine restarted successfully";
+    case StatusEventType::kRestartFailed:
+      return "Failed to restart audio engine after multiple attempts";
+    case StatusEventType::kXrun: {
+      std::string msg = "Audio xrun:";
+      if (event.xrunFlags & 0x00000001) msg += " input-underflow";
+      if (event.xrunFlags & 0x00000002) msg += " input-overflow";
+      if (event.xrunFlags & 0x00000004) msg += " output-underflow";
+      if (event.xrunFlags & 0x00000008) msg += " output-overflow";
+      return msg;
+    }
   }
+  return "Unknown engine event";
 }
 
 /* ───────────────────── Level Control ───────────────────── */
@@ -475,6 +1239,7 @@ float AudioEngine::getSuppressionLevel() const {
 }
 
 void AudioEngine::setStatusCallback(StatusCallback cb) {
+  std::lock_guard<std::mutex> lock(callbackMutex_);
   statusCallback_ = std::move(cb);
 }
 
@@ -486,4 +1251,79 @@ float AudioEngine::getVadThreshold() const {
   return rnnoise_.getVadThreshold();
 }
 
+void AudioEngine::setSecondPassMode(SecondPassMode mode) {
+  rnnoise_.setSecondPassMode(mode);
+}
+
+SecondPassMode AudioEngine::getSecondPassMode() const {
+  return rnnoise_.getSecondPassMode();
+}
+
+void AudioEngine::setStagePlan(const StagePlan& plan) {
+  rnnoise_.setStagePlan(plan);
+}
+
+StagePlan AudioEngine::getStagePlan() const {
+  return rnnoise_.getStagePlan();
+}
+
+std::string AudioEngine::setFilterBank(const std::vector<FilterSpec>& specs) {
+  return rnnoise_.setFilterBank(specs);
+}
+
+std::vector<FilterSpec> AudioEngine::getFilterBank() const {
+  return rnnoise_.getFilterBank();
+}
+
+bool AudioEngine::setCalibration(const Calibration& c) {
+  std::lock_guard<std::mutex> lock(modelMutex_);
+  if (rnnoiseLive_) return false;  /* Too late for this session's init() */
+  return rnnoise_.importCalibration(c);
+}
+
+bool AudioEngine::getCalibration(Calibration* out) const {
+  std::lock_guard<std::mutex> lock(modelMutex_);
+  if (!hasCalibration_) return false;
+  *out = lastCalibration_;
+  return true;
+}
+
+void AudioEngine::setModelTier(ModelTier tier) {
+  rnnoise_.setModelTier(tier);
+}
+
+ModelTier AudioEngine::getModelTier() const {
+  return rnnoise_.getModelTier();
+}
+
+std::string AudioEngine::setModelPath(const std::string& path, ModelTier tier) {
+  std::shared_ptr<const RNNoiseModel> model;
+  if (!path.empty()) {
+    std::string err = RNNoiseModel::load(path, &model);
+    if (!err.empty()) return err;
+  }
+
+  std::lock_guard<std::mutex> lock(modelMutex_);
+  auto& slot = tier == ModelTier::kLittle ? littleModel_ : model_;
+
+  /*
+   * States exist (running, or start() is past init()): hot-swap now, or
+   * they would keep the old model while this slot names the new one.
+   * Removing the little model waits for a restart.
+   */
+  if (rnnoiseLive_ && (model || tier == ModelTier::kStandard)) {
+    if (!rnnoise_.prepareModelSwap(model, tier)) {
+      return "Failed to create RNNoise state for the new model";
+    }
+  }
+  slot = std::move(model);
+  return "";
+}
+
+std::string AudioEngine::getModelPath(ModelTier tier) const {
+  std::lock_guard<std::mutex> lock(modelMutex_);
+  const auto& slot = tier == ModelTier::kLittle ? littleModel_ : model_;
+  return slot ? slot->path() : std::string();
+}
+
 }  // namespace ainoiceguard
@@ -9,6 +9,8 @@
  *   They only read/write the lock-free ring buffers.
  * - Processing thread: Allowed to call RNNoise (which is allocation-free per frame).
  *   Spins on captureRing_ with a short sleep to avoid burning CPU.
+ *   Never calls user code: status/xrun events are pushed as POD records into
+ *   a lock-free queue and delivered by a separate (non-real-time) event thread.
  *
  * WASAPI NOTES (Windows):
  * - We attempt exclusive mode for lowest latency. Falls back to shared if unavailable.
@@ -19,14 +21,23 @@
 #define AINOICEGUARD_AUDIO_H
 
 #include <atomic>
+#include <chrono>
+#include <cstdint>
 #include <functional>
 #include <memory>
+#include <mutex>
 #include <string>
 #include <thread>
 #include <vector>
 
+#include "backlog_bound.h"
+#include "concealment.h"
+#include "cpu_governor.h"
+#include "history_ring.h"
 #include "ringbuffer.h"
+#include "rnnoise_pipeline.h"
 #include "rnnoise_wrapper.h"
+#include "spsc_queue.h"
 
 /* Forward-declare PortAudio types to avoid including portaudio.h in this header. */
 typedef void PaStream;
@@ -39,9 +50,30 @@ namespace ainoiceguard {
 struct DeviceInfo {
   int index;
   std::string name;
+  std::string hostApi;  /* e.g. "Windows WASAPI", "ALSA" */
   int maxInputChannels;
   int maxOutputChannels;
   double defaultSampleRate;
+  double defaultLowInputLatency;    /* Seconds */
+  double defaultHighInputLatency;
+  double defaultLowOutputLatency;
+  double defaultHighOutputLatency;
+};
+
+/**
+ * When processed audio starts playing.
+ *   kCushioned -- at start and after each underrun, conceal until the
+ *                 output ring holds a cushion; the cushion starts at one
+ *                 output period and grows by one period per underrun (up
+ *                 to two frames more), so latency adapts to the jitter
+ *                 actually seen.
+ *   kImmediate -- play each frame as soon as it completes and conceal any
+ *                 shortfall. Lowest latency; with host periods below a
+ *                 frame, expect regular concealment.
+ */
+enum class OutputRelease : uint32_t {
+  kCushioned,
+  kImmediate,
 };
 
 /** Configuration for the audio engine. */
@@ -49,15 +81,213 @@ struct AudioConfig {
   int inputDeviceIndex = -1;   /* -1 = default input */
   int outputDeviceIndex = -1;  /* -1 = default output, -2 = disable output (mute) */
   double sampleRate = 48000.0;
-  unsigned long framesPerBuffer = 480;  /* 10ms @ 48kHz = RNNoise frame size */
+  /*
+   * Host buffer size, independent of the 480-sample RNNoise frame: the
+   * rings assemble frames from any callback size. 0 lets the host choose
+   * (paFramesPerBufferUnspecified), which may vary between callbacks.
+   */
+  unsigned long framesPerBuffer = 480;
+  /* PortAudio suggestedLatency per stream; 0 = the device's default low latency. */
+  double inputLatencyMs = 0.0;
+  double outputLatencyMs = 0.0;
   bool tryExclusiveMode = true;
+  OutputRelease outputRelease = OutputRelease::kCushioned;
+
+  /*
+   * Restart policy. Xruns are counted and reported, not restarted on:
+   * a full restart costs hundreds of ms of silence, far worse than the
+   * glitch it would answer. Streams are reopened only when the device
+   * looks lost -- a stream no longer active, or a callback that has not
+   * run for starvationTimeoutMs -- or, if enabled, when xruns arrive
+   * faster than xrunRestartCount per xrunWindowMs (0 = never).
+   */
+  uint32_t starvationTimeoutMs = 500;
+  uint32_t xrunRestartCount = 0;
+  uint32_t xrunWindowMs = 1000;
+
+  /*
+   * Backlog bound. When the processing thread falls behind (a stall, a
+   * slow frame), captureRing_ fills and every waiting frame is latency.
+   * Past maxBacklogFrames waiting frames (raised to cover one host
+   * buffer), overflowPolicy decides how to get back to one frame.
+   */
+  OverflowPolicy overflowPolicy = OverflowPolicy::kCatchUp;
+  uint32_t maxBacklogFrames = 3;
+
+  /*
+   * Output underrun handling: conceal the shortfall from recent output
+   * (see concealment.h) instead of playing hard zeros.
+   */
+  bool concealUnderruns = true;
+
+  /*
+   * CPU governor (see cpu_governor.h): under load, step down through the
+   * QualityTiers no further than governorFloor; kFull turns shedding off
+   * (the load is still measured).
+   */
+  QualityTier governorFloor = QualityTier::kLittleModel;
+
+  /*
+   * Stage-pipelined processing (see rnnoise_pipeline.h): pass 1 and
+   * pass 2 on their own threads, the post-filters on the processing
+   * thread. For chains too heavy to finish within one frame period on one
+   * core; costs about one frame of latency, so the deadline budget grows
+   * by a frame period.
+   */
+  bool pipelined = false;
 };
 
+/**
+ * Where the last start() spent its time (microseconds). The RNNoise
+ * states are built while the streams open, so rnnoiseUs and openUs
+ * overlap. firstFrameUs is 0 until the first frame has been processed.
+ */
+struct StartupTiming {
+  uint32_t sessionUs = 0;     /* Pa_Initialize (0 when the session was already up) */
+  uint32_t rnnoiseUs = 0;     /* DenoiseState creation + prewarm */
+  uint32_t openUs = 0;        /* Opening the PortAudio streams */
+  uint32_t startUs = 0;       /* start() entry -> return */
+  uint32_t firstFrameUs = 0;  /* start() entry -> first processed frame */
+};
+
+/* Anomaly kinds (bits of AnomalyRecord::kinds). */
+static constexpr uint32_t kAnomalyDeadlineMiss = 1u << 0;     /* Frame done after its deadline */
+static constexpr uint32_t kAnomalyCaptureOverflow = 1u << 1;  /* captureRing_ full: input dropped */
+static constexpr uint32_t kAnomalyOutputUnderrun = 1u << 2;   /* outputRing_ empty: silence played */
+static constexpr uint32_t kAnomalyXrun = 1u << 3;             /* PortAudio status flags raised */
+static constexpr uint32_t kAnomalyBacklogTrim = 1u << 4;      /* Backlog cut by the overflow policy */
+static constexpr uint32_t kAnomalyTierChange = 1u << 5;       /* CPU governor changed the quality tier */
+
+/**
+ * One entry of the anomaly log: what went wrong around one processed
+ * frame, and the pipeline state at that moment. POD, written by the
+ * processing thread only. Counts cover the interval since the previous
+ * record; times are microseconds since start().
+ */
+struct AnomalyRecord {
+  uint64_t timeUs;           /* When the record was written */
+  uint64_t framesProcessed;  /* Frame counter at that time */
+  uint32_t kinds;            /* kAnomaly* bits */
+  uint32_t paStatusFlags;    /* paInput/OutputUnderflow/Overflow bits seen */
+  uint32_t latencyUs;        /* Last frame: capture arrival -> processed */
+  uint32_t processUs;        /* Last frame: processFrame() time */
+  uint32_t droppedSamples;   /* Capture samples the full ring rejected */
+  uint32_t underrunSamples;  /* Output samples played as silence */
+  uint32_t captureFill;      /* captureRing_ samples waiting */
+  uint32_t outputFill;       /* outputRing_ samples waiting */
+  uint32_t trimmedSamples;   /* Capture samples skipped by the overflow policy */
+  uint32_t catchUpFrames;    /* Backlog frames processed but not emitted */
+  uint32_t qualityTier;      /* QualityTier in force after this frame */
+  uint32_t loadPermille;     /* Governor's smoothed processing load, x1000 */
+};
+
+/** Per-frame deadline tracking since the last start(). */
+struct DeadlineStats {
+  uint64_t framesTimed = 0;
+  uint64_t misses = 0;          /* Frames processed after their deadline */
+  uint64_t anomalies = 0;       /* Records written (the log keeps the last kAnomalyLogSize) */
+  uint32_t budgetUs = 0;        /* Deadline: one frame period after arrival (two pipelined) */
+  uint32_t lastLatencyUs = 0;
+  uint32_t worstLatencyUs = 0;
+  uint64_t underrunSamples = 0; /* Output samples the ring could not supply */
+  uint64_t trimmedFrames = 0;   /* Backlog frames skipped unprocessed */
+  uint64_t catchUpFrames = 0;   /* Backlog frames processed but not emitted */
+};
+
+/**
+ * Where the time goes from microphone to output, in milliseconds. Device
+ * figures are PortAudio's reported stream latencies (they include the
+ * host buffers); the rest is the engine's own buffering, measured now.
+ */
+struct LatencyBudget {
+  double inputDeviceMs = 0.0;    /* Pa_GetStreamInfo()->inputLatency */
+  double frameAssemblyMs = 0.0;  /* Gathering 480-sample frames from host blocks (average) */
+  double processingMs = 0.0;     /* Frame complete -> processed (last frame, incl. queueing) */
+  double modelDelayMs = 0.0;     /* RNNoise delays one frame per pass; two passes in series */
+  double outputQueueMs = 0.0;    /* outputRing_ fill */
+  double outputDeviceMs = 0.0;   /* Pa_GetStreamInfo()->outputLatency */
+  double totalMs = 0.0;
+  uint32_t captureBlock = 0;     /* Samples per capture callback (last seen) */
+  uint32_t outputBlock = 0;      /* Samples per output callback (last seen) */
+  uint32_t outputCushion = 0;    /* OutputRelease::kCushioned target, samples */
+};
+
+/** CPU governor state (see cpu_governor.h). */
+struct GovernorStats {
+  QualityTier tier = QualityTier::kFull;
+  QualityTier floor = QualityTier::kFull;
+  float load = 0.0f;              /* Smoothed processFrame() time / frame period */
+  uint64_t stepsDown = 0;         /* Since start() */
+  uint64_t stepsUp = 0;
+  uint32_t headroomWaitFrames = 0;  /* Current wait before the next step up */
+};
+
+/**
+ * Callback regularity: how far each callback's interval strays from its
+ * block's duration (|interval - frameCount / sampleRate|), per stream.
+ * A stray near a full period is a near-xrun. Used to auto-tune buffer
+ * sizes per device.
+ */
+struct CallbackTiming {
+  uint64_t captureCallbacks = 0;  /* Intervals measured */
+  double captureJitterMeanUs = 0.0;
+  uint32_t captureJitterMaxUs = 0;
+  uint64_t outputCallbacks = 0;
+  double outputJitterMeanUs = 0.0;
+  uint32_t outputJitterMaxUs = 0;
+};
+
+/* Records kept by the anomaly log (~the last minute of a bad session). */
+static constexpr size_t kAnomalyLogSize = 256;
+
+/** Kinds of engine status events. */
+enum class StatusEventType : uint32_t {
+  kRestartBegin,      /* Device issue detected, restart starting */
+  kRestartSucceeded,  /* Streams reopened after `attempt` tries */
+  kRestartFailed,     /* Gave up after `attempt` tries */
+  kXrun,              /* PortAudio reported under/overflow (`xrunFlags`) */
+};
+
+/** Why the engine decided to reopen its streams. */
+enum class RestartReason : uint32_t {
+  kNone,
+  kStreamInactive,  /* Pa_IsStreamActive() no longer reports the stream running */
+  kCaptureStarved,  /* No capture callback for starvationTimeoutMs */
+  kOutputStarved,   /* No output callback for starvationTimeoutMs */
+  kXrunStorm,       /* xrunRestartCount xruns within xrunWindowMs */
+};
+
+/** Xruns by kind and restarts, since the engine was created. */
+struct XrunStats {
+  uint64_t inputUnderflow = 0;
+  uint64_t inputOverflow = 0;
+  uint64_t outputUnderflow = 0;
+  uint64_t outputOverflow = 0;
+  uint64_t restarts = 0;  /* Restarts begun */
+  RestartReason lastRestartReason = RestartReason::kNone;
+};
+
+/**
+ * Fixed-size POD status record. Built on the processing thread without
+ * allocating; turned into text only on the event thread.
+ */
+struct StatusEvent {
+  StatusEventType type;
+  uint32_t attempt;          /* Restart attempt count (restart events) */
+  uint32_t xrunFlags;        /* paInput/OutputUnderflow/Overflow bits (kXrun) */
+  RestartReason reason;      /* Why the restart began (kRestartBegin) */
+  uint64_t framesProcessed;  /* Frame counter when the event was raised */
+};
+
+/** Human-readable description of a status event. NOT real-time safe. */
+std::string describeStatusEvent(const StatusEvent& event);
+
 /**
  * Callback for engine status changes (e.g., device disconnected, restarted).
- * Called from the processing thread -- keep it lightweight.
+ * Called from the engine's event thread, never from an audio thread.
  */
-using StatusCallback = std::function<void(const std::string& status)>;
+using StatusCallback =
+    std::function<void(const StatusEvent& event, const std::string& status)>;
 
 class AudioEngine {
  public:
@@ -67,17 +297,28 @@ class AudioEngine {
   AudioEngine(const AudioEngine&) = delete;
   AudioEngine& operator=(const AudioEngine&) = delete;
 
-  /** Enumerate all available audio devices. Safe to call anytime. */
-  static std::vector<DeviceInfo> enumerateDevices();
+  /**
+   * Enumerate all available audio devices, opening the PortAudio session
+   * on first use and leaving it open for the next start(). With refresh
+   * set and the engine stopped, the session is re-opened first to pick up
+   * hot-plugged devices (a full Pa_Terminate()/Pa_Initialize()); otherwise
+   * the list is the one PortAudio took when the session opened.
+   */
+  std::vector<DeviceInfo> enumerateDevices(bool refresh = false);
 
   /**
    * Start the audio engine with given configuration.
-   * Opens PortAudio streams and launches the processing thread.
-   * Returns empty string on success, or an error message.
+   * Opens PortAudio streams (initializing PortAudio on first use), builds
+   * and prewarms the RNNoise states alongside, and launches the
+   * processing thread. Returns empty string on success, or an error
+   * message.
    */
   std::string start(const AudioConfig& config);
 
-  /** Stop the audio engine. Blocks until processing thread exits. */
+  /**
+   * Stop the audio engine. Blocks until processing thread exits. The
+   * PortAudio session and ring buffers are kept for a fast restart.
+   */
   void stop();
 
   /** Check if the engine is currently running. */
@@ -96,6 +337,88 @@ class AudioEngine {
   void setVadThreshold(float threshold);
   float getVadThreshold() const;
 
+  /** Select when the residual RNNoise pass runs. Thread-safe. */
+  void setSecondPassMode(SecondPassMode mode);
+  SecondPassMode getSecondPassMode() const;
+
+  /**
+   * Select the post-RNNoise stages and their order (see stage_chain.h).
+   * Thread-safe; applied at the next frame boundary.
+   */
+  void setStagePlan(const StagePlan& plan);
+  StagePlan getStagePlan() const;
+
+  /**
+   * Replace the filter-bank sections (see filter_bank.h; EQ and hum
+   * notches, designed for 48 kHz). Applied at the next frame boundary
+   * while running, from the first frame otherwise. Returns empty string
+   * on success, or an error message (the previous bank stays).
+   */
+  std::string setFilterBank(const std::vector<FilterSpec>& specs);
+  std::vector<FilterSpec> getFilterBank() const;
+
+  /**
+   * Stage a saved calibration for the next start() (see Calibration in
+   * rnnoise_wrapper.h). Returns false when the engine is running or a
+   * value is out of range.
+   */
+  bool setCalibration(const Calibration& c);
+
+  /**
+   * Calibration captured by the last stop(). Returns false if the engine
+   * has not been stopped since it was created.
+   */
+  bool getCalibration(Calibration* out) const;
+
+  /** Select the inference tier (standard / little). Thread-safe, glitch-free. */
+  void setModelTier(ModelTier tier);
+  ModelTier getModelTier() const;
+
+  /**
+   * Select the RNNoise model file for a tier ("" = built-in model for
+   * kStandard, none for kLittle). The file is parsed once and its weights
+   * shared (see rnnoise_model.h). While running, the model is hot-swapped
+   * without stopping: the new states are built on the CALLING thread and
+   * crossfaded in by the processing thread (call from a worker thread, not
+   * the UI thread). Returns empty string on success, or an error message
+   * (the previous model stays selected).
+   */
+  std::string setModelPath(const std::string& path,
+                           ModelTier tier = ModelTier::kStandard);
+  std::string getModelPath(ModelTier tier = ModelTier::kStandard) const;
+
+  /** Timing of the last start() (firstFrameUs fills in once processing begins). */
+  StartupTiming startupTiming() const;
+
+  /** Xrun and restart counters (lock-free). */
+  XrunStats xrunStats() const;
+
+  /** Deadline counters since the last start() (lock-free). */
+  DeadlineStats deadlineStats() const;
+
+  /** Mic-to-output latency breakdown of the running engine (lock-free). */
+  LatencyBudget latencyBudget() const;
+
+  /** CPU governor tier, load and steps since start() (lock-free). */
+  GovernorStats governorStats() const;
+
+  /** Per-stage queue depths of the pipelined mode (running = false when off). */
+  PipelineStats pipelineStats() const { return pipeline_.stats(); }
+
+  /**
+   * Callback jitter since start() or the last resetCallbackTiming()
+   * (lock-free; a reset racing a callback may keep that one interval).
+   */
+  CallbackTiming callbackTiming() const;
+  void resetCallbackTiming();
+
+  /**
+   * The most recent anomaly records (at most kAnomalyLogSize), oldest
+   * first. Lock-free against the processing thread; kept after stop()
+   * until the next start(). NOT real-time safe (allocates).
+   */
+  std::vector<AnomalyRecord> anomalyLog() const { return anomalyLog_.snapshot(); }
+
   /** Access real-time metrics from the RNNoise wrapper (lock-free). */
   const AudioMetrics& metrics() const { return rnnoise_.metrics(); }
 
@@ -123,8 +446,58 @@ class AudioEngine {
   /** Processing thread entry point. Reads capture -> RNNoise -> output ring. */
   void processingLoop();
 
+  /**
+   * Device health check (processing thread, every kHealthCheckMs): does
+   * the device look lost, and why. See DEVICE HEALTH in the .cpp.
+   */
+  RestartReason checkDeviceHealth(std::chrono::steady_clock::time_point now);
+
+  /** Forget health history (after start / restart). */
+  void resetDeviceHealth(std::chrono::steady_clock::time_point now);
+
   /** Attempt to restart audio after a device disconnect. */
-  void attemptRestart();
+  void attemptRestart(RestartReason reason);
+
+  /**
+   * Deadline check for the frame that ends at capture sample `frameEnd`,
+   * finished at `done` after `processUs` of processing (the slowest
+   * stage's share when pipelined). Returns true on a miss. Processing
+   * thread.
+   */
+  bool timeFrame(uint32_t frameEnd, uint32_t processUs,
+                 std::chrono::steady_clock::time_point done);
+
+  /** Queue a processed frame for output, fading it in after a splice. */
+  void emitFrame(float* frame, bool fadeIn);
+
+  /**
+   * Collect the callbacks' overflow / underrun counts and write an anomaly
+   * record if anything was flagged. Processing thread.
+   */
+  void recordAnomalies(uint32_t kinds, uint32_t paStatusFlags);
+
+  /**
+   * Account the frame just processed with the CPU governor and apply its
+   * tier. Returns true when the tier changed. Processing thread.
+   */
+  bool updateGovernor();
+
+  /**
+   * Apply backlog_ to the capture ring before the next read and follow its
+   * catch-up state with the RNNoise tier. Returns true when frames were
+   * skipped. Processing thread.
+   */
+  bool boundBacklog(uint32_t* readPos);
+
+  /** Queue a status event. REAL-TIME SAFE: drops the event if the queue is full. */
+  void postEvent(StatusEventType type, uint32_t attempt = 0, uint32_t xrunFlags = 0,
+                 RestartReason reason = RestartReason::kNone);
+
+  /** Event thread entry point. Drains eventQueue_ into statusCallback_. */
+  void eventLoop();
+
+  /** Deliver every queued event to the status callback. */
+  void drainEvents();
 
   /** Open PortAudio streams with current config_. */
   std::string openStreams();
@@ -132,22 +505,133 @@ class AudioEngine {
   /** Close PortAudio streams. */
   void closeStreams();
 
+  /** Pa_Initialize() unless the session is already open. */
+  std::string openSession();
+
+  /** Pa_Terminate() if the session is open. */
+  void closeSession();
+
+  /** Destroy rnnoise_'s states when start() fails after creating them. */
+  void releaseRnnoise();
+
   /* State */
   std::atomic<bool> running_{false};
-  std::atomic<bool> shouldRestart_{false};
   AudioConfig config_;
+  bool paSession_ = false;  /* Pa_Initialize() done, Pa_Terminate() pending */
+
+  /* Startup timing (startTiming_ written by start() and its init thread). */
+  std::chrono::steady_clock::time_point startTime_;
+  StartupTiming startTiming_;
+  std::atomic<uint32_t> firstFrameUs_{0};  /* Set by the processing thread */
+
+  /* Status events: processing thread -> queue -> event thread -> callback. */
+  SpscQueue<StatusEvent, 64> eventQueue_;
+  std::atomic<uint32_t> pendingXrunFlags_{0};  /* OR-ed in by the callbacks */
+  std::atomic<uint64_t> droppedEvents_{0};
+  std::mutex callbackMutex_;                   /* Guards statusCallback_ (non-RT only) */
   StatusCallback statusCallback_;
+  std::thread eventThread_;
+
+  /*
+   * Deadline watchdog and anomaly log. The capture callback publishes
+   * (arrival time, samples written) as one word so the processing thread
+   * can date the frame it reads; callbacks only bump counters, and the
+   * processing thread alone writes anomaly records.
+   */
+  std::atomic<uint64_t> captureClock_{0};      /* (µs since start << 32) | samples written, both mod 2^32 */
+  std::atomic<uint32_t> droppedSamples_{0};    /* Capture overflow, since the last record */
+  std::atomic<uint32_t> underrunSamples_{0};   /* Output underrun, since the last record */
+  std::atomic<bool> outputPrimed_{false};      /* First processed frame reached outputRing_ */
+  std::atomic<uint64_t> underrunTotal_{0};     /* Output underrun, since start() */
+  UnderrunConcealer concealer_;                /* Output callback only */
+  bool outputHolding_ = true;                  /* kCushioned: building the cushion (output callback) */
+  bool outputStarted_ = false;                 /* kCushioned: first cushion reached (output callback) */
+
+  /* Latency budget inputs: stream latencies (openStreams) and block sizes (callbacks). */
+  std::atomic<uint32_t> inputLatencyUs_{0};
+  std::atomic<uint32_t> outputLatencyUs_{0};
+  std::atomic<uint32_t> captureBlock_{0};
+  std::atomic<uint32_t> outputBlock_{0};
+  std::atomic<uint32_t> outputCushion_{0};
+
+  /*
+   * Callback jitter (see CallbackTiming). Each stream's accumulators are
+   * written by its own callback; lastCaptureUs_ / lastOutputUs_ (µs since
+   * start, 0 = none yet) by that callback too, or by a reset.
+   */
+  struct JitterStats {
+    std::atomic<uint32_t> lastUs{0};
+    std::atomic<uint64_t> count{0};
+    std::atomic<uint64_t> sumUs{0};
+    std::atomic<uint32_t> maxUs{0};
+
+    void reset();
+    /* REAL-TIME SAFE. */
+    void record(uint32_t nowUs, unsigned long frameCount, double sampleRate);
+  };
+  JitterStats captureJitter_;
+  JitterStats outputJitter_;
+  uint32_t framePeriodUs_ = 10000;             /* Frame period for config_.sampleRate */
+  uint32_t deadlineBudgetUs_ = 10000;          /* Arrival -> done allowance (pipelined: two periods) */
+  std::atomic<uint64_t> framesTimed_{0};
+  std::atomic<uint64_t> deadlineMisses_{0};
+  std::atomic<uint32_t> lastLatencyUs_{0};
+  std::atomic<uint32_t> worstLatencyUs_{0};
+  uint32_t lastProcessUs_ = 0;                 /* Processing thread only (pipelined: slowest stage) */
+  HistoryRing<AnomalyRecord, kAnomalyLogSize> anomalyLog_;
+
+  /* Backlog bound (see OverflowPolicy). Counters processing thread -> readers. */
+  BacklogBound backlog_;                       /* Processing thread; configured at start() */
+  size_t hostFrames_ = 1;                      /* Frames one host buffer can land at once */
+  uint32_t trimmedSince_ = 0;                  /* Samples skipped, since the last record */
+  uint32_t catchUpSince_ = 0;                  /* Frames not emitted, since the last record */
+  std::atomic<uint64_t> trimmedFrames_{0};
+  std::atomic<uint64_t> catchUpFrames_{0};
+
+  /* CPU governor (processing thread) and what it publishes for readers. */
+  CpuGovernor governor_;
+  std::atomic<float> governorLoad_{0.0f};
+  std::atomic<uint64_t> governorStepsDown_{0};
+  std::atomic<uint64_t> governorStepsUp_{0};
+  std::atomic<uint32_t> governorWait_{0};
+
+  /*
+   * Xrun counters (indexed by flag bit: input underflow, input overflow,
+   * output underflow, output overflow) and callback heartbeats, bumped by
+   * the callbacks; restart bookkeeping for the processing thread.
+   */
+  std::atomic<uint64_t> xrunCounts_[4] = {};
+  std::atomic<uint64_t> captureCallbacks_{0};
+  std::atomic<uint64_t> outputCallbacks_{0};
+  std::atomic<uint64_t> restarts_{0};
+  std::atomic<uint32_t> lastRestartReason_{0};
+  struct DeviceHealth {
+    std::chrono::steady_clock::time_point lastCheck;
+    std::chrono::steady_clock::time_point captureSeen;  /* Heartbeat last moved */
+    std::chrono::steady_clock::time_point outputSeen;
+    uint64_t captureBeats = 0;
+    uint64_t outputBeats = 0;
+    std::chrono::steady_clock::time_point windowStart;  /* Xrun storm window */
+    uint64_t windowXruns = 0;                           /* Xrun total at windowStart */
+  } health_;                                            /* Processing thread only */
 
   /* PortAudio streams */
   PaStream* captureStream_ = nullptr;
   PaStream* outputStream_ = nullptr;
 
-  /* Lock-free ring buffers (allocated once in start(), not in callbacks) */
+  /* Lock-free ring buffers (allocated by the first start(), never in callbacks) */
   std::unique_ptr<RingBuffer> captureRing_;
   std::unique_ptr<RingBuffer> outputRing_;
 
-  /* RNNoise processor */
+  /* RNNoise processor, and its stage pipeline when config_.pipelined */
   RNNoiseWrapper rnnoise_;
+  RNNoisePipeline pipeline_;
+  mutable std::mutex modelMutex_;  /* Guards the model slots + rnnoise_ init/destroy/swap */
+  std::shared_ptr<const RNNoiseModel> model_;        /* nullptr = built-in */
+  std::shared_ptr<const RNNoiseModel> littleModel_;  /* nullptr = none */
+  bool rnnoiseLive_ = false;      /* rnnoise_ has states: start()'s init() to stop() (guarded by modelMutex_) */
+  Calibration lastCalibration_;   /* Captured by stop() (guarded by modelMutex_) */
+  bool hasCalibration_ = false;
 
   /* Processing thread */
   std::thread processingThread_;
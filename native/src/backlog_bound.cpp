@@ -0,0 +1,57 @@
+/**
+ * Capture backlog bound. See backlog_bound.h.
+ */
+
+#include "backlog_bound.h"
+
+namespace ainoiceguard {
+
+void BacklogBound::configure(OverflowPolicy policy, size_t limitFrames, size_t frameSamples) {
+  policy_ = policy;
+  limitFrames_ = limitFrames;
+  frameSamples_ = frameSamples;
+  catchUpPending_ = 0;
+}
+
+/*
+ * kCatchUp processes the backlog on the cheap tier and discards its
+ * output, so RNNoise, the gate and the filters see continuous input and
+ * the splice lands on settled state. If the backlog still grows to within
+ * a frame of the ring's capacity, it is cut as in kDropOldest before the
+ * capture callback has to drop new input.
+ */
+size_t BacklogBound::apply(RingBuffer& ring) {
+  if (policy_ == OverflowPolicy::kDropNewest) return 0;
+
+  const size_t frames = ring.available_read() / frameSamples_;
+  const size_t hardLimit = (ring.capacity() - 1) / frameSamples_ - 1;
+  if (frames <= limitFrames_) return 0;
+  if (policy_ == OverflowPolicy::kCatchUp && frames < hardLimit) {
+    if (catchUpPending_ == 0) catchUpPending_ = frames - 1;
+    return 0;
+  }
+
+  /* Whole frames, so the stream stays frame-aligned. */
+  catchUpPending_ = 0;
+  return ring.discard((frames - 1) * frameSamples_);
+}
+
+/*
+ * A catch-up runs the stalled frames back to back, so the ring stays above
+ * the host buffer's share for several frames after one stall. Reported to
+ * the CPU governor as a backlog, that alone would step the tier down;
+ * sustained overload still shows in the processing load, and a backlog
+ * that keeps growing ends the catch-up in apply().
+ */
+size_t BacklogBound::pressureFrames(const RingBuffer& ring) const {
+  if (catchUpPending_ > 0) return 0;
+  return ring.available_read() / frameSamples_;
+}
+
+bool BacklogBound::takeCatchUpFrame() {
+  if (catchUpPending_ == 0) return false;
+  catchUpPending_--;
+  return true;
+}
+
+}  // namespace ainoiceguard
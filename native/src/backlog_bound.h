@@ -0,0 +1,83 @@
+/**
+ * Capture backlog bound: what the processing thread does when it has
+ * fallen behind the capture callback.
+ *
+ * Every frame waiting in the capture ring is 10 ms of latency that
+ * processing alone never wins back: after a stall the thread works
+ * through the backlog at one frame per frame period at best, and the
+ * output ring simply inherits it. Getting back to one frame of latency
+ * means some audio is never played; the policies differ in what the DSP
+ * sees. apply() runs before each frame is read, takeCatchUpFrame() after.
+ *
+ * REAL-TIME RULES: allocation-free, fixed cost. One thread only (the
+ * processing thread, the capture ring's reader).
+ */
+
+#ifndef AINOICEGUARD_BACKLOG_BOUND_H
+#define AINOICEGUARD_BACKLOG_BOUND_H
+
+#include <cstddef>
+#include <cstdint>
+
+#include "ringbuffer.h"
+
+namespace ainoiceguard {
+
+/**
+ * What the processing thread does with a capture backlog.
+ *   kDropNewest -- nothing: once captureRing_ is full the capture callback
+ *                  rejects new input and the backlog latency stays
+ *                  (the original behavior).
+ *   kDropOldest -- skip the oldest whole frames, keeping the newest.
+ *   kCatchUp    -- run the backlog through the cheap tier (no residual
+ *                  pass) and emit only the newest frame, so the DSP state
+ *                  sees continuous audio; falls back to kDropOldest if the
+ *                  backlog keeps growing.
+ */
+enum class OverflowPolicy : uint32_t {
+  kDropNewest,
+  kDropOldest,
+  kCatchUp,
+};
+
+class BacklogBound {
+ public:
+  /**
+   * Act on more than `limitFrames` waiting frames of `frameSamples`
+   * samples each. Cancels a catch-up in progress.
+   */
+  void configure(OverflowPolicy policy, size_t limitFrames, size_t frameSamples);
+
+  /**
+   * Bound the backlog waiting in `ring`, before the next frame is read:
+   *   - kDropOldest discards all but the newest frame;
+   *   - kCatchUp marks all but the newest frame as catch-up frames, or
+   *     discards like kDropOldest once the backlog reaches the ring's
+   *     last frame (ending the catch-up);
+   *   - kDropNewest does nothing.
+   * Returns the samples discarded (whole frames; 0 = none).
+   */
+  size_t apply(RingBuffer& ring);
+
+  /** After each frame read: true if it is a catch-up frame (process, do not emit). */
+  bool takeCatchUpFrame();
+
+  /** Catch-up frames still to read (0 = not catching up). */
+  size_t catchUpPending() const { return catchUpPending_; }
+
+  /**
+   * Frames waiting in `ring` that count as CPU pressure: all of them, or
+   * none while a catch-up is working the backlog off on purpose.
+   */
+  size_t pressureFrames(const RingBuffer& ring) const;
+
+ private:
+  OverflowPolicy policy_ = OverflowPolicy::kCatchUp;
+  size_t limitFrames_ = 3;
+  size_t frameSamples_ = 1;
+  size_t catchUpPending_ = 0;
+};
+
+}  // namespace ainoiceguard
+
+#endif  // AINOICEGUARD_BACKLOG_BOUND_H
@@ -0,0 +1,155 @@
+/**
+ * Output underrun concealment. See concealment.h.
+ */
+
+#include "concealment.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+
+namespace ainoiceguard {
+
+/* Decimation for the coarse pitch search (48 kHz -> 12 kHz). */
+static constexpr size_t kDecimate = 4;
+
+/* Coarse correlation window: the newest 64 decimated samples (~5 ms). */
+static constexpr size_t kCoarseWindow = 64;
+
+/* Full-rate refinement: +/- one decimation step over the newest 256 samples. */
+static constexpr size_t kFineWindow = 256;
+
+/*
+ * Prefer the shortest lag within this share of the best correlation: a
+ * multiple of the period correlates almost as well, and repeating two
+ * periods halves the perceived pitch.
+ */
+static constexpr float kSubharmonicShare = 0.9f;
+
+void UnderrunConcealer::reset() {
+  std::memset(history_, 0, sizeof(history_));
+  written_ = 0;
+  concealing_ = false;
+  period_ = kMaxPeriod;
+  base_ = 0;
+  pos_ = 0;
+  last_ = 0.0f;
+  noise_.reset();
+}
+
+void UnderrunConcealer::process(float* out, size_t valid, size_t n) {
+  size_t i = 0;
+
+  /* Real audio is back: crossfade out of the running concealment. */
+  if (concealing_ && valid > 0) {
+    const size_t m = std::min(valid, kSpliceSamples);
+    const float step = 1.0f / static_cast<float>(m + 1);
+    for (; i < m; i++) {
+      float w = static_cast<float>(i + 1) * step;
+      out[i] = out[i] * w + next() * (1.0f - w);
+    }
+    concealing_ = false;
+  }
+
+  for (size_t k = 0; k < valid; k++) history_[(written_ + k) & kMask] = out[k];
+  written_ += valid;
+
+  if (valid < n) {
+    if (!concealing_) begin();
+    for (size_t k = valid; k < n; k++) out[k] = next();
+  }
+}
+
+/*
+ * Pitch period of the newest history: normalized autocorrelation on the
+ * decimated signal over [kMinPeriod, kMaxPeriod], then refined at full
+ * rate around the winner. Sets up the repetition and its envelope.
+ */
+void UnderrunConcealer::begin() {
+  concealing_ = true;
+  pos_ = 0;
+  last_ = history_[(written_ - 1) & kMask];
+
+  constexpr size_t kDec = kHistory / kDecimate;
+  float dec[kDec];
+  const size_t oldest = written_ - kHistory;  /* Wraps harmlessly (masked) */
+  for (size_t j = 0; j < kDec; j++) {
+    float sum = 0.0f;
+    for (size_t k = 0; k < kDecimate; k++) {
+      sum += history_[(oldest + j * kDecimate + k) & kMask];
+    }
+    dec[j] = sum;
+  }
+
+  const size_t end = kDec - kCoarseWindow;
+  float xx = 0.0f;
+  for (size_t k = 0; k < kCoarseWindow; k++) xx += dec[end + k] * dec[end + k];
+
+  float corr[kMaxPeriod / kDecimate + 1] = {};
+  float best = 0.0f;
+  for (size_t lag = kMinPeriod / kDecimate; lag <= kMaxPeriod / kDecimate; lag++) {
+    float xy = 0.0f, yy = 0.0f;
+    for (size_t k = 0; k < kCoarseWindow; k++) {
+      float y = dec[end + k - lag];
+      xy += dec[end + k] * y;
+      yy += y * y;
+    }
+    corr[lag] = (xx > 0.0f && yy > 0.0f) ? xy / std::sqrt(xx * yy) : 0.0f;
+    best = std::max(best, corr[lag]);
+  }
+  size_t coarse = kMaxPeriod / kDecimate;
+  for (size_t lag = kMinPeriod / kDecimate; lag <= kMaxPeriod / kDecimate; lag++) {
+    if (best > 0.0f && corr[lag] >= kSubharmonicShare * best) {
+      coarse = lag;
+      break;
+    }
+  }
+  /* Climb from the threshold crossing to that lag's peak. */
+  while (coarse < kMaxPeriod / kDecimate && corr[coarse + 1] > corr[coarse]) coarse++;
+
+  /* Refine to the sample: the join sits exactly one period after base_. */
+  const size_t lo = std::max(kMinPeriod, coarse * kDecimate - (kDecimate - 1));
+  const size_t hi = std::min(kMaxPeriod, coarse * kDecimate + (kDecimate - 1));
+  float bestFine = -1.0f;
+  period_ = coarse * kDecimate;
+  for (size_t lag = lo; lag <= hi; lag++) {
+    float xy = 0.0f, yy = 0.0f;
+    for (size_t k = 0; k < kFineWindow; k++) {
+      size_t at = written_ - kFineWindow + k;
+      float y = history_[(at - lag) & kMask];
+      xy += history_[at & kMask] * y;
+      yy += y * y;
+    }
+    float c = yy > 0.0f ? xy / std::sqrt(yy) : 0.0f;
+    if (c > bestFine) {
+      bestFine = c;
+      period_ = lag;
+    }
+  }
+
+  base_ = written_ - period_;
+  const bool voiced = best >= kVoicedCorrelation;
+  hold_ = voiced ? kHoldSamples : 0;
+  fade_ = voiced ? kFadeSamples : kHoldSamples;
+}
+
+float UnderrunConcealer::next() {
+  float x = history_[(base_ + pos_ % period_) & kMask];
+  if (pos_ < kEntrySamples) {
+    float w = static_cast<float>(pos_ + 1) / static_cast<float>(kEntrySamples + 1);
+    x = last_ * (1.0f - w) + x * w;
+  }
+
+  float g;
+  if (pos_ < hold_) {
+    g = 1.0f;
+  } else if (pos_ < hold_ + fade_) {
+    g = 1.0f - static_cast<float>(pos_ - hold_) / static_cast<float>(fade_);
+  } else {
+    g = 0.0f;
+  }
+  if (pos_ < hold_ + fade_) pos_++;  /* Saturates: long gaps stay on noise */
+  return x * g + noise_.sample() * (1.0f - g);
+}
+
+}  // namespace ainoiceguard
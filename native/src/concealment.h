@@ -0,0 +1,101 @@
+/**
+ * Output underrun concealment (packet-loss concealment for the playback
+ * side).
+ *
+ * When outputRing_ runs dry, hard zeros cut the waveform mid-cycle: an
+ * audible click on the way out and another on the way back. The
+ * concealer instead keeps the last kHistory emitted samples and, on an
+ * underrun, repeats the most recent pitch period (found by normalized
+ * autocorrelation on a 4x decimated copy of the history), in the spirit of
+ * G.711 Appendix I:
+ *
+ *   - The first kHoldSamples play at full level, then the repetition
+ *     fades to comfort noise over kFadeSamples (faster for unvoiced
+ *     audio, where a repeated period buzzes). Long gaps end in the same
+ *     -70 dBFS noise the gate uses, not dead air.
+ *   - The first kEntrySamples ramp from the last real sample, hiding any
+ *     phase error at the join.
+ *   - When real samples return, the first kSpliceSamples crossfade from
+ *     the running concealment into them.
+ *
+ * Because a shortfall now costs a few ms of plausible audio instead of a
+ * click pair, the output side can run with a shallower buffer.
+ *
+ * REAL-TIME RULES: process() and reset() are allocation-free, fixed
+ * cost (the pitch search runs once per underrun, ~10k MACs). One thread
+ * only (the output callback).
+ */
+
+#ifndef AINOICEGUARD_CONCEALMENT_H
+#define AINOICEGUARD_CONCEALMENT_H
+
+#include <cstddef>
+
+#include "post_filter.h"
+
+namespace ainoiceguard {
+
+class UnderrunConcealer {
+ public:
+  /* Emitted-audio history (power of 2; ~21 ms at 48 kHz). */
+  static constexpr size_t kHistory = 1024;
+
+  /* Pitch search range: 2.5 ms .. 15 ms at 48 kHz (400 Hz .. 67 Hz). */
+  static constexpr size_t kMinPeriod = 120;
+  static constexpr size_t kMaxPeriod = 720;
+
+  /* Full-level repetition, then fade to comfort noise (10 ms + 40 ms). */
+  static constexpr size_t kHoldSamples = 480;
+  static constexpr size_t kFadeSamples = 1920;
+
+  /* Ramp from the last real sample into the repetition (~0.7 ms). */
+  static constexpr size_t kEntrySamples = 32;
+
+  /* Crossfade from concealment back to real audio (2 ms). */
+  static constexpr size_t kSpliceSamples = 96;
+
+  /*
+   * Below this normalized correlation the history is treated as unvoiced:
+   * no hold, and a fade over kHoldSamples only.
+   */
+  static constexpr float kVoicedCorrelation = 0.5f;
+
+  UnderrunConcealer() { reset(); }
+
+  /** Forget the history (start of a session). */
+  void reset();
+
+  /**
+   * out[0 .. valid) holds real samples from the ring; out[valid .. n) is
+   * a shortfall to fill. Splices the real part into a running concealment,
+   * conceals the rest, and records what was emitted.
+   */
+  void process(float* out, size_t valid, size_t n);
+
+  /** Inside a concealed stretch (the last call ended short). */
+  bool concealing() const { return concealing_; }
+
+  /** Period the current / last concealment repeats, in samples. */
+  size_t period() const { return period_; }
+
+ private:
+  static constexpr size_t kMask = kHistory - 1;
+
+  void begin();
+  float next();
+
+  float history_[kHistory];
+  size_t written_ = 0;     /* Samples recorded (history_ index = written_ & kMask) */
+  bool concealing_ = false;
+  size_t period_ = kMaxPeriod;
+  size_t base_ = 0;        /* History index of the repeated period's start */
+  size_t pos_ = 0;         /* Samples concealed in this stretch */
+  size_t hold_ = kHoldSamples;
+  size_t fade_ = kFadeSamples;
+  float last_ = 0.0f;      /* Last real sample before the stretch */
+  ComfortNoise noise_;
+};
+
+}  // namespace ainoiceguard
+
+#endif  // AINOICEGUARD_CONCEALMENT_H
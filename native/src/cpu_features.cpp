@@ -0,0 +1,98 @@
+/**
+ * CPU feature detection (CPUID + XGETBV on x86-64; compile-time on AArch64).
+ */
+
+#include "cpu_features.h"
+
+#include <cstdint>
+
+#if defined(__x86_64__) || defined(_M_X64)
+#define NG_ARCH_X86_64 1
+#if defined(_MSC_VER) && !defined(__clang__)
+#include <intrin.h>
+#else
+#include <cpuid.h>
+#endif
+#endif
+
+namespace ainoiceguard {
+
+namespace {
+
+#ifdef NG_ARCH_X86_64
+
+void cpuid(uint32_t leaf, uint32_t subleaf, uint32_t regs[4]) {
+#if defined(_MSC_VER) && !defined(__clang__)
+  int r[4];
+  __cpuidex(r, static_cast<int>(leaf), static_cast<int>(subleaf));
+  for (int i = 0; i < 4; i++) regs[i] = static_cast<uint32_t>(r[i]);
+#else
+  __cpuid_count(leaf, subleaf, regs[0], regs[1], regs[2], regs[3]);
+#endif
+}
+
+uint64_t xgetbv0() {
+#if defined(_MSC_VER) && !defined(__clang__)
+  return _xgetbv(0);
+#else
+  uint32_t lo, hi;
+  __asm__ volatile("xgetbv" : "=a"(lo), "=d"(hi) : "c"(0));
+  return (static_cast<uint64_t>(hi) << 32) | lo;
+#endif
+}
+
+#endif  // NG_ARCH_X86_64
+
+CpuFeatures detect() {
+  CpuFeatures f;
+
+#ifdef NG_ARCH_X86_64
+  f.sse2 = true;
+
+  uint32_t r[4];
+  cpuid(0, 0, r);
+  const uint32_t maxLeaf = r[0];
+
+  cpuid(1, 0, r);
+  const bool osxsave = (r[2] & (1u << 27)) != 0;
+  const bool avx = (r[2] & (1u << 28)) != 0;
+  f.fma = (r[2] & (1u << 12)) != 0;
+  if (!osxsave || !avx) {
+    f.fma = false;
+    return f;
+  }
+
+  /* OS must save YMM (XCR0 bits 1-2) and, for AVX-512, opmask/ZMM (5-7). */
+  const uint64_t xcr0 = xgetbv0();
+  const bool ymmOs = (xcr0 & 0x6) == 0x6;
+  const bool zmmOs = (xcr0 & 0xE6) == 0xE6;
+  if (!ymmOs) {
+    f.fma = false;
+    return f;
+  }
+
+  if (maxLeaf >= 7) {
+    cpuid(7, 0, r);
+    f.avx2 = (r[1] & (1u << 5)) != 0;
+    if (zmmOs) {
+      f.avx512f = (r[1] & (1u << 16)) != 0;
+      f.avx512bw = (r[1] & (1u << 30)) != 0;
+    }
+  }
+#endif
+
+#if defined(__aarch64__) || defined(_M_ARM64)
+  f.neon = true;
+#endif
+
+  return f;
+}
+
+}  // namespace
+
+const CpuFeatures& cpuFeatures() {
+  static const CpuFeatures features = detect();
+  return features;
+}
+
+}  // namespace ainoiceguard
@@ -0,0 +1,28 @@
+/**
+ * Host CPU feature detection for the runtime-dispatched kernel table
+ * (dsp_kernels) and the diagnostics report (dispatch_info).
+ *
+ * Detection runs once (first call) and accounts for OS support: AVX/AVX-512
+ * are reported only if the OS saves the wider register state (XCR0).
+ */
+
+#ifndef AINOICEGUARD_CPU_FEATURES_H
+#define AINOICEGUARD_CPU_FEATURES_H
+
+namespace ainoiceguard {
+
+struct CpuFeatures {
+  bool sse2 = false;  /* x86-64 baseline */
+  bool avx2 = false;
+  bool fma = false;
+  bool avx512f = false;
+  bool avx512bw = false;
+  bool neon = false;  /* AArch64 baseline */
+};
+
+/** Features of the running CPU. Detected on first call, then cached. */
+const CpuFeatures& cpuFeatures();
+
+}  // namespace ainoiceguard
+
+#endif  // AINOICEGUARD_CPU_FEATURES_H
@@ -0,0 +1,92 @@
+/**
+ * CPU budget governor. See cpu_governor.h.
+ */
+
+#include "cpu_governor.h"
+
+#include <algorithm>
+
+namespace ainoiceguard {
+
+/* Measured cost ratios are clamped to this range (noise on a busy host). */
+static constexpr float kMinCostRatio = 1.0f;
+static constexpr float kMaxCostRatio = 8.0f;
+
+/* "No step up yet": past any headroom wait, so it never counts as a bounce. */
+static constexpr uint32_t kNeverUp = CpuGovernor::kMaxHeadroomFrames + 1;
+
+void CpuGovernor::reset() {
+  tier_ = QualityTier::kFull;
+  load_ = 0.0f;
+  pressured_ = 0;
+  relaxed_ = 0;
+  settle_ = 0;
+  sinceUp_ = kNeverUp;
+  headroomWait_ = kHeadroomFrames;
+  loadBeforeStep_ = 0.0f;
+  measuring_ = false;
+  std::fill(costRatio_, costRatio_ + kTierCount, kMinCostRatio);
+  stepsDown_ = 0;
+  stepsUp_ = 0;
+}
+
+QualityTier CpuGovernor::update(uint32_t processUs, uint32_t budgetUs, size_t backlogFrames,
+                                size_t allowanceFrames) {
+  const float sample = budgetUs > 0
+      ? static_cast<float>(processUs) / static_cast<float>(budgetUs)
+      : 0.0f;
+  load_ += kLoadAlpha * (sample - load_);
+  if (sinceUp_ < kNeverUp) sinceUp_++;
+
+  /* Let a step take effect; then record what the step down saved. */
+  if (settle_ > 0) {
+    if (--settle_ == 0 && measuring_) {
+      const int t = static_cast<int>(tier_);
+      costRatio_[t] = std::clamp(loadBeforeStep_ / std::max(load_, 0.01f),
+                                 kMinCostRatio, kMaxCostRatio);
+      measuring_ = false;
+    }
+    return tier_;
+  }
+
+  const bool behind = backlogFrames > allowanceFrames;
+  const bool pressure = behind || load_ > kPressureLoad;
+  pressured_ = pressure ? pressured_ + 1 : 0;
+  if (pressured_ >= kPressureFrames && tier_ < floor_) {
+    /* Undoing a recent step up: wait longer before the next one. */
+    if (sinceUp_ < headroomWait_) {
+      headroomWait_ = std::min(headroomWait_ * 2, kMaxHeadroomFrames);
+    }
+    sinceUp_ = kNeverUp;
+    loadBeforeStep_ = load_;
+    measuring_ = true;
+    step(+1);
+    return tier_;
+  }
+
+  /* A step up that held for a full wait: back to the short wait. */
+  if (sinceUp_ == headroomWait_) headroomWait_ = kHeadroomFrames;
+
+  const bool headroom = tier_ != QualityTier::kFull && !pressure &&
+                        load_ * costRatio_[static_cast<int>(tier_)] < kHeadroomLoad;
+  relaxed_ = headroom ? relaxed_ + 1 : 0;
+  if (relaxed_ >= headroomWait_) {
+    step(-1);
+    sinceUp_ = 0;
+  }
+  return tier_;
+}
+
+void CpuGovernor::step(int delta) {
+  tier_ = static_cast<QualityTier>(static_cast<int>(tier_) + delta);
+  if (delta > 0) {
+    stepsDown_++;
+  } else {
+    stepsUp_++;
+  }
+  pressured_ = 0;
+  relaxed_ = 0;
+  settle_ = kSettleFrames;
+}
+
+}  // namespace ainoiceguard
@@ -0,0 +1,121 @@
+/**
+ * CPU budget governor: sheds processing cost under load, restores it when
+ * headroom returns.
+ *
+ * A frame has one frame period (10 ms) to get through processFrame().
+ * On a loaded machine it sometimes does not, the capture backlog grows
+ * and the output underruns. The governor watches each frame's processing
+ * time against that budget and the capture backlog, and walks the
+ * pipeline down through QualityTier one step at a time:
+ *
+ *   kFull         user settings
+ *   kSinglePass   + residual (second) RNNoise pass off
+ *   kLeanFilters  + filter bank and custom stages off
+ *   kLittleModel  + little model tier (single pass on the smaller model)
+ *
+ * Hysteresis, so it does not oscillate:
+ *   - Step down after kPressureFrames consecutive frames under pressure
+ *     (smoothed load above kPressureLoad, or a backlog beyond the host
+ *     buffer's share; the engine does not count a backlog its overflow
+ *     policy is catching up on).
+ *   - After any step, kSettleFrames pass before the next decision: the
+ *     model tier crossfade briefly runs both models.
+ *   - Step up only when the load PREDICTED for the richer tier (current
+ *     load x the cost ratio measured on the way down) stays below
+ *     kHeadroomLoad for the headroom wait. A step up that has to be undone
+ *     within one wait doubles the wait (up to kMaxHeadroomFrames); a wait
+ *     survived resets it.
+ *
+ * REAL-TIME RULES: update() is allocation-free, fixed cost. One thread
+ * only (the processing thread).
+ */
+
+#ifndef AINOICEGUARD_CPU_GOVERNOR_H
+#define AINOICEGUARD_CPU_GOVERNOR_H
+
+#include <cstddef>
+#include <cstdint>
+
+namespace ainoiceguard {
+
+/** Processing-cost tier; each level includes the savings of the ones above it. */
+enum class QualityTier : int {
+  kFull = 0,
+  kSinglePass = 1,
+  kLeanFilters = 2,
+  kLittleModel = 3,
+};
+
+class CpuGovernor {
+ public:
+  static constexpr int kTierCount = 4;
+
+  /* Smoothed processing time / frame budget that counts as pressure. */
+  static constexpr float kPressureLoad = 0.8f;
+
+  /* Predicted load a richer tier must stay under to be restored. */
+  static constexpr float kHeadroomLoad = 0.5f;
+
+  /* Load smoothing (~100 ms time constant at 10 ms frames). */
+  static constexpr float kLoadAlpha = 0.1f;
+
+  /* Consecutive pressured frames before stepping down (50 ms). */
+  static constexpr uint32_t kPressureFrames = 5;
+
+  /* Frames after a step before the next decision (200 ms). */
+  static constexpr uint32_t kSettleFrames = 20;
+
+  /* Headroom wait before stepping up: 2 s, doubling on a bounce up to 32 s. */
+  static constexpr uint32_t kHeadroomFrames = 200;
+  static constexpr uint32_t kMaxHeadroomFrames = 3200;
+
+  CpuGovernor() { reset(); }
+
+  /** Back to kFull with no history (start of a session). */
+  void reset();
+
+  /** Lowest tier the governor may reach (kFull disables it). */
+  void setFloor(QualityTier floor) { floor_ = floor; }
+
+  /**
+   * Account one processed frame: `processUs` spent in processFrame(),
+   * `budgetUs` the frame period, `backlogFrames` frames still waiting in
+   * the capture ring and `allowanceFrames` how many of those a host
+   * buffer lands at once anyway. Returns the tier for the next frame.
+   */
+  QualityTier update(uint32_t processUs, uint32_t budgetUs, size_t backlogFrames,
+                     size_t allowanceFrames);
+
+  QualityTier tier() const { return tier_; }
+
+  /** Smoothed processing time / budget. */
+  float load() const { return load_; }
+
+  /** Current step-up wait, in frames. */
+  uint32_t headroomWait() const { return headroomWait_; }
+
+  uint64_t stepsDown() const { return stepsDown_; }
+  uint64_t stepsUp() const { return stepsUp_; }
+
+ private:
+  void step(int delta);
+
+  QualityTier tier_ = QualityTier::kFull;
+  QualityTier floor_ = QualityTier::kLittleModel;
+  float load_ = 0.0f;
+  uint32_t pressured_ = 0;      /* Consecutive pressured frames */
+  uint32_t relaxed_ = 0;        /* Consecutive frames with headroom for the next tier up */
+  uint32_t settle_ = 0;         /* Frames left before the next decision */
+  uint32_t sinceUp_ = 0;        /* Frames since the last step up */
+  uint32_t headroomWait_ = kHeadroomFrames;
+  float loadBeforeStep_ = 0.0f; /* Load just before the last step down */
+  bool measuring_ = false;      /* costRatio_ of the current tier pending */
+  /* costRatio_[t]: load at tier t-1 / load at tier t, measured stepping down. */
+  float costRatio_[kTierCount] = {};
+  uint64_t stepsDown_ = 0;
+  uint64_t stepsUp_ = 0;
+};
+
+}  // namespace ainoiceguard
+
+#endif  // AINOICEGUARD_CPU_GOVERNOR_H
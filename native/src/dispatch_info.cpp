@@ -0,0 +1,29 @@
+/**
+ * DispatchInfo implementation. See dispatch_info.h.
+ */
+
+#include "dispatch_info.h"
+
+#include "dsp_kernels.h"
+#include "rnnoise_kernels.h"
+
+namespace ainoiceguard {
+
+namespace {
+
+DispatchInfo resolve() {
+  DispatchInfo info;
+  info.cpu = cpuFeatures();
+  info.dspKernels = dspKernels().name;
+  info.rnnoiseIsa = rnnoiseKernels().name;
+  return info;
+}
+
+}  // namespace
+
+const DispatchInfo& dispatchInfo() {
+  static const DispatchInfo info = resolve();
+  return info;
+}
+
+}  // namespace ainoiceguard
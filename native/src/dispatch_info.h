@@ -0,0 +1,28 @@
+/**
+ * Which code paths the runtime dispatch chose on this machine.
+ *
+ * Our own kernels (dsp_kernels.h) and RNNoise (rnnoise_kernels.h) each
+ * pick an instruction set once at startup, from the CPU features below.
+ *
+ * Exposed to JS via getDiagnostics() for bug reports and fleet telemetry.
+ */
+
+#ifndef AINOICEGUARD_DISPATCH_INFO_H
+#define AINOICEGUARD_DISPATCH_INFO_H
+
+#include "cpu_features.h"
+
+namespace ainoiceguard {
+
+struct DispatchInfo {
+  const char* dspKernels;  /* Selected DspKernels table name */
+  const char* rnnoiseIsa;  /* Selected RNNoise copy: "generic", "avx2", "avx512" */
+  CpuFeatures cpu;
+};
+
+/** Resolved once (first call), then cached. NOT for the audio thread. */
+const DispatchInfo& dispatchInfo();
+
+}  // namespace ainoiceguard
+
+#endif  // AINOICEGUARD_DISPATCH_INFO_H
@@ -0,0 +1,722 @@
+/**
+ * DSP kernel implementations + one-time CPU feature dispatch.
+ *
+ * Layout:
+ *   - Scalar reference (always compiled; defines the expected results).
+ *   - SSE2 (x86-64 baseline, always available there).
+ *   - AVX2 + FMA (x86-64, compiled with a per-function target attribute so
+ *     the rest of the addon keeps generic flags; selected only if CPUID and
+ *     the OS both report AVX2/FMA support -- see cpu_features.h).
+ *   - AVX-512F (x86-64, same scheme; masked loads/stores handle the tail,
+ *     so there is no scalar remainder loop).
+ *   - NEON (AArch64 baseline).
+ *
+ * Vector results may differ from scalar in the last bits because of
+ * summation order and fused multiply-add; the kernel tests check them
+ * against the scalar table with a relative tolerance.
+ */
+
+#include "dsp_kernels.h"
+
+#include <cmath>
+
+#include "cpu_features.h"
+
+#if defined(__x86_64__) || defined(_M_X64)
+#define NG_ARCH_X86_64 1
+#include <immintrin.h>
+#if defined(_MSC_VER) && !defined(__clang__)
+#define NG_TARGET_AVX2
+#define NG_TARGET_AVX512
+#else
+#define NG_TARGET_AVX2 __attribute__((target("avx2,fma")))
+#define NG_TARGET_AVX512 __attribute__((target("avx512f")))
+#endif
+#endif
+
+#if defined(__aarch64__) || defined(_M_ARM64)
+#define NG_ARCH_AARCH64 1
+#include <arm_neon.h>
+#endif
+
+namespace ainoiceguard {
+
+/* ═══════════════════════════════════════════════════════════════════════════
+ *  SCALAR REFERENCE
+ * ═══════════════════════════════════════════════════════════════════════════ */
+
+namespace {
+
+float sumSquaresScalar(const float* x, size_t n) {
+  float sum = 0.0f;
+  for (size_t i = 0; i < n; i++) {
+    sum += x[i] * x[i];
+  }
+  return sum;
+}
+
+void scaleCopyScalar(float* x, float* original, float k, size_t n) {
+  for (size_t i = 0; i < n; i++) {
+    original[i] = x[i];
+    x[i] *= k;
+  }
+}
+
+void scaleScalar(float* x, float k, size_t n) {
+  for (size_t i = 0; i < n; i++) {
+    x[i] *= k;
+  }
+}
+
+void blendScalar(float* wet, const float* dry, float wetGain, float dryGain,
+                 size_t n) {
+  for (size_t i = 0; i < n; i++) {
+    wet[i] = wet[i] * wetGain + dry[i] * dryGain;
+  }
+}
+
+void clampBelowScalar(float* x, float threshold, size_t n) {
+  for (size_t i = 0; i < n; i++) {
+    if (std::abs(x[i]) < threshold) {
+      x[i] = 0.0f;
+    }
+  }
+}
+
+float gainClampSumSquaresScalar(float* x, float gain, float threshold,
+                                size_t n) {
+  float sum = 0.0f;
+  for (size_t i = 0; i < n; i++) {
+    float y = x[i] * gain;
+    if (std::abs(y) < threshold) y = 0.0f;
+    x[i] = y;
+    sum += y * y;
+  }
+  return sum;
+}
+
+float biquadLanesScalar(BiquadLanes* b, float* x, size_t begin, size_t end,
+                        size_t last) {
+  constexpr size_t kL = BiquadLanes::kLanes;
+  float s1[kL], s2[kL], carry[kL];
+  for (size_t k = 0; k < kL; k++) {
+    s1[k] = b->s1[k];
+    s2[k] = b->s2[k];
+    carry[k] = b->carry[k];
+  }
+
+  float sum = 0.0f;
+  for (size_t t = begin; t < end; t++) {
+    float in[kL];
+    in[0] = x[t];
+    for (size_t k = 1; k < kL; k++) in[k] = carry[k - 1];
+    for (size_t k = 0; k < kL; k++) {
+      float y = b->b0[k] * in[k] + s1[k];
+      s1[k] = b->b1[k] * in[k] + s2[k] - b->a1[k] * y;
+      s2[k] = b->b2[k] * in[k] - b->a2[k] * y;
+      carry[k] = y;
+    }
+    float y = carry[last];
+    x[t - last] = y;
+    sum += y * y;
+  }
+
+  for (size_t k = 0; k < kL; k++) {
+    b->s1[k] = s1[k];
+    b->s2[k] = s2[k];
+    b->carry[k] = carry[k];
+  }
+  return sum;
+}
+
+const DspKernels kScalarKernels = {
+    "scalar",         sumSquaresScalar, scaleCopyScalar,
+    scaleScalar,      blendScalar,      clampBelowScalar,
+    gainClampSumSquaresScalar, biquadLanesScalar,
+};
+
+/* ═══════════════════════════════════════════════════════════════════════════
+ *  SSE2 (x86-64 baseline)
+ * ═══════════════════════════════════════════════════════════════════════════ */
+
+#ifdef NG_ARCH_X86_64
+
+inline float hsum128(__m128 v) {
+  __m128 shuf = _mm_shuffle_ps(v, v, _MM_SHUFFLE(2, 3, 0, 1));
+  __m128 sums = _mm_add_ps(v, shuf);
+  shuf = _mm_movehl_ps(shuf, sums);
+  sums = _mm_add_ss(sums, shuf);
+  return _mm_cvtss_f32(sums);
+}
+
+float sumSquaresSse2(const float* x, size_t n) {
+  __m128 acc0 = _mm_setzero_ps();
+  __m128 acc1 = _mm_setzero_ps();
+  size_t i = 0;
+  for (; i + 8 <= n; i += 8) {
+    __m128 a = _mm_loadu_ps(x + i);
+    __m128 b = _mm_loadu_ps(x + i + 4);
+    acc0 = _mm_add_ps(acc0, _mm_mul_ps(a, a));
+    acc1 = _mm_add_ps(acc1, _mm_mul_ps(b, b));
+  }
+  float sum = hsum128(_mm_add_ps(acc0, acc1));
+  for (; i < n; i++) sum += x[i] * x[i];
+  return sum;
+}
+
+void scaleCopySse2(float* x, float* original, float k, size_t n) {
+  const __m128 vk = _mm_set1_ps(k);
+  size_t i = 0;
+  for (; i + 4 <= n; i += 4) {
+    __m128 v = _mm_loadu_ps(x + i);
+    _mm_storeu_ps(original + i, v);
+    _mm_storeu_ps(x + i, _mm_mul_ps(v, vk));
+  }
+  for (; i < n; i++) {
+    original[i] = x[i];
+    x[i] *= k;
+  }
+}
+
+void scaleSse2(float* x, float k, size_t n) {
+  const __m128 vk = _mm_set1_ps(k);
+  size_t i = 0;
+  for (; i + 4 <= n; i += 4) {
+    _mm_storeu_ps(x + i, _mm_mul_ps(_mm_loadu_ps(x + i), vk));
+  }
+  for (; i < n; i++) x[i] *= k;
+}
+
+void blendSse2(float* wet, const float* dry, float wetGain, float dryGain,
+               size_t n) {
+  const __m128 vw = _mm_set1_ps(wetGain);
+  const __m128 vd = _mm_set1_ps(dryGain);
+  size_t i = 0;
+  for (; i + 4 <= n; i += 4) {
+    __m128 w = _mm_mul_ps(_mm_loadu_ps(wet + i), vw);
+    __m128 d = _mm_mul_ps(_mm_loadu_ps(dry + i), vd);
+    _mm_storeu_ps(wet + i, _mm_add_ps(w, d));
+  }
+  for (; i < n; i++) wet[i] = wet[i] * wetGain + dry[i] * dryGain;
+}
+
+void clampBelowSse2(float* x, float threshold, size_t n) {
+  const __m128 absMask = _mm_castsi128_ps(_mm_set1_epi32(0x7FFFFFFF));
+  const __m128 vt = _mm_set1_ps(threshold);
+  size_t i = 0;
+  for (; i + 4 <= n; i += 4) {
+    __m128 v = _mm_loadu_ps(x + i);
+    /* keep = !(|v| < t); NaN compares unordered -> kept, like the scalar path. */
+    __m128 keep = _mm_cmpnlt_ps(_mm_and_ps(v, absMask), vt);
+    _mm_storeu_ps(x + i, _mm_and_ps(v, keep));
+  }
+  for (; i < n; i++) {
+    if (std::abs(x[i]) < threshold) x[i] = 0.0f;
+  }
+}
+
+float gainClampSumSquaresSse2(float* x, float gain, float threshold,
+                              size_t n) {
+  const __m128 absMask = _mm_castsi128_ps(_mm_set1_epi32(0x7FFFFFFF));
+  const __m128 vg = _mm_set1_ps(gain);
+  const __m128 vt = _mm_set1_ps(threshold);
+  __m128 acc = _mm_setzero_ps();
+  size_t i = 0;
+  for (; i + 4 <= n; i += 4) {
+    __m128 v = _mm_mul_ps(_mm_loadu_ps(x + i), vg);
+    v = _mm_and_ps(v, _mm_cmpnlt_ps(_mm_and_ps(v, absMask), vt));
+    _mm_storeu_ps(x + i, v);
+    acc = _mm_add_ps(acc, _mm_mul_ps(v, v));
+  }
+  float sum = hsum128(acc);
+  for (; i < n; i++) {
+    float y = x[i] * gain;
+    if (std::abs(y) < threshold) y = 0.0f;
+    x[i] = y;
+    sum += y * y;
+  }
+  return sum;
+}
+
+/* Eight lanes as two halves; the lane shift crosses between them. */
+float biquadLanesSse2(BiquadLanes* b, float* x, size_t begin, size_t end,
+                      size_t last) {
+  const __m128 b0L = _mm_loadu_ps(b->b0), b0H = _mm_loadu_ps(b->b0 + 4);
+  const __m128 b1L = _mm_loadu_ps(b->b1), b1H = _mm_loadu_ps(b->b1 + 4);
+  const __m128 b2L = _mm_loadu_ps(b->b2), b2H = _mm_loadu_ps(b->b2 + 4);
+  const __m128 a1L = _mm_loadu_ps(b->a1), a1H = _mm_loadu_ps(b->a1 + 4);
+  const __m128 a2L = _mm_loadu_ps(b->a2), a2H = _mm_loadu_ps(b->a2 + 4);
+  __m128 s1L = _mm_loadu_ps(b->s1), s1H = _mm_loadu_ps(b->s1 + 4);
+  __m128 s2L = _mm_loadu_ps(b->s2), s2H = _mm_loadu_ps(b->s2 + 4);
+  __m128 cL = _mm_loadu_ps(b->carry), cH = _mm_loadu_ps(b->carry + 4);
+
+  const bool outHigh = last >= 4;
+  const size_t outLane = last & 3;
+  float out[4];
+  float sum = 0.0f;
+  for (size_t t = begin; t < end; t++) {
+    /* in = [x[t], c0, c1, c2 | c3, c4, c5, c6] */
+    __m128 inL = _mm_move_ss(_mm_shuffle_ps(cL, cL, _MM_SHUFFLE(2, 1, 0, 0)),
+                             _mm_set_ss(x[t]));
+    __m128 inH = _mm_move_ss(_mm_shuffle_ps(cH, cH, _MM_SHUFFLE(2, 1, 0, 0)),
+                             _mm_shuffle_ps(cL, cL, _MM_SHUFFLE(3, 3, 3, 3)));
+
+    cL = _mm_add_ps(_mm_mul_ps(b0L, inL), s1L);
+    s1L = _mm_sub_ps(_mm_add_ps(_mm_mul_ps(b1L, inL), s2L), _mm_mul_ps(a1L, cL));
+    s2L = _mm_sub_ps(_mm_mul_ps(b2L, inL), _mm_mul_ps(a2L, cL));
+
+    cH = _mm_add_ps(_mm_mul_ps(b0H, inH), s1H);
+    s1H = _mm_sub_ps(_mm_add_ps(_mm_mul_ps(b1H, inH), s2H), _mm_mul_ps(a1H, cH));
+    s2H = _mm_sub_ps(_mm_mul_ps(b2H, inH), _mm_mul_ps(a2H, cH));
+
+    _mm_storeu_ps(out, outHigh ? cH : cL);
+    float y = out[outLane];
+    x[t - last] = y;
+    sum += y * y;
+  }
+
+  _mm_storeu_ps(b->s1, s1L); _mm_storeu_ps(b->s1 + 4, s1H);
+  _mm_storeu_ps(b->s2, s2L); _mm_storeu_ps(b->s2 + 4, s2H);
+  _mm_storeu_ps(b->carry, cL); _mm_storeu_ps(b->carry + 4, cH);
+  return sum;
+}
+
+const DspKernels kSse2Kernels = {
+    "sse2",    sumSquaresSse2, scaleCopySse2,
+    scaleSse2, blendSse2,      clampBelowSse2,
+    gainClampSumSquaresSse2, biquadLanesSse2,
+};
+
+/* ═══════════════════════════════════════════════════════════════════════════
+ *  AVX2 + FMA (x86-64, runtime-detected)
+ * ═══════════════════════════════════════════════════════════════════════════ */
+
+NG_TARGET_AVX2 float sumSquaresAvx2(const float* x, size_t n) {
+  __m256 acc0 = _mm256_setzero_ps();
+  __m256 acc1 = _mm256_setzero_ps();
+  size_t i = 0;
+  for (; i + 16 <= n; i += 16) {
+    __m256 a = _mm256_loadu_ps(x + i);
+    __m256 b = _mm256_loadu_ps(x + i + 8);
+    acc0 = _mm256_fmadd_ps(a, a, acc0);
+    acc1 = _mm256_fmadd_ps(b, b, acc1);
+  }
+  for (; i + 8 <= n; i += 8) {
+    __m256 a = _mm256_loadu_ps(x + i);
+    acc0 = _mm256_fmadd_ps(a, a, acc0);
+  }
+  __m256 acc = _mm256_add_ps(acc0, acc1);
+  __m128 lo = _mm256_castps256_ps128(acc);
+  __m128 hi = _mm256_extractf128_ps(acc, 1);
+  float sum = hsum128(_mm_add_ps(lo, hi));
+  for (; i < n; i++) sum += x[i] * x[i];
+  return sum;
+}
+
+NG_TARGET_AVX2 void scaleCopyAvx2(float* x, float* original, float k,
+                                  size_t n) {
+  const __m256 vk = _mm256_set1_ps(k);
+  size_t i = 0;
+  for (; i + 8 <= n; i += 8) {
+    __m256 v = _mm256_loadu_ps(x + i);
+    _mm256_storeu_ps(original + i, v);
+    _mm256_storeu_ps(x + i, _mm256_mul_ps(v, vk));
+  }
+  for (; i < n; i++) {
+    original[i] = x[i];
+    x[i] *= k;
+  }
+}
+
+NG_TARGET_AVX2 void scaleAvx2(float* x, float k, size_t n) {
+  const __m256 vk = _mm256_set1_ps(k);
+  size_t i = 0;
+  for (; i + 8 <= n; i += 8) {
+    _mm256_storeu_ps(x + i, _mm256_mul_ps(_mm256_loadu_ps(x + i), vk));
+  }
+  for (; i < n; i++) x[i] *= k;
+}
+
+NG_TARGET_AVX2 void blendAvx2(float* wet, const float* dry, float wetGain,
+                              float dryGain, size_t n) {
+  const __m256 vw = _mm256_set1_ps(wetGain);
+  const __m256 vd = _mm256_set1_ps(dryGain);
+  size_t i = 0;
+  for (; i + 8 <= n; i += 8) {
+    __m256 d = _mm256_mul_ps(_mm256_loadu_ps(dry + i), vd);
+    _mm256_storeu_ps(wet + i, _mm256_fmadd_ps(_mm256_loadu_ps(wet + i), vw, d));
+  }
+  for (; i < n; i++) wet[i] = wet[i] * wetGain + dry[i] * dryGain;
+}
+
+NG_TARGET_AVX2 void clampBelowAvx2(float* x, float threshold, size_t n) {
+  const __m256 absMask = _mm256_castsi256_ps(_mm256_set1_epi32(0x7FFFFFFF));
+  const __m256 vt = _mm256_set1_ps(threshold);
+  size_t i = 0;
+  for (; i + 8 <= n; i += 8) {
+    __m256 v = _mm256_loadu_ps(x + i);
+    __m256 keep = _mm256_cmp_ps(_mm256_and_ps(v, absMask), vt, _CMP_NLT_UQ);
+    _mm256_storeu_ps(x + i, _mm256_and_ps(v, keep));
+  }
+  for (; i < n; i++) {
+    if (std::abs(x[i]) < threshold) x[i] = 0.0f;
+  }
+}
+
+NG_TARGET_AVX2 float gainClampSumSquaresAvx2(float* x, float gain,
+                                             float threshold, size_t n) {
+  const __m256 absMask = _mm256_castsi256_ps(_mm256_set1_epi32(0x7FFFFFFF));
+  const __m256 vg = _mm256_set1_ps(gain);
+  const __m256 vt = _mm256_set1_ps(threshold);
+  __m256 acc = _mm256_setzero_ps();
+  size_t i = 0;
+  for (; i + 8 <= n; i += 8) {
+    __m256 v = _mm256_mul_ps(_mm256_loadu_ps(x + i), vg);
+    v = _mm256_and_ps(
+        v, _mm256_cmp_ps(_mm256_and_ps(v, absMask), vt, _CMP_NLT_UQ));
+    _mm256_storeu_ps(x + i, v);
+    acc = _mm256_fmadd_ps(v, v, acc);
+  }
+  __m128 lo = _mm256_castps256_ps128(acc);
+  __m128 hi = _mm256_extractf128_ps(acc, 1);
+  float sum = hsum128(_mm_add_ps(lo, hi));
+  for (; i < n; i++) {
+    float y = x[i] * gain;
+    if (std::abs(y) < threshold) y = 0.0f;
+    x[i] = y;
+    sum += y * y;
+  }
+  return sum;
+}
+
+/* All eight lanes in one register: shift = one cross-lane permute + blend. */
+NG_TARGET_AVX2 float biquadLanesAvx2(BiquadLanes* b, float* x, size_t begin,
+                                     size_t end, size_t last) {
+  const __m256i shift = _mm256_setr_epi32(0, 0, 1, 2, 3, 4, 5, 6);
+  const __m256 b0 = _mm256_loadu_ps(b->b0);
+  const __m256 b1 = _mm256_loadu_ps(b->b1);
+  const __m256 b2 = _mm256_loadu_ps(b->b2);
+  const __m256 a1 = _mm256_loadu_ps(b->a1);
+  const __m256 a2 = _mm256_loadu_ps(b->a2);
+  __m256 s1 = _mm256_loadu_ps(b->s1);
+  __m256 s2 = _mm256_loadu_ps(b->s2);
+  __m256 c = _mm256_loadu_ps(b->carry);
+
+  float out[8];
+  float sum = 0.0f;
+  for (size_t t = begin; t < end; t++) {
+    __m256 in = _mm256_blend_ps(_mm256_permutevar8x32_ps(c, shift),
+                                _mm256_set1_ps(x[t]), 0x01);
+    c = _mm256_fmadd_ps(b0, in, s1);
+    s1 = _mm256_fnmadd_ps(a1, c, _mm256_fmadd_ps(b1, in, s2));
+    s2 = _mm256_fnmadd_ps(a2, c, _mm256_mul_ps(b2, in));
+
+    _mm256_storeu_ps(out, c);
+    float y = out[last];
+    x[t - last] = y;
+    sum += y * y;
+  }
+
+  _mm256_storeu_ps(b->s1, s1);
+  _mm256_storeu_ps(b->s2, s2);
+  _mm256_storeu_ps(b->carry, c);
+  return sum;
+}
+
+const DspKernels kAvx2Kernels = {
+    "avx2",    sumSquaresAvx2, scaleCopyAvx2,
+    scaleAvx2, blendAvx2,      clampBelowAvx2,
+    gainClampSumSquaresAvx2, biquadLanesAvx2,
+};
+
+bool cpuHasAvx2Fma() {
+  const CpuFeatures& cpu = cpuFeatures();
+  return cpu.avx2 && cpu.fma;
+}
+
+/* ═══════════════════════════════════════════════════════════════════════════
+ *  AVX-512F (x86-64, runtime-detected)
+ * ═══════════════════════════════════════════════════════════════════════════ */
+
+/* Lanes [0, n - i) of the final partial vector. */
+NG_TARGET_AVX512 inline __mmask16 tailMask(size_t remaining) {
+  return static_cast<__mmask16>((1u << remaining) - 1u);
+}
+
+NG_TARGET_AVX512 inline float hsum512(__m512 v) {
+  alignas(64) float lanes[16];
+  _mm512_store_ps(lanes, v);
+  __m128 a = _mm_add_ps(_mm_load_ps(lanes), _mm_load_ps(lanes + 4));
+  __m128 b = _mm_add_ps(_mm_load_ps(lanes + 8), _mm_load_ps(lanes + 12));
+  return hsum128(_mm_add_ps(a, b));
+}
+
+NG_TARGET_AVX512 float sumSquaresAvx512(const float* x, size_t n) {
+  __m512 acc0 = _mm512_setzero_ps();
+  __m512 acc1 = _mm512_setzero_ps();
+  size_t i = 0;
+  for (; i + 32 <= n; i += 32) {
+    __m512 a = _mm512_loadu_ps(x + i);
+    __m512 b = _mm512_loadu_ps(x + i + 16);
+    acc0 = _mm512_fmadd_ps(a, a, acc0);
+    acc1 = _mm512_fmadd_ps(b, b, acc1);
+  }
+  for (; i < n; i += 16) {
+    __mmask16 m = n - i >= 16 ? static_cast<__mmask16>(0xFFFF) : tailMask(n - i);
+    __m512 a = _mm512_maskz_loadu_ps(m, x + i);
+    acc0 = _mm512_fmadd_ps(a, a, acc0);
+  }
+  return hsum512(_mm512_add_ps(acc0, acc1));
+}
+
+NG_TARGET_AVX512 void scaleCopyAvx512(float* x, float* original, float k,
+                                      size_t n) {
+  const __m512 vk = _mm512_set1_ps(k);
+  for (size_t i = 0; i < n; i += 16) {
+    __mmask16 m = n - i >= 16 ? static_cast<__mmask16>(0xFFFF) : tailMask(n - i);
+    __m512 v = _mm512_maskz_loadu_ps(m, x + i);
+    _mm512_mask_storeu_ps(original + i, m, v);
+    _mm512_mask_storeu_ps(x + i, m, _mm512_mul_ps(v, vk));
+  }
+}
+
+NG_TARGET_AVX512 void scaleAvx512(float* x, float k, size_t n) {
+  const __m512 vk = _mm512_set1_ps(k);
+  for (size_t i = 0; i < n; i += 16) {
+    __mmask16 m = n - i >= 16 ? static_cast<__mmask16>(0xFFFF) : tailMask(n - i);
+    __m512 v = _mm512_maskz_loadu_ps(m, x + i);
+    _mm512_mask_storeu_ps(x + i, m, _mm512_mul_ps(v, vk));
+  }
+}
+
+NG_TARGET_AVX512 void blendAvx512(float* wet, const float* dry, float wetGain,
+                                  float dryGain, size_t n) {
+  const __m512 vw = _mm512_set1_ps(wetGain);
+  const __m512 vd = _mm512_set1_ps(dryGain);
+  for (size_t i = 0; i < n; i += 16) {
+    __mmask16 m = n - i >= 16 ? static_cast<__mmask16>(0xFFFF) : tailMask(n - i);
+    __m512 d = _mm512_mul_ps(_mm512_maskz_loadu_ps(m, dry + i), vd);
+    __m512 w = _mm512_maskz_loadu_ps(m, wet + i);
+    _mm512_mask_storeu_ps(wet + i, m, _mm512_fmadd_ps(w, vw, d));
+  }
+}
+
+NG_TARGET_AVX512 void clampBelowAvx512(float* x, float threshold, size_t n) {
+  const __m512 vt = _mm512_set1_ps(threshold);
+  for (size_t i = 0; i < n; i += 16) {
+    __mmask16 m = n - i >= 16 ? static_cast<__mmask16>(0xFFFF) : tailMask(n - i);
+    __m512 v = _mm512_maskz_loadu_ps(m, x + i);
+    /* keep = !(|v| < t); NaN compares unordered -> kept. */
+    __mmask16 keep = _mm512_cmp_ps_mask(_mm512_abs_ps(v), vt, _CMP_NLT_UQ);
+    _mm512_mask_storeu_ps(x + i, m, _mm512_maskz_mov_ps(keep, v));
+  }
+}
+
+NG_TARGET_AVX512 float gainClampSumSquaresAvx512(float* x, float gain,
+                                                 float threshold, size_t n) {
+  const __m512 vg = _mm512_set1_ps(gain);
+  const __m512 vt = _mm512_set1_ps(threshold);
+  __m512 acc = _mm512_setzero_ps();
+  for (size_t i = 0; i < n; i += 16) {
+    __mmask16 m = n - i >= 16 ? static_cast<__mmask16>(0xFFFF) : tailMask(n - i);
+    __m512 v = _mm512_mul_ps(_mm512_maskz_loadu_ps(m, x + i), vg);
+    v = _mm512_maskz_mov_ps(_mm512_cmp_ps_mask(_mm512_abs_ps(v), vt, _CMP_NLT_UQ), v);
+    _mm512_mask_storeu_ps(x + i, m, v);
+    acc = _mm512_fmadd_ps(v, v, acc);
+  }
+  return hsum512(acc);
+}
+
+const DspKernels kAvx512Kernels = {
+    "avx512",    sumSquaresAvx512, scaleCopyAvx512,
+    scaleAvx512, blendAvx512,      clampBelowAvx512,
+    /*
+     * The skewed cascade is latency-bound on its one cross-lane permute,
+     * and the 512-bit permute is slower than the 256-bit one. Every
+     * AVX-512F CPU also has AVX2 + FMA, so reuse that kernel.
+     */
+    gainClampSumSquaresAvx512, biquadLanesAvx2,
+};
+
+#endif  // NG_ARCH_X86_64
+
+/* ═══════════════════════════════════════════════════════════════════════════
+ *  NEON (AArch64 baseline)
+ * ═══════════════════════════════════════════════════════════════════════════ */
+
+#ifdef NG_ARCH_AARCH64
+
+float sumSquaresNeon(const float* x, size_t n) {
+  float32x4_t acc0 = vdupq_n_f32(0.0f);
+  float32x4_t acc1 = vdupq_n_f32(0.0f);
+  size_t i = 0;
+  for (; i + 8 <= n; i += 8) {
+    float32x4_t a = vld1q_f32(x + i);
+    float32x4_t b = vld1q_f32(x + i + 4);
+    acc0 = vfmaq_f32(acc0, a, a);
+    acc1 = vfmaq_f32(acc1, b, b);
+  }
+  float sum = vaddvq_f32(vaddq_f32(acc0, acc1));
+  for (; i < n; i++) sum += x[i] * x[i];
+  return sum;
+}
+
+void scaleCopyNeon(float* x, float* original, float k, size_t n) {
+  size_t i = 0;
+  for (; i + 4 <= n; i += 4) {
+    float32x4_t v = vld1q_f32(x + i);
+    vst1q_f32(original + i, v);
+    vst1q_f32(x + i, vmulq_n_f32(v, k));
+  }
+  for (; i < n; i++) {
+    original[i] = x[i];
+    x[i] *= k;
+  }
+}
+
+void scaleNeon(float* x, float k, size_t n) {
+  size_t i = 0;
+  for (; i + 4 <= n; i += 4) {
+    vst1q_f32(x + i, vmulq_n_f32(vld1q_f32(x + i), k));
+  }
+  for (; i < n; i++) x[i] *= k;
+}
+
+void blendNeon(float* wet, const float* dry, float wetGain, float dryGain,
+               size_t n) {
+  const float32x4_t vw = vdupq_n_f32(wetGain);
+  size_t i = 0;
+  for (; i + 4 <= n; i += 4) {
+    float32x4_t d = vmulq_n_f32(vld1q_f32(dry + i), dryGain);
+    vst1q_f32(wet + i, vfmaq_f32(d, vld1q_f32(wet + i), vw));
+  }
+  for (; i < n; i++) wet[i] = wet[i] * wetGain + dry[i] * dryGain;
+}
+
+void clampBelowNeon(float* x, float threshold, size_t n) {
+  const float32x4_t vt = vdupq_n_f32(threshold);
+  size_t i = 0;
+  for (; i + 4 <= n; i += 4) {
+    float32x4_t v = vld1q_f32(x + i);
+    /* zero = |v| < t (false for NaN, matching the scalar path). */
+    uint32x4_t zero = vcltq_f32(vabsq_f32(v), vt);
+    vst1q_f32(x + i, vreinterpretq_f32_u32(
+        vbicq_u32(vreinterpretq_u32_f32(v), zero)));
+  }
+  for (; i < n; i++) {
+    if (std::abs(x[i]) < threshold) x[i] = 0.0f;
+  }
+}
+
+float gainClampSumSquaresNeon(float* x, float gain, float threshold,
+                              size_t n) {
+  const float32x4_t vt = vdupq_n_f32(threshold);
+  float32x4_t acc = vdupq_n_f32(0.0f);
+  size_t i = 0;
+  for (; i + 4 <= n; i += 4) {
+    float32x4_t v = vmulq_n_f32(vld1q_f32(x + i), gain);
+    uint32x4_t zero = vcltq_f32(vabsq_f32(v), vt);
+    v = vreinterpretq_f32_u32(vbicq_u32(vreinterpretq_u32_f32(v), zero));
+    vst1q_f32(x + i, v);
+    acc = vfmaq_f32(acc, v, v);
+  }
+  float sum = vaddvq_f32(acc);
+  for (; i < n; i++) {
+    float y = x[i] * gain;
+    if (std::abs(y) < threshold) y = 0.0f;
+    x[i] = y;
+    sum += y * y;
+  }
+  return sum;
+}
+
+/* Eight lanes as two halves; vext shifts across them. */
+float biquadLanesNeon(BiquadLanes* b, float* x, size_t begin, size_t end,
+                      size_t last) {
+  const float32x4_t b0L = vld1q_f32(b->b0), b0H = vld1q_f32(b->b0 + 4);
+  const float32x4_t b1L = vld1q_f32(b->b1), b1H = vld1q_f32(b->b1 + 4);
+  const float32x4_t b2L = vld1q_f32(b->b2), b2H = vld1q_f32(b->b2 + 4);
+  const float32x4_t a1L = vld1q_f32(b->a1), a1H = vld1q_f32(b->a1 + 4);
+  const float32x4_t a2L = vld1q_f32(b->a2), a2H = vld1q_f32(b->a2 + 4);
+  float32x4_t s1L = vld1q_f32(b->s1), s1H = vld1q_f32(b->s1 + 4);
+  float32x4_t s2L = vld1q_f32(b->s2), s2H = vld1q_f32(b->s2 + 4);
+  float32x4_t cL = vld1q_f32(b->carry), cH = vld1q_f32(b->carry + 4);
+
+  const bool outHigh = last >= 4;
+  const size_t outLane = last & 3;
+  float out[4];
+  float sum = 0.0f;
+  for (size_t t = begin; t < end; t++) {
+    /* in = [x[t], c0, c1, c2 | c3, c4, c5, c6] */
+    float32x4_t inL = vextq_f32(vdupq_n_f32(x[t]), cL, 3);
+    float32x4_t inH = vextq_f32(cL, cH, 3);
+
+    cL = vfmaq_f32(s1L, b0L, inL);
+    s1L = vfmsq_f32(vfmaq_f32(s2L, b1L, inL), a1L, cL);
+    s2L = vfmsq_f32(vmulq_f32(b2L, inL), a2L, cL);
+
+    cH = vfmaq_f32(s1H, b0H, inH);
+    s1H = vfmsq_f32(vfmaq_f32(s2H, b1H, inH), a1H, cH);
+    s2H = vfmsq_f32(vmulq_f32(b2H, inH), a2H, cH);
+
+    vst1q_f32(out, outHigh ? cH : cL);
+    float y = out[outLane];
+    x[t - last] = y;
+    sum += y * y;
+  }
+
+  vst1q_f32(b->s1, s1L); vst1q_f32(b->s1 + 4, s1H);
+  vst1q_f32(b->s2, s2L); vst1q_f32(b->s2 + 4, s2H);
+  vst1q_f32(b->carry, cL); vst1q_f32(b->carry + 4, cH);
+  return sum;
+}
+
+const DspKernels kNeonKernels = {
+    "neon",    sumSquaresNeon, scaleCopyNeon,
+    scaleNeon, blendNeon,      clampBelowNeon,
+    gainClampSumSquaresNeon, biquadLanesNeon,
+};
+
+#endif  // NG_ARCH_AARCH64
+
+const DspKernels& selectKernels() {
+#ifdef NG_ARCH_X86_64
+  if (cpuFeatures().avx512f) return kAvx512Kernels;
+  if (cpuHasAvx2Fma()) return kAvx2Kernels;
+  return kSse2Kernels;
+#elif defined(NG_ARCH_AARCH64)
+  return kNeonKernels;
+#else
+  return kScalarKernels;
+#endif
+}
+
+}  // namespace
+
+/* ═══════════════════════════════════════════════════════════════════════════
+ *  DISPATCH
+ * ═══════════════════════════════════════════════════════════════════════════ */
+
+const DspKernels& dspKernels() {
+  /* Thread-safe one-time initialization (C++11 magic static). */
+  static const DspKernels& selected = selectKernels();
+  return selected;
+}
+
+const DspKernels& scalarDspKernels() { return kScalarKernels; }
+
+std::vector<const DspKernels*> supportedDspKernels() {
+  std::vector<const DspKernels*> tables;
+  tables.push_back(&kScalarKernels);
+#ifdef NG_ARCH_X86_64
+  tables.push_back(&kSse2Kernels);
+  if (cpuHasAvx2Fma()) tables.push_back(&kAvx2Kernels);
+  if (cpuFeatures().avx512f) tables.push_back(&kAvx512Kernels);
+#endif
+#ifdef NG_ARCH_AARCH64
+  tables.push_back(&kNeonKernels);
+#endif
+  return tables;
+}
+
+}  // namespace ainoiceguard
@@ -0,0 +1,93 @@
+/**
+ * Vectorized per-frame DSP kernels with runtime CPU dispatch.
+ *
+ * The RNNoise post-processing chain walks each 480-sample frame several
+ * times with simple element-wise loops (RMS, scale, blend, gain, clamp),
+ * and the filter bank advances eight skewed biquads per step.
+ * This module provides those loops as SSE2 / AVX2+FMA / AVX-512 / NEON kernels
+ * plus a scalar reference, and picks the best table ONCE for the host CPU.
+ *
+ * Usage:
+ *   const DspKernels& k = dspKernels();   // resolved on first call
+ *   float sum = k.sumSquares(frame, kRNNoiseFrameSize);
+ *
+ * REAL-TIME RULES:
+ * - Every kernel is allocation-free, branch-light and works on any length
+ *   (vector body + scalar tail). Pointers need no particular alignment.
+ * - dspKernels() performs CPU detection on its first call only. Call it
+ *   from init() (not the audio thread) so detection never lands in a
+ *   processing callback.
+ */
+
+#ifndef AINOICEGUARD_DSP_KERNELS_H
+#define AINOICEGUARD_DSP_KERNELS_H
+
+#include <cstddef>
+#include <vector>
+
+namespace ainoiceguard {
+
+/**
+ * Eight biquad sections in structure-of-arrays layout, one per lane, run
+ * skewed by one sample per lane (see filter_bank.h). Unused lanes hold
+ * identity sections.
+ */
+struct BiquadLanes {
+  static constexpr size_t kLanes = 8;
+  float b0[kLanes], b1[kLanes], b2[kLanes];  /* feedforward */
+  float a1[kLanes], a2[kLanes];              /* feedback, a0 = 1 */
+  float s1[kLanes], s2[kLanes];              /* TDF-II state */
+  float carry[kLanes];  /* Each lane's output from the previous step */
+};
+
+/** Table of kernel entry points for one instruction set. */
+struct DspKernels {
+  const char* name;  /* "scalar", "sse2", "avx2", "avx512", "neon" */
+
+  /** Returns sum(x[i]^2). RMS = sqrt(sumSquares / n). */
+  float (*sumSquares)(const float* x, size_t n);
+
+  /** original[i] = x[i]; x[i] *= k. (Save dry copy + scale to RNNoise range.) */
+  void (*scaleCopy)(float* x, float* original, float k, size_t n);
+
+  /** x[i] *= k. (Rescale from int16 range, apply gate gain.) */
+  void (*scale)(float* x, float k, size_t n);
+
+  /** wet[i] = wet[i] * wetGain + dry[i] * dryGain. */
+  void (*blend)(float* wet, const float* dry, float wetGain, float dryGain,
+                size_t n);
+
+  /** x[i] = 0 where |x[i]| < threshold. (Spectral floor clamp.) */
+  void (*clampBelow)(float* x, float threshold, size_t n);
+
+  /**
+   * Fused gate pass: x[i] *= gain; x[i] = 0 where |x[i]| < threshold;
+   * returns sum(x[i]^2) of the result. threshold = 0 disables the clamp.
+   */
+  float (*gainClampSumSquares)(float* x, float gain, float threshold, size_t n);
+
+  /**
+   * Steady-state steps t in [begin, end) of a skewed biquad cascade:
+   * every lane advances once per step, lane 0 reading x[t] and lane k
+   * reading carry[k - 1]; lane `last`'s output is written to x[t - last].
+   * Returns the sum of squares of the written outputs.
+   */
+  float (*biquadLanes)(BiquadLanes* b, float* x, size_t begin, size_t end,
+                       size_t last);
+};
+
+/** Best kernel table for the running CPU (detected once, then cached). */
+const DspKernels& dspKernels();
+
+/** Portable scalar reference implementation. */
+const DspKernels& scalarDspKernels();
+
+/**
+ * Every kernel table compiled in AND supported by this CPU, scalar first.
+ * Used by the kernel tests and benchmarks. NOT real-time safe.
+ */
+std::vector<const DspKernels*> supportedDspKernels();
+
+}  // namespace ainoiceguard
+
+#endif  // AINOICEGUARD_DSP_KERNELS_H
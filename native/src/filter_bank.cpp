@@ -0,0 +1,203 @@
+/**
+ * Biquad design and the skewed cascade kernel. See filter_bank.h.
+ */
+
+#include "filter_bank.h"
+
+#include <algorithm>
+#include <cmath>
+
+namespace ainoiceguard {
+
+/* ═══════════════════════════════════════════════════════════════════════════
+ *  DESIGN (Audio EQ Cookbook)
+ * ═══════════════════════════════════════════════════════════════════════════ */
+
+std::string designBiquad(const FilterSpec& spec, double sampleRate,
+                         BiquadCoeffs* out) {
+  if (!(sampleRate > 0.0)) return "Sample rate must be positive";
+  if (!(spec.frequency > 0.0 && spec.frequency < sampleRate / 2.0)) {
+    return "Filter frequency must be between 0 and " +
+           std::to_string(sampleRate / 2.0) + " Hz";
+  }
+  if (!(spec.q > 0.0)) return "Filter Q must be positive";
+
+  const double kPi = 3.14159265358979323846;
+  const double w0 = 2.0 * kPi * spec.frequency / sampleRate;
+  const double cosw = std::cos(w0);
+  const double alpha = std::sin(w0) / (2.0 * spec.q);
+  const double a = std::pow(10.0, spec.gainDb / 40.0);  /* Shelf / peak amplitude */
+  const double sqrtA2alpha = 2.0 * std::sqrt(a) * alpha;
+
+  double b0, b1, b2, a0, a1, a2;
+  switch (spec.type) {
+    case FilterType::kLowPass:
+      b0 = (1.0 - cosw) / 2.0;
+      b1 = 1.0 - cosw;
+      b2 = (1.0 - cosw) / 2.0;
+      a0 = 1.0 + alpha;
+      a1 = -2.0 * cosw;
+      a2 = 1.0 - alpha;
+      break;
+    case FilterType::kHighPass:
+      b0 = (1.0 + cosw) / 2.0;
+      b1 = -(1.0 + cosw);
+      b2 = (1.0 + cosw) / 2.0;
+      a0 = 1.0 + alpha;
+      a1 = -2.0 * cosw;
+      a2 = 1.0 - alpha;
+      break;
+    case FilterType::kNotch:
+      b0 = 1.0;
+      b1 = -2.0 * cosw;
+      b2 = 1.0;
+      a0 = 1.0 + alpha;
+      a1 = -2.0 * cosw;
+      a2 = 1.0 - alpha;
+      break;
+    case FilterType::kPeaking:
+      b0 = 1.0 + alpha * a;
+      b1 = -2.0 * cosw;
+      b2 = 1.0 - alpha * a;
+      a0 = 1.0 + alpha / a;
+      a1 = -2.0 * cosw;
+      a2 = 1.0 - alpha / a;
+      break;
+    case FilterType::kLowShelf:
+      b0 = a * ((a + 1.0) - (a - 1.0) * cosw + sqrtA2alpha);
+      b1 = 2.0 * a * ((a - 1.0) - (a + 1.0) * cosw);
+      b2 = a * ((a + 1.0) - (a - 1.0) * cosw - sqrtA2alpha);
+      a0 = (a + 1.0) + (a - 1.0) * cosw + sqrtA2alpha;
+      a1 = -2.0 * ((a - 1.0) + (a + 1.0) * cosw);
+      a2 = (a + 1.0) + (a - 1.0) * cosw - sqrtA2alpha;
+      break;
+    case FilterType::kHighShelf:
+      b0 = a * ((a + 1.0) + (a - 1.0) * cosw + sqrtA2alpha);
+      b1 = -2.0 * a * ((a - 1.0) + (a + 1.0) * cosw);
+      b2 = a * ((a + 1.0) + (a - 1.0) * cosw - sqrtA2alpha);
+      a0 = (a + 1.0) - (a - 1.0) * cosw + sqrtA2alpha;
+      a1 = 2.0 * ((a - 1.0) - (a + 1.0) * cosw);
+      a2 = (a + 1.0) - (a - 1.0) * cosw - sqrtA2alpha;
+      break;
+    default:
+      return "Unknown filter type";
+  }
+
+  out->b0 = static_cast<float>(b0 / a0);
+  out->b1 = static_cast<float>(b1 / a0);
+  out->b2 = static_cast<float>(b2 / a0);
+  out->a1 = static_cast<float>(a1 / a0);
+  out->a2 = static_cast<float>(a2 / a0);
+  return "";
+}
+
+std::vector<FilterSpec> humNotches(double mainsHz, size_t harmonics,
+                                   double maxHz, double q) {
+  std::vector<FilterSpec> notches;
+  for (size_t h = 1; h <= harmonics + 1; h++) {
+    double f = mainsHz * static_cast<double>(h);
+    if (f >= maxHz) break;
+    FilterSpec s;
+    s.type = FilterType::kNotch;
+    s.frequency = f;
+    s.q = q;
+    notches.push_back(s);
+  }
+  return notches;
+}
+
+/* ═══════════════════════════════════════════════════════════════════════════
+ *  CASCADE
+ *
+ *  Lane k of a group holds section k. carry[k] is lane k's output from
+ *  the previous step, i.e. section k's output for sample t - 1 - k, which
+ *  is exactly section k+1's input at step t. A block of n samples takes
+ *  n + lanes - 1 steps:
+ *
+ *    fill   t < lanes - 1     lanes above t have no input yet
+ *    steady                   every lane active: one full vector step
+ *    drain  t >= n            lanes below t - n + 1 are done
+ *
+ *  Fill and drain mask lanes so no state advances on a sample that does
+ *  not exist; the block ends with every section flushed, so nothing is
+ *  carried to the next block and the output has no added latency.
+ *  Unused lanes hold identity sections and never affect the output.
+ * ═══════════════════════════════════════════════════════════════════════════ */
+
+FilterBank::FilterBank(const DspKernels* kernels)
+    : kernels_(kernels ? kernels : &dspKernels()) {
+  setSections(nullptr, 0);
+}
+
+bool FilterBank::setSections(const BiquadCoeffs* coeffs, size_t count) {
+  if (count > kMaxSections) return false;
+  const bool keepState = count == count_;
+
+  for (size_t gi = 0; gi < kMaxSections / kLanes; gi++) {
+    Group& g = groups_[gi];
+    BiquadLanes& l = g.lanes;
+    size_t base = gi * kLanes;
+    g.used = count > base ? std::min(kLanes, count - base) : 0;
+    for (size_t k = 0; k < kLanes; k++) {
+      BiquadCoeffs c;  /* Identity */
+      if (k < g.used) c = coeffs[base + k];
+      l.b0[k] = c.b0; l.b1[k] = c.b1; l.b2[k] = c.b2;
+      l.a1[k] = c.a1; l.a2[k] = c.a2;
+      if (!keepState) l.s1[k] = l.s2[k] = 0.0f;
+    }
+  }
+  count_ = count;
+  return true;
+}
+
+void FilterBank::reset() {
+  for (Group& g : groups_) {
+    for (size_t k = 0; k < kLanes; k++) g.lanes.s1[k] = g.lanes.s2[k] = 0.0f;
+  }
+}
+
+float FilterBank::process(float* x, size_t n) {
+  if (count_ == 0) return kernels_->sumSquares(x, n);
+  float sum = processGroup(groups_[0], x, n);
+  if (count_ > kLanes) sum = processGroup(groups_[1], x, n);
+  return sum;
+}
+
+float FilterBank::processGroup(Group& g, float* x, size_t n) {
+  BiquadLanes& l = g.lanes;
+  const size_t last = g.used - 1;
+  for (size_t k = 0; k < kLanes; k++) l.carry[k] = 0.0f;
+
+  float sum = 0.0f;
+
+  /* Masked fill / drain step: only lanes lo..hi (inclusive) advance. */
+  auto partialStep = [&](size_t t, size_t lo, size_t hi) {
+    float in[kLanes];
+    for (size_t k = lo; k <= hi; k++) in[k] = k == 0 ? x[t] : l.carry[k - 1];
+    for (size_t k = lo; k <= hi; k++) {
+      float y = l.b0[k] * in[k] + l.s1[k];
+      l.s1[k] = l.b1[k] * in[k] + l.s2[k] - l.a1[k] * y;
+      l.s2[k] = l.b2[k] * in[k] - l.a2[k] * y;
+      l.carry[k] = y;
+    }
+    if (hi == last) {
+      float y = l.carry[last];
+      x[t - last] = y;
+      sum += y * y;
+    }
+  };
+
+  const size_t steps = n + last;
+  const size_t steadyEnd = n > last ? n : last;  /* exclusive */
+
+  for (size_t t = 0; t < last && t < steps; t++) {
+    partialStep(t, t >= n ? t - n + 1 : 0, t);
+  }
+  if (steadyEnd > last) sum += kernels_->biquadLanes(&l, x, last, steadyEnd, last);
+  for (size_t t = steadyEnd; t < steps; t++) {
+    partialStep(t, t - n + 1, last);
+  }
+  return sum;
+}
+
+}  // namespace ainoiceguard
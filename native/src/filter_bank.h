@@ -0,0 +1,118 @@
+/**
+ * Biquad design for any sample rate, and a block-processed cascade.
+ *
+ * designBiquad() turns a FilterSpec (type, corner / centre frequency, Q,
+ * gain) into normalized coefficients using the Audio EQ Cookbook (Robert
+ * Bristow-Johnson) formulas, evaluated in double precision. humNotches()
+ * builds the notch set for mains hum: the fundamental (50 or 60 Hz) and
+ * its harmonics.
+ *
+ * FilterBank runs up to kMaxSections biquads in series (Transposed Direct
+ * Form II). A plain cascade costs one serial biquad per section per
+ * sample. The block kernel instead skews the cascade across SIMD lanes:
+ * at step t, lane k runs section k on sample t - k, taking its input from
+ * lane k - 1's output of the previous step. All lanes advance in one
+ * vector step, so one block pass costs (n + kLanes - 1) steps whether the
+ * group holds one section or kLanes of them -- hum notches ride along
+ * with the EQ for free until the group is full. The steady-state steps
+ * are a DspKernels entry (one permute + three FMAs per step on AVX2).
+ *
+ * REAL-TIME RULES:
+ * - FilterBank::process() and reset() are allocation-free.
+ * - designBiquad() / humNotches() are control-thread helpers.
+ */
+
+#ifndef AINOICEGUARD_FILTER_BANK_H
+#define AINOICEGUARD_FILTER_BANK_H
+
+#include <cstddef>
+#include <string>
+#include <vector>
+
+#include "dsp_kernels.h"
+#include "post_filter.h"
+
+namespace ainoiceguard {
+
+enum class FilterType : int {
+  kLowPass = 0,
+  kHighPass = 1,
+  kNotch = 2,      /* Band-reject, width set by Q */
+  kPeaking = 3,    /* Parametric EQ bell: gainDb at frequency */
+  kLowShelf = 4,
+  kHighShelf = 5,
+};
+
+/** One section, described independently of the sample rate. */
+struct FilterSpec {
+  FilterType type = FilterType::kPeaking;
+  double frequency = 1000.0;  /* Corner / centre (Hz) */
+  double q = 0.7071;          /* Quality factor; 1/sqrt(2) = Butterworth */
+  double gainDb = 0.0;        /* kPeaking / shelves only */
+};
+
+/*
+ * Notch Q for hum removal. 30 gives a ~1.7 Hz -3 dB width at 50 Hz: deep
+ * enough for mains hum, narrow enough to leave neighbouring voice
+ * harmonics alone.
+ */
+static constexpr double kHumNotchQ = 30.0;
+
+/**
+ * Design `spec` at `sampleRate`. Returns empty string on success, or an
+ * error message (frequency outside (0, Nyquist), Q <= 0, unknown type).
+ */
+std::string designBiquad(const FilterSpec& spec, double sampleRate,
+                         BiquadCoeffs* out);
+
+/**
+ * Notches at mainsHz and its next `harmonics` multiples (harmonics = 0:
+ * fundamental only). Multiples at or above `maxHz` are left out.
+ */
+std::vector<FilterSpec> humNotches(double mainsHz, size_t harmonics,
+                                   double maxHz, double q = kHumNotchQ);
+
+class FilterBank {
+ public:
+  /* Sections advanced together by one vector step. */
+  static constexpr size_t kLanes = BiquadLanes::kLanes;
+
+  /* Two lane groups: at most two block passes per frame. */
+  static constexpr size_t kMaxSections = 2 * kLanes;
+
+  /** Uses `kernels` for the steady-state steps (nullptr = dspKernels()). */
+  explicit FilterBank(const DspKernels* kernels = nullptr);
+
+  /**
+   * Replace the sections. State is kept when the section count is
+   * unchanged (coefficient retune) and cleared otherwise. Returns false
+   * (bank unchanged) when count > kMaxSections.
+   */
+  bool setSections(const BiquadCoeffs* coeffs, size_t count);
+
+  size_t size() const { return count_; }
+
+  void reset();
+
+  /**
+   * Filter x through every section in order, in place. Returns the sum
+   * of squares of the output. With no sections, x is left untouched.
+   */
+  float process(float* x, size_t n);
+
+ private:
+  struct Group {
+    BiquadLanes lanes;
+    size_t used = 0;  /* Sections in use (output is taken from lane used - 1) */
+  };
+
+  float processGroup(Group& g, float* x, size_t n);
+
+  Group groups_[kMaxSections / kLanes];
+  size_t count_ = 0;
+  const DspKernels* kernels_;
+};
+
+}  // namespace ainoiceguard
+
+#endif  // AINOICEGUARD_FILTER_BANK_H
@@ -0,0 +1,114 @@
+/**
+ * Lock-free "last N records" history: one writer, any number of readers.
+ *
+ * Companion to SpscQueue: the queue hands each record to exactly one
+ * consumer and drops new records when full; this ring keeps the most
+ * recent Capacity records, overwriting the oldest, and readers take
+ * non-destructive snapshots (e.g. to attach to a bug report).
+ *
+ * Each slot is guarded by a sequence number (seqlock): the writer marks
+ * the slot odd while copying, then publishes 2 * (index + 1). A reader
+ * keeps a slot only if the sequence matches the index it expects before
+ * and after copying, so a record torn by a concurrent overwrite is
+ * skipped, never returned. Payloads are copied as relaxed atomic words,
+ * so the race a seqlock tolerates is not a data race in the C++ sense.
+ *
+ * RULES FOR REAL-TIME AUDIO:
+ * - push() is wait-free and allocation-free (fixed in-object storage).
+ * - snapshot() never blocks the writer; it may allocate (control thread).
+ * - T must be trivially copyable, sized in whole 64-bit words.
+ * - Capacity must be a power of 2.
+ */
+
+#ifndef AINOICEGUARD_HISTORY_RING_H
+#define AINOICEGUARD_HISTORY_RING_H
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <type_traits>
+#include <vector>
+
+namespace ainoiceguard {
+
+template <typename T, size_t Capacity>
+class HistoryRing {
+  static_assert(std::is_trivially_copyable<T>::value,
+                "HistoryRing records must be trivially copyable (POD)");
+  static_assert(sizeof(T) % sizeof(uint64_t) == 0,
+                "HistoryRing records must be a whole number of 64-bit words");
+  static_assert(Capacity >= 2 && (Capacity & (Capacity - 1)) == 0,
+                "HistoryRing capacity must be a power of 2");
+
+ public:
+  HistoryRing() = default;
+
+  HistoryRing(const HistoryRing&) = delete;
+  HistoryRing& operator=(const HistoryRing&) = delete;
+
+  /** Writer side. Overwrites the oldest record once full. */
+  void push(const T& item) {
+    uint64_t n = written_.load(std::memory_order_relaxed);
+    Slot& s = slots_[n & kMask];
+    uint64_t words[kWords];
+    std::memcpy(words, &item, sizeof(T));
+
+    s.seq.store(2 * n + 1, std::memory_order_relaxed);
+    std::atomic_thread_fence(std::memory_order_release);
+    for (size_t i = 0; i < kWords; i++) s.words[i].store(words[i], std::memory_order_relaxed);
+    s.seq.store(2 * n + 2, std::memory_order_release);
+    written_.store(n + 1, std::memory_order_release);
+  }
+
+  /**
+   * Reader side: the retained records, oldest first. Records overwritten
+   * while being copied are left out. NOT real-time safe (allocates).
+   */
+  std::vector<T> snapshot() const {
+    std::vector<T> out;
+    uint64_t end = written_.load(std::memory_order_acquire);
+    uint64_t begin = end > Capacity ? end - Capacity : 0;
+    out.reserve(static_cast<size_t>(end - begin));
+    for (uint64_t n = begin; n < end; n++) {
+      const Slot& s = slots_[n & kMask];
+      uint64_t seq = s.seq.load(std::memory_order_acquire);
+      if (seq != 2 * n + 2) continue;
+      uint64_t words[kWords];
+      for (size_t i = 0; i < kWords; i++) words[i] = s.words[i].load(std::memory_order_relaxed);
+      std::atomic_thread_fence(std::memory_order_acquire);
+      if (s.seq.load(std::memory_order_relaxed) != seq) continue;
+      T item;
+      std::memcpy(&item, words, sizeof(T));
+      out.push_back(item);
+    }
+    return out;
+  }
+
+  /** Records pushed since construction / clear(), including overwritten ones. */
+  uint64_t total() const { return written_.load(std::memory_order_acquire); }
+
+  /** Forget all records. Call only while neither side is active. */
+  void clear() {
+    for (Slot& s : slots_) s.seq.store(0, std::memory_order_relaxed);
+    written_.store(0, std::memory_order_release);
+  }
+
+  static constexpr size_t capacity() { return Capacity; }
+
+ private:
+  static constexpr size_t kMask = Capacity - 1;
+  static constexpr size_t kWords = sizeof(T) / sizeof(uint64_t);
+
+  struct Slot {
+    std::atomic<uint64_t> seq{0};
+    std::atomic<uint64_t> words[kWords]{};
+  };
+
+  Slot slots_[Capacity];
+  std::atomic<uint64_t> written_{0};
+};
+
+}  // namespace ainoiceguard
+
+#endif  // AINOICEGUARD_HISTORY_RING_H
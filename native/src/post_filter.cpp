@@ -0,0 +1,83 @@
+/**
+ * Fused post-filter passes. See post_filter.h for the pass split.
+ *
+ * The scalar sweeps are StageChain instantiations: filter and noise state
+ * is copied into locals for the duration of a pass so the compiler can
+ * keep the whole IIR delay line in registers instead of reloading it
+ * through a reference on every sample.
+ */
+
+#include "post_filter.h"
+
+#include "dsp_kernels.h"
+#include "stage_chain.h"
+
+namespace ainoiceguard {
+
+namespace {
+
+/* One specialized sweep per filter subset; the blend joins when level < 1. */
+template <typename... Filters>
+float preGate(float* frame, const float* original, size_t len, float inScale,
+              float level, Filters... filters) {
+  StageFrame f;
+  f.original = original;
+  f.inScale = inScale;
+  f.level = level;
+  if (level < 1.0f) {
+    return StageChain<ScaleStage, BlendStage, Filters...>(
+               ScaleStage{}, BlendStage{}, filters...)
+        .run(frame, len, f);
+  }
+  return StageChain<ScaleStage, Filters...>(ScaleStage{}, filters...)
+      .run(frame, len, f);
+}
+
+}  // namespace
+
+float fusedPreGatePass(float* frame, const float* original, size_t len,
+                       float inScale, float level,
+                       BiquadState& hpf, BiquadState& lpf) {
+  return preGate(frame, original, len, inScale, level, BiquadStage(&hpf),
+                 BiquadStage(&lpf));
+}
+
+float fusedPreGatePass(float* frame, const float* original, size_t len,
+                       float inScale, float level,
+                       BiquadState* hpf, BiquadState* lpf) {
+  if (hpf && lpf) {
+    return preGate(frame, original, len, inScale, level, BiquadStage(hpf),
+                   BiquadStage(lpf));
+  }
+  if (hpf) return preGate(frame, original, len, inScale, level, BiquadStage(hpf));
+  if (lpf) return preGate(frame, original, len, inScale, level, BiquadStage(lpf));
+  return preGate(frame, original, len, inScale, level);
+}
+
+float fusedPostGatePass(float* frame, size_t len, float gain,
+                        float clampThresh, ComfortNoise* noise,
+                        float noiseScale, const DspKernels& kernels) {
+  /* No comfort noise: gain + clamp + energy is one SIMD kernel. */
+  if (!noise || noiseScale <= 0.0f) {
+    /* Gate open and no clamp: nothing to write, only the energy. */
+    if (gain == 1.0f && clampThresh <= 0.0f) {
+      return kernels.sumSquares(frame, len);
+    }
+    return kernels.gainClampSumSquares(frame, gain, clampThresh, len);
+  }
+
+  /* Comfort noise generator is recursive: one fused scalar loop. */
+  StageFrame f;
+  f.gain = gain;
+  f.clampThresh = clampThresh;
+  f.noiseScale = noiseScale;
+  if (clampThresh > 0.0f) {
+    return StageChain<GainStage, ClampStage, NoiseStage>(
+               GainStage{}, ClampStage{}, NoiseStage(noise))
+        .run(frame, len, f);
+  }
+  return StageChain<GainStage, NoiseStage>(GainStage{}, NoiseStage(noise))
+      .run(frame, len, f);
+}
+
+}  // namespace ainoiceguard
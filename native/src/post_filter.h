@@ -0,0 +1,138 @@
+/**
+ * Post-RNNoise filter building blocks and fused frame passes.
+ *
+ * After RNNoise, the wrapper's post-processing would naively walk the
+ * 480-sample frame seven times (rescale, blend, HPF+LPF, RMS, gain, clamp,
+ * comfort noise, RMS). The data dependencies only force ONE split: the
+ * gate decision needs the post-filter RMS before the gain can be applied.
+ * So the chain runs as two fused passes:
+ *
+ *   Pass A (pre-gate):  rescale -> blend -> HPF -> LPF -> sum of squares
+ *   Pass B (post-gate): gain -> clamp -> comfort noise -> sum of squares
+ *
+ * Pass A is inherently serial (IIR recursion) and stays scalar. Pass B is
+ * a single SIMD kernel unless comfort noise is being injected (its
+ * generator is also recursive), in which case it falls back to one fused
+ * scalar loop. The scalar loops are StageChain instantiations (see
+ * stage_chain.h), one per stage subset.
+ *
+ * REAL-TIME RULES: everything here is allocation-free, fixed-length loops.
+ */
+
+#ifndef AINOICEGUARD_POST_FILTER_H
+#define AINOICEGUARD_POST_FILTER_H
+
+#include <cstddef>
+#include <cstdint>
+
+namespace ainoiceguard {
+
+struct DspKernels;
+
+/** Normalized biquad coefficients (a0 = 1). Designed in filter_bank.h. */
+struct BiquadCoeffs {
+  float b0 = 1.f, b1 = 0.f, b2 = 0.f;  /* feedforward (numerator) */
+  float a1 = 0.f, a2 = 0.f;              /* feedback (denominator) */
+};
+
+/**
+ * 2nd-order IIR biquad filter (Transposed Direct Form II).
+ * Two instances are used: one HPF at 80 Hz, one LPF at 8 kHz, designed
+ * for the processing rate in initFilters(). TDF-II keeps two state
+ * words instead of DF-I's four and has better float behaviour for
+ * low-frequency poles.
+ * No allocations; state lives in fixed member variables.
+ */
+struct BiquadState {
+  float b0 = 1.f, b1 = 0.f, b2 = 0.f;  /* feedforward (numerator) */
+  float a1 = 0.f, a2 = 0.f;              /* feedback (denominator), a0 = 1 */
+  float s1 = 0.f, s2 = 0.f;             /* transposed delay line */
+
+  void reset() { s1 = s2 = 0.f; }
+
+  void setCoeffs(const BiquadCoeffs& c) {
+    b0 = c.b0; b1 = c.b1; b2 = c.b2;
+    a1 = c.a1; a2 = c.a2;
+  }
+
+  inline float process(float x) {
+    float y = b0 * x + s1;
+    s1 = b1 * x + s2 - a1 * y;
+    s2 = b2 * x - a2 * y;
+    return y;
+  }
+};
+
+/**
+ * LFSR-based comfort noise with 1-pole lowpass shaping.
+ * Strong lowpass (kShapeCoeff) keeps energy in sub-bass to avoid
+ * audible buzz/hiss. Final amplitude is kLevel (~-70 dBFS).
+ */
+struct ComfortNoise {
+  /*
+   * Comfort noise amplitude: -70 dBFS = 0.0003.
+   * Very low to avoid audible buzz/hiss; still prevents dead silence in headphones.
+   */
+  static constexpr float kLevel = 0.0003f;
+
+  /*
+   * 1-pole lowpass shaping coefficient.
+   * 0.92 → strong lowpass so noise is sub-bass rumble, not mid/high buzz or hiss.
+   */
+  static constexpr float kShapeCoeff = 0.92f;
+
+  uint32_t state = 0x12345678;
+  float prev = 0.0f;
+
+  void reset() {
+    state = 0x12345678;
+    prev = 0.0f;
+  }
+
+  inline float sample() {
+    state ^= state << 13;
+    state ^= state >> 17;
+    state ^= state << 5;
+
+    float white = static_cast<float>(static_cast<int32_t>(state)) /
+                  2147483648.0f;
+
+    float shaped = kShapeCoeff * prev + (1.0f - kShapeCoeff) * white;
+    prev = shaped;
+
+    return shaped * kLevel;
+  }
+};
+
+/**
+ * Pass A. In one sweep over the frame:
+ *   frame[i] = lpf(hpf(frame[i] * inScale * level + original[i] * (1 - level)))
+ * The blend term is skipped entirely when level >= 1.
+ * Returns the sum of squares of the filtered frame (for the post-filter RMS).
+ */
+float fusedPreGatePass(float* frame, const float* original, size_t len,
+                       float inScale, float level,
+                       BiquadState& hpf, BiquadState& lpf);
+
+/**
+ * Pass A with optional filters: a null hpf / lpf drops that stage from the
+ * sweep (a separately specialized loop, not a per-sample branch).
+ */
+float fusedPreGatePass(float* frame, const float* original, size_t len,
+                       float inScale, float level,
+                       BiquadState* hpf, BiquadState* lpf);
+
+/**
+ * Pass B. In one sweep over the frame:
+ *   y = frame[i] * gain;  y = 0 if |y| < clampThresh;  y += noise * noiseScale
+ * Pass clampThresh = 0 to disable the clamp and noise = nullptr (or
+ * noiseScale = 0) to disable comfort noise.
+ * Returns the sum of squares of the output frame (for the output RMS).
+ */
+float fusedPostGatePass(float* frame, size_t len, float gain,
+                        float clampThresh, ComfortNoise* noise,
+                        float noiseScale, const DspKernels& kernels);
+
+}  // namespace ainoiceguard
+
+#endif  // AINOICEGUARD_POST_FILTER_H
@@ -0,0 +1,257 @@
+/**
+ * Offline quality metrics. See quality_metrics.h.
+ */
+
+#include "quality_metrics.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <fstream>
+#include <sstream>
+
+namespace ainoiceguard {
+
+/* ── WAV reading ─────────────────────────────────────────────────────────── */
+
+static constexpr uint16_t kWavFormatPcm = 1;
+static constexpr uint16_t kWavFormatFloat = 3;
+static constexpr uint16_t kWavFormatExtensible = 0xFFFE;
+
+static uint16_t le16(const unsigned char* p) {
+  return static_cast<uint16_t>(p[0] | (p[1] << 8));
+}
+
+static uint32_t le32(const unsigned char* p) {
+  return static_cast<uint32_t>(p[0]) | (static_cast<uint32_t>(p[1]) << 8) |
+         (static_cast<uint32_t>(p[2]) << 16) | (static_cast<uint32_t>(p[3]) << 24);
+}
+
+/* One little-endian sample scaled to [-1, 1]. */
+static float decodeSample(const unsigned char* p, uint16_t format, uint16_t bits) {
+  if (format == kWavFormatFloat) {
+    float v;
+    uint32_t u = le32(p);
+    std::memcpy(&v, &u, sizeof(v));
+    return v;
+  }
+  switch (bits) {
+    case 16:
+      return static_cast<float>(static_cast<int16_t>(le16(p))) / 32768.0f;
+    case 24: {
+      int32_t v = static_cast<int32_t>((static_cast<uint32_t>(p[0]) << 8) |
+                                       (static_cast<uint32_t>(p[1]) << 16) |
+                                       (static_cast<uint32_t>(p[2]) << 24));
+      return static_cast<float>(v >> 8) / 8388608.0f;
+    }
+    default:  /* 32 */
+      return static_cast<float>(static_cast<int32_t>(le32(p))) / 2147483648.0f;
+  }
+}
+
+std::string readWav(const std::string& path, WavData* out) {
+  std::ifstream in(path, std::ios::binary);
+  if (!in) return "cannot open " + path;
+  std::vector<unsigned char> file((std::istreambuf_iterator<char>(in)),
+                                  std::istreambuf_iterator<char>());
+  if (file.size() < 12 || std::memcmp(file.data(), "RIFF", 4) != 0 ||
+      std::memcmp(file.data() + 8, "WAVE", 4) != 0) {
+    return path + ": not a RIFF/WAVE file";
+  }
+
+  uint16_t format = 0, channels = 0, bits = 0;
+  uint32_t rate = 0;
+  const unsigned char* data = nullptr;
+  size_t dataBytes = 0;
+
+  size_t pos = 12;
+  while (pos + 8 <= file.size()) {
+    const unsigned char* chunk = file.data() + pos;
+    size_t size = le32(chunk + 4);
+    size_t avail = std::min(size, file.size() - pos - 8);
+    if (std::memcmp(chunk, "fmt ", 4) == 0 && avail >= 16) {
+      format = le16(chunk + 8);
+      channels = le16(chunk + 10);
+      rate = le32(chunk + 12);
+      bits = le16(chunk + 22);
+      if (format == kWavFormatExtensible && avail >= 40) {
+        format = le16(chunk + 32);  /* First two bytes of the SubFormat GUID */
+      }
+    } else if (std::memcmp(chunk, "data", 4) == 0) {
+      data = chunk + 8;
+      dataBytes = avail;  /* Tolerates truncated files */
+    }
+    pos += 8 + size + (size & 1);
+  }
+
+  if (!data || channels == 0) return path + ": missing fmt or data chunk";
+  bool supported = (format == kWavFormatPcm && (bits == 16 || bits == 24 || bits == 32)) ||
+                   (format == kWavFormatFloat && bits == 32);
+  if (!supported) {
+    return path + ": unsupported sample format (" + std::to_string(format) + ", " +
+           std::to_string(bits) + " bits)";
+  }
+
+  const size_t bytesPerSample = bits / 8;
+  const size_t frames = dataBytes / (bytesPerSample * channels);
+  out->sampleRate = rate;
+  out->samples.assign(frames, 0.0f);
+  const float scale = 1.0f / static_cast<float>(channels);
+  for (size_t i = 0; i < frames; i++) {
+    float sum = 0.0f;
+    for (uint16_t c = 0; c < channels; c++) {
+      sum += decodeSample(data + (i * channels + c) * bytesPerSample, format, bits);
+    }
+    out->samples[i] = sum * scale;
+  }
+  return "";
+}
+
+/* ── Labels ──────────────────────────────────────────────────────────────── */
+
+std::string readLabels(const std::string& path, double sampleRate, size_t frameSize,
+                       size_t frames, std::vector<uint8_t>* labels) {
+  std::ifstream in(path);
+  if (!in) return "cannot open " + path;
+
+  /* Per-frame count of samples inside a speech segment. */
+  std::vector<size_t> covered(frames, 0);
+  std::string line;
+  int lineNo = 0;
+  while (std::getline(in, line)) {
+    lineNo++;
+    if (line.empty() || line[0] == '#' || line[0] == '\\') continue;  /* '\' = spectral row */
+    std::istringstream fields(line);
+    double start = 0.0, end = 0.0;
+    if (!(fields >> start >> end) || end < start || start < 0.0) {
+      return path + ":" + std::to_string(lineNo) + ": expected \"start end\" in seconds";
+    }
+    size_t a = static_cast<size_t>(std::llround(start * sampleRate));
+    size_t b = static_cast<size_t>(std::llround(end * sampleRate));
+    b = std::min(b, frames * frameSize);
+    for (size_t s = a; s < b;) {
+      size_t f = s / frameSize;
+      size_t frameEnd = std::min((f + 1) * frameSize, b);
+      covered[f] += frameEnd - s;
+      s = frameEnd;
+    }
+  }
+
+  labels->assign(frames, 0);
+  for (size_t f = 0; f < frames; f++) {
+    (*labels)[f] = covered[f] * 2 >= frameSize ? 1 : 0;
+  }
+  return "";
+}
+
+static double frameEnergy(const float* x, size_t n) {
+  double e = 0.0;
+  for (size_t i = 0; i < n; i++) e += static_cast<double>(x[i]) * x[i];
+  return e;
+}
+
+std::vector<uint8_t> energyLabels(const float* clean, size_t n, size_t frameSize,
+                                  float rangeDb) {
+  const size_t frames = n / frameSize;
+  std::vector<double> energy(frames);
+  double peak = 0.0;
+  for (size_t f = 0; f < frames; f++) {
+    energy[f] = frameEnergy(clean + f * frameSize, frameSize);
+    peak = std::max(peak, energy[f]);
+  }
+  const double threshold = peak * std::pow(10.0, -rangeDb / 10.0);
+  std::vector<uint8_t> labels(frames);
+  for (size_t f = 0; f < frames; f++) {
+    labels[f] = (peak > 0.0 && energy[f] >= threshold) ? 1 : 0;
+  }
+  return labels;
+}
+
+/* ── SNR ─────────────────────────────────────────────────────────────────── */
+
+/* Ceiling for identical signals, so results stay finite. */
+static constexpr double kMaxSnrDb = 100.0;
+
+/* Segmental SNR clamp (ITU-style bounds). */
+static constexpr double kSegMinDb = -10.0;
+static constexpr double kSegMaxDb = 35.0;
+
+/* Reference frames quieter than this (-50 dBFS RMS) are not scored. */
+static constexpr double kSegSilenceRms = 0.00316;
+
+static double ratioDb(double signal, double noise) {
+  if (signal <= 0.0) return -kMaxSnrDb;
+  if (noise <= signal * std::pow(10.0, -kMaxSnrDb / 10.0)) return kMaxSnrDb;
+  return 10.0 * std::log10(signal / noise);
+}
+
+static double errorEnergy(const float* ref, const float* est, size_t n) {
+  double e = 0.0;
+  for (size_t i = 0; i < n; i++) {
+    double d = static_cast<double>(ref[i]) - est[i];
+    e += d * d;
+  }
+  return e;
+}
+
+double snrDb(const float* ref, const float* est, size_t n) {
+  return ratioDb(frameEnergy(ref, n), errorEnergy(ref, est, n));
+}
+
+double segmentalSnrDb(const float* ref, const float* est, size_t n, size_t frameSize) {
+  const double silence = kSegSilenceRms * kSegSilenceRms * static_cast<double>(frameSize);
+  double sum = 0.0;
+  size_t counted = 0;
+  for (size_t off = 0; off + frameSize <= n; off += frameSize) {
+    double signal = frameEnergy(ref + off, frameSize);
+    if (signal < silence) continue;
+    double db = ratioDb(signal, errorEnergy(ref + off, est + off, frameSize));
+    sum += std::clamp(db, kSegMinDb, kSegMaxDb);
+    counted++;
+  }
+  return counted ? sum / static_cast<double>(counted) : 0.0;
+}
+
+size_t estimateDelay(const float* ref, const float* est, size_t n, size_t maxLag,
+                     size_t window) {
+  if (n <= maxLag) return 0;
+  const size_t len = std::min(window, n - maxLag);
+  size_t best = 0;
+  double bestCorr = -1.0;
+  for (size_t lag = 0; lag <= maxLag; lag++) {
+    double c = 0.0;
+    for (size_t i = 0; i < len; i++) c += static_cast<double>(ref[i]) * est[i + lag];
+    if (c > bestCorr) {
+      bestCorr = c;
+      best = lag;
+    }
+  }
+  return best;
+}
+
+/* ── VAD ─────────────────────────────────────────────────────────────────── */
+
+VadScore scoreVad(const std::vector<float>& vad, const std::vector<uint8_t>& labels,
+                  float threshold) {
+  VadScore s;
+  s.frames = std::min(vad.size(), labels.size());
+  size_t correct = 0, speech = 0, missed = 0, silence = 0, falseAlarms = 0;
+  for (size_t i = 0; i < s.frames; i++) {
+    bool decision = vad[i] >= threshold;
+    bool label = labels[i] != 0;
+    if (decision == label) correct++;
+    if (label) {
+      speech++;
+      if (!decision) missed++;
+    } else {
+      silence++;
+      if (decision) falseAlarms++;
+    }
+  }
+  if (s.frames) s.accuracy = static_cast<double>(correct) / static_cast<double>(s.frames);
+  if (speech) s.missRate = static_cast<double>(missed) / static_cast<double>(speech);
+  if (silence) s.falseAlarmRate = static_cast<double>(falseAlarms) / static_cast<double>(silence);
+  return s;
+}
+
+}  // namespace ainoiceguard
@@ -0,0 +1,87 @@
+/**
+ * Offline quality metrics for evaluating denoiser configurations.
+ *
+ * Used by the quality_eval harness (native/bench) to score RNNoiseWrapper
+ * variants on clean + noise mixtures, where the clean signal is the
+ * reference:
+ *
+ *   snrDb()           Global SNR of an estimate against the reference.
+ *                     SNR improvement = snrDb(clean, output) -
+ *                     snrDb(clean, noisy).
+ *   segmentalSnrDb()  Mean per-frame SNR over frames where the reference
+ *                     is active, each clamped to [-10, 35] dB so silent
+ *                     or perfect frames do not dominate.
+ *   estimateDelay()   Lag (samples) that best aligns an output with its
+ *                     reference, for pipelines with algorithmic delay.
+ *   scoreVad()        Per-frame VAD decisions against 0/1 labels.
+ *
+ * readWav() loads PCM 16 / 24 / 32-bit and IEEE float WAV files, mixing
+ * multi-channel input down to mono. readLabels() reads speech segments
+ * in Audacity label-track format ("start<TAB>end[<TAB>text]", seconds).
+ *
+ * Not real-time code: everything here allocates.
+ */
+
+#ifndef AINOICEGUARD_QUALITY_METRICS_H
+#define AINOICEGUARD_QUALITY_METRICS_H
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+namespace ainoiceguard {
+
+struct WavData {
+  uint32_t sampleRate = 0;
+  std::vector<float> samples;  /* Mono, [-1, 1] */
+};
+
+/** Returns empty string on success, or an error message. */
+std::string readWav(const std::string& path, WavData* out);
+
+/**
+ * Speech segments -> one 0/1 label per frame of `frameSize` samples
+ * (a frame is speech when at least half of it lies inside a segment).
+ * Returns empty string on success, or an error message.
+ */
+std::string readLabels(const std::string& path, double sampleRate, size_t frameSize,
+                       size_t frames, std::vector<uint8_t>* labels);
+
+/**
+ * Labels from the clean reference itself: a frame is speech when its RMS
+ * is within `rangeDb` of the loudest frame. For corpora without labels.
+ */
+std::vector<uint8_t> energyLabels(const float* clean, size_t n, size_t frameSize,
+                                  float rangeDb = 30.0f);
+
+/**
+ * 10·log10(Σref² / Σ(ref − est)²) over n samples. +inf-safe: capped at
+ * 100 dB for identical signals.
+ */
+double snrDb(const float* ref, const float* est, size_t n);
+
+/** See the file comment. Frames with reference RMS below -50 dBFS are skipped. */
+double segmentalSnrDb(const float* ref, const float* est, size_t n, size_t frameSize);
+
+/**
+ * Lag in [0, maxLag] maximizing Σ ref[i]·est[i + lag] over the first
+ * `window` samples. est is assumed to trail ref.
+ */
+size_t estimateDelay(const float* ref, const float* est, size_t n, size_t maxLag,
+                     size_t window);
+
+struct VadScore {
+  double accuracy = 0.0;       /* Frames where decision == label */
+  double missRate = 0.0;       /* Speech frames judged non-speech */
+  double falseAlarmRate = 0.0; /* Non-speech frames judged speech */
+  size_t frames = 0;
+};
+
+/** Decision = vad[i] >= threshold. Scores min(vad.size(), labels.size()) frames. */
+VadScore scoreVad(const std::vector<float>& vad, const std::vector<uint8_t>& labels,
+                  float threshold);
+
+}  // namespace ainoiceguard
+
+#endif  // AINOICEGUARD_QUALITY_METRICS_H
@@ -78,8 +78,28 @@ class RingBuffer {
     return count;
   }
 
+  /**
+   * Consumer side: drop up to count of the oldest samples without copying
+   * them out. Returns number actually dropped.
+   */
+  size_t discard(size_t count) {
+    size_t r = read_idx_.load(std::memory_order_relaxed);
+    size_t w = write_idx_.load(std::memory_order_acquire);
+    size_t used = (w >= r) ? (w - r) : (capacity_ - (r - w));
+    if (count > used) count = used;
+    if (count == 0) return 0;
+    read_idx_.store(r + count, std::memory_order_release);
+    return count;
+  }
+
   size_t capacity() const { return capacity_; }
 
+  /** Drop all contents. Only while neither producer nor consumer is active. */
+  void reset() {
+    read_idx_.store(0, std::memory_order_relaxed);
+    write_idx_.store(0, std::memory_order_relaxed);
+  }
+
  private:
   const size_t capacity_;
   const size_t mask_;
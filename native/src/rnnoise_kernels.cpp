@@ -0,0 +1,124 @@
+/**
+ * RNNoise copy tables + one-time CPU feature dispatch. See rnnoise_kernels.h.
+ *
+ * The generic copy keeps RNNoise's own symbol names. The AVX2 and AVX-512
+ * copies exist only in x86-64 builds that produced them (see
+ * NOISEGUARD_RNNOISE_DISPATCH in native/CMakeLists.txt); the generated
+ * rnnoise_build_info.h says which, and this file declares their prefixed
+ * entry points to match.
+ */
+
+#include "rnnoise_kernels.h"
+
+#include "cpu_features.h"
+#include "rnnoise.h"
+
+/*
+ * Generated at configure time and installed with librnnoise. Guessing
+ * here would leave linked-in copies unused, or reference missing ones.
+ */
+#if !__has_include("rnnoise_build_info.h")
+#error "rnnoise_build_info.h not found: run the CMake step (native/CMakeLists.txt) first"
+#else
+#include "rnnoise_build_info.h"
+#if !defined(NOISEGUARD_RNNOISE_AVX2) || !defined(NOISEGUARD_RNNOISE_AVX512)
+#error "rnnoise_build_info.h predates runtime RNNoise dispatch: re-run the CMake step"
+#endif
+#endif
+
+/* Entry points of one prefixed copy (noiseguard_<isa>_rnnoise_*). */
+#define NG_RNNOISE_DECLARE(isa)                                              \
+  extern "C" {                                                               \
+  DenoiseState* noiseguard_##isa##_rnnoise_create(RNNModel* model);          \
+  void noiseguard_##isa##_rnnoise_destroy(DenoiseState* st);                 \
+  float noiseguard_##isa##_rnnoise_process_frame(                            \
+      DenoiseState* st, float* out, const float* in);                        \
+  RNNModel* noiseguard_##isa##_rnnoise_model_from_file(FILE* f);             \
+  void noiseguard_##isa##_rnnoise_model_free(RNNModel* model);               \
+  }
+
+#define NG_RNNOISE_TABLE(isa)                                                \
+  {                                                                          \
+    #isa,                                                                    \
+    noiseguard_##isa##_rnnoise_create,                                       \
+    noiseguard_##isa##_rnnoise_destroy,                                      \
+    noiseguard_##isa##_rnnoise_process_frame,                                \
+    noiseguard_##isa##_rnnoise_model_from_file,                              \
+    noiseguard_##isa##_rnnoise_model_free,                                   \
+  }
+
+#if NOISEGUARD_RNNOISE_AVX2
+NG_RNNOISE_DECLARE(avx2)
+#endif
+#if NOISEGUARD_RNNOISE_AVX512
+NG_RNNOISE_DECLARE(avx512)
+#endif
+
+namespace ainoiceguard {
+
+namespace {
+
+const RNNoiseKernels kGenericRNNoise = {
+    "generic",
+    rnnoise_create,
+    rnnoise_destroy,
+    rnnoise_process_frame,
+    rnnoise_model_from_file,
+    rnnoise_model_free,
+};
+
+#if NOISEGUARD_RNNOISE_AVX2
+const RNNoiseKernels kAvx2RNNoise = NG_RNNOISE_TABLE(avx2);
+
+/* Same features the copy was compiled for: -mavx2 -mfma. */
+bool cpuRunsAvx2() {
+  const CpuFeatures& cpu = cpuFeatures();
+  return cpu.avx2 && cpu.fma;
+}
+#endif
+
+#if NOISEGUARD_RNNOISE_AVX512
+const RNNoiseKernels kAvx512RNNoise = NG_RNNOISE_TABLE(avx512);
+
+/* -mavx512f -mavx512bw -mfma. */
+bool cpuRunsAvx512() {
+  const CpuFeatures& cpu = cpuFeatures();
+  return cpu.avx512f && cpu.avx512bw && cpu.fma;
+}
+#endif
+
+const RNNoiseKernels& selectRNNoise() {
+#if NOISEGUARD_RNNOISE_AVX512
+  if (cpuRunsAvx512()) return kAvx512RNNoise;
+#endif
+#if NOISEGUARD_RNNOISE_AVX2
+  if (cpuRunsAvx2()) return kAvx2RNNoise;
+#endif
+  return kGenericRNNoise;
+}
+
+}  // namespace
+
+/* ═══════════════════════════════════════════════════════════════════════════
+ *  DISPATCH
+ * ═══════════════════════════════════════════════════════════════════════════ */
+
+const RNNoiseKernels& rnnoiseKernels() {
+  /* Thread-safe one-time initialization (C++11 magic static). */
+  static const RNNoiseKernels& selected = selectRNNoise();
+  return selected;
+}
+
+std::vector<const RNNoiseKernels*> supportedRNNoiseKernels() {
+  std::vector<const RNNoiseKernels*> tables;
+  tables.push_back(&kGenericRNNoise);
+#if NOISEGUARD_RNNOISE_AVX2
+  if (cpuRunsAvx2()) tables.push_back(&kAvx2RNNoise);
+#endif
+#if NOISEGUARD_RNNOISE_AVX512
+  if (cpuRunsAvx512()) tables.push_back(&kAvx512RNNoise);
+#endif
+  return tables;
+}
+
+}  // namespace ainoiceguard
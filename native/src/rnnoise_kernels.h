@@ -0,0 +1,63 @@
+/**
+ * RNNoise compiled per instruction set, with runtime CPU dispatch.
+ *
+ * RNNoise's dense, GRU and FFT loops are plain C that the compiler
+ * vectorizes only for the ISA it targets, and a fleet build cannot target
+ * more than the baseline. On x86-64, native/CMakeLists.txt compiles the
+ * RNNoise sources once per ISA (generic, AVX2+FMA, AVX-512F/BW) into one
+ * librnnoise; each extra copy has its symbols prefixed
+ * (noiseguard_avx2_rnnoise_create, ...). This module holds each copy's
+ * entry points in a table and picks the best table ONCE for the host CPU,
+ * like dspKernels() does for our own loops.
+ *
+ * Usage:
+ *   const RNNoiseKernels& rnn = rnnoiseKernels();   // resolved on first call
+ *   DenoiseState* st = rnn.create(nullptr);
+ *   float vad = rnn.processFrame(st, out, in);
+ *
+ * A DenoiseState or RNNModel belongs to the copy that created it: free
+ * it, and pass it back in, through the same table. Every user goes through
+ * rnnoiseKernels(), which never changes once resolved.
+ *
+ * REAL-TIME RULES:
+ * - processFrame is real-time safe (RNNoise allocates nothing per frame);
+ *   create / destroy / modelFromFile / modelFree allocate.
+ * - rnnoiseKernels() performs CPU detection on its first call only. Call
+ *   it from init() (not the audio thread).
+ */
+
+#ifndef AINOICEGUARD_RNNOISE_KERNELS_H
+#define AINOICEGUARD_RNNOISE_KERNELS_H
+
+#include <cstdio>
+#include <vector>
+
+/* Forward-declare RNNoise opaque types. */
+struct DenoiseState;
+struct RNNModel;
+
+namespace ainoiceguard {
+
+/** RNNoise's public API, as compiled for one instruction set. */
+struct RNNoiseKernels {
+  const char* name;  /* "generic", "avx2", "avx512" */
+
+  DenoiseState* (*create)(RNNModel* model);                /* nullptr = built-in model */
+  void (*destroy)(DenoiseState* st);
+  float (*processFrame)(DenoiseState* st, float* out, const float* in);  /* Returns VAD */
+  RNNModel* (*modelFromFile)(FILE* f);
+  void (*modelFree)(RNNModel* model);
+};
+
+/** Best RNNoise copy for the running CPU (detected once, then cached). */
+const RNNoiseKernels& rnnoiseKernels();
+
+/**
+ * Every RNNoise copy linked in AND supported by this CPU, generic first.
+ * Used by the tests and benchmarks. NOT real-time safe.
+ */
+std::vector<const RNNoiseKernels*> supportedRNNoiseKernels();
+
+}  // namespace ainoiceguard
+
+#endif  // AINOICEGUARD_RNNOISE_KERNELS_H
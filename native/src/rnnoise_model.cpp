@@ -0,0 +1,126 @@
+/**
+ * RNNoiseModel implementation. See rnnoise_model.h.
+ */
+
+#include "rnnoise_model.h"
+
+#include <cstdint>
+#include <cstdio>
+#include <iterator>
+#include <map>
+#include <mutex>
+#include <utility>
+#include <vector>
+
+#include "rnnoise_kernels.h"
+
+namespace ainoiceguard {
+
+namespace {
+
+/*
+ * Process-wide cache: path -> live model and the file contents it was
+ * parsed from. Entries expire with the model and are swept on the next
+ * load(); a file rewritten in place no longer matches and gets a fresh
+ * entry.
+ */
+struct CacheEntry {
+  std::weak_ptr<const RNNoiseModel> model;
+  size_t fileBytes;
+  uint64_t contentHash;
+};
+
+std::mutex g_cacheMutex;
+std::map<std::string, CacheEntry> g_cache;
+
+/* The whole file at `path`. Returns false if it cannot be opened or read. */
+bool readFile(const std::string& path, std::vector<unsigned char>* bytes) {
+  FILE* f = std::fopen(path.c_str(), "rb");
+  if (!f) return false;
+  unsigned char buf[4096];
+  size_t n;
+  while ((n = std::fread(buf, 1, sizeof(buf), f)) > 0) bytes->insert(bytes->end(), buf, buf + n);
+  const bool ok = !std::ferror(f);
+  std::fclose(f);
+  return ok;
+}
+
+/* FNV-1a. */
+uint64_t hashBytes(const std::vector<unsigned char>& bytes) {
+  uint64_t h = 14695981039346656037ull;
+  for (unsigned char c : bytes) {
+    h ^= c;
+    h *= 1099511628211ull;
+  }
+  return h;
+}
+
+/*
+ * A read-only FILE* over `bytes`, for RNNoise's FILE*-only parser. POSIX
+ * reads the buffer in place; Windows has no fmemopen, so the bytes go
+ * through an anonymous temp file (never the model path again).
+ */
+FILE* openBytes(std::vector<unsigned char>& bytes) {
+#ifdef _WIN32
+  FILE* f = std::tmpfile();
+  if (f && (std::fwrite(bytes.data(), 1, bytes.size(), f) != bytes.size() ||
+            std::fseek(f, 0, SEEK_SET) != 0)) {
+    std::fclose(f);
+    return nullptr;
+  }
+  return f;
+#else
+  return fmemopen(bytes.data(), bytes.size(), "rb");
+#endif
+}
+
+}  // namespace
+
+RNNoiseModel::RNNoiseModel(RNNModel* model, std::string path, size_t fileBytes)
+    : model_(model), path_(std::move(path)), fileBytes_(fileBytes) {}
+
+RNNoiseModel::~RNNoiseModel() {
+  rnnoiseKernels().modelFree(model_);
+}
+
+std::string RNNoiseModel::load(const std::string& path,
+                               std::shared_ptr<const RNNoiseModel>* out) {
+  if (path.empty()) return "Model path is empty";
+
+  /* Read once: the cache key and the parsed weights come from the same bytes. */
+  std::vector<unsigned char> bytes;
+  if (!readFile(path, &bytes)) return "Cannot read model file: " + path;
+  const uint64_t hash = hashBytes(bytes);
+
+  std::lock_guard<std::mutex> lock(g_cacheMutex);
+
+  /* Drop entries whose model every holder has released. */
+  for (auto e = g_cache.begin(); e != g_cache.end();) {
+    e = e->second.model.expired() ? g_cache.erase(e) : std::next(e);
+  }
+
+  auto it = g_cache.find(path);
+  if (it != g_cache.end() && it->second.fileBytes == bytes.size() &&
+      it->second.contentHash == hash) {
+    if (auto cached = it->second.model.lock()) {
+      *out = std::move(cached);
+      return "";
+    }
+  }
+
+  RNNModel* model = nullptr;
+  if (!bytes.empty()) {
+    if (FILE* f = openBytes(bytes)) {
+      model = rnnoiseKernels().modelFromFile(f);
+      std::fclose(f);
+    }
+  }
+  if (!model) return "Invalid RNNoise model file: " + path;
+
+  std::shared_ptr<const RNNoiseModel> loaded(new RNNoiseModel(model, path, bytes.size()));
+  g_cache[path] = CacheEntry{loaded, bytes.size(), hash};
+  *out = std::move(loaded);
+  return "";
+}
+
+}  // namespace ainoiceguard
@@ -0,0 +1,70 @@
+/**
+ * Shared, refcounted RNNoise model weights.
+ *
+ * rnnoise_create(nullptr) uses the model compiled into the library. An
+ * alternate model (e.g. one trained on our office noise) is loaded from a
+ * file with rnnoise_model_from_file(); every DenoiseState created from it
+ * only stores a pointer to the weights plus its own recurrent state.
+ * Loading and freeing go through rnnoiseKernels(), the same RNNoise copy
+ * the wrapper creates its states from.
+ *
+ * RNNoiseModel owns one loaded model. load() keeps a process-wide cache
+ * keyed by path and file contents (size + hash), so every wrapper that
+ * asks for the same file shares ONE copy of the weights, while a file
+ * rewritten in place (a retuned model hot-swapped under the same name)
+ * loads fresh. The model is freed when the last holder releases its
+ * shared_ptr. Holders must destroy their DenoiseStates before dropping
+ * the reference (RNNoiseWrapper::destroy() does).
+ *
+ * REAL-TIME RULES:
+ * - load() reads (and on a cache miss parses) a file and takes a mutex.
+ *   Call it from init() or a control thread, never from the audio path.
+ * - get() is a plain pointer read.
+ */
+
+#ifndef AINOICEGUARD_RNNOISE_MODEL_H
+#define AINOICEGUARD_RNNOISE_MODEL_H
+
+#include <cstddef>
+#include <memory>
+#include <string>
+
+/* Forward-declare RNNoise opaque type. */
+struct RNNModel;
+
+namespace ainoiceguard {
+
+class RNNoiseModel {
+ public:
+  ~RNNoiseModel();
+
+  RNNoiseModel(const RNNoiseModel&) = delete;
+  RNNoiseModel& operator=(const RNNoiseModel&) = delete;
+
+  /**
+   * Load the model file at `path`, or reuse the cached copy if the file
+   * still has the contents it was loaded from.
+   * Returns empty string on success, or an error message.
+   */
+  static std::string load(const std::string& path,
+                          std::shared_ptr<const RNNoiseModel>* out);
+
+  /** Weights to pass to rnnoise_create(). */
+  RNNModel* get() const { return model_; }
+
+  const std::string& path() const { return path_; }
+
+  /** Size of the model file on disk (bytes). */
+  size_t fileBytes() const { return fileBytes_; }
+
+ private:
+  RNNoiseModel(RNNModel* model, std::string path, size_t fileBytes);
+
+  RNNModel* model_;
+  std::string path_;
+  size_t fileBytes_;
+};
+
+}  // namespace ainoiceguard
+
+#endif  // AINOICEGUARD_RNNOISE_MODEL_H
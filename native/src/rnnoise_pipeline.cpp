@@ -0,0 +1,186 @@
+/**
+ * RNNoisePipeline implementation. See rnnoise_pipeline.h.
+ */
+
+#include "rnnoise_pipeline.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cstring>
+#include <functional>
+
+namespace ainoiceguard {
+
+namespace {
+
+uint32_t elapsedUs(std::chrono::steady_clock::time_point t0) {
+  return static_cast<uint32_t>(std::chrono::duration_cast<std::chrono::microseconds>(
+      std::chrono::steady_clock::now() - t0).count());
+}
+
+}  // namespace
+
+void RNNoisePipeline::start(RNNoiseWrapper* stream) {
+  stop();
+
+  /* Workers are joined: every queue is ours. Return all slots to the pool. */
+  uint32_t slot;
+  while (free_.pop(slot)) {}
+  while (toPass1_.pop(slot)) {}
+  while (toPass2_.pop(slot)) {}
+  while (toPost_.pop(slot)) {}
+  for (uint32_t i = 0; i < kDepth; i++) free_.push(i);
+
+  for (int s = 0; s < PipelineStats::kStageCount; s++) {
+    maxDepth_[s].store(0, std::memory_order_relaxed);
+    stageUs_[s].store(0, std::memory_order_relaxed);
+  }
+  framesIn_.store(0, std::memory_order_relaxed);
+  framesOut_.store(0, std::memory_order_relaxed);
+
+  stream_ = stream;
+  for (auto& s : stopping_) s.store(false, std::memory_order_relaxed);
+  workers_[0] = std::thread(&RNNoisePipeline::runStage, this, PipelineStage::kPass1,
+                            std::ref(toPass1_), std::ref(toPass2_), std::cref(stopping_[0]));
+  workers_[1] = std::thread(&RNNoisePipeline::runStage, this, PipelineStage::kPass2,
+                            std::ref(toPass2_), std::ref(toPost_), std::cref(stopping_[1]));
+  running_.store(true, std::memory_order_release);
+}
+
+void RNNoisePipeline::stop() {
+  if (!running_.load(std::memory_order_acquire)) return;
+
+  /* In stage order: pass 2 exits only once pass 1 can feed it nothing more. */
+  for (int s = 0; s < 2; s++) {
+    stopping_[s].store(true, std::memory_order_release);
+    if (workers_[s].joinable()) workers_[s].join();
+  }
+  running_.store(false, std::memory_order_release);
+  stream_ = nullptr;
+}
+
+/*
+ * Worker loop for pass 1 / pass 2. Every slot index fits in every queue
+ * (capacity kDepth), so pushing downstream never fails. A worker asked to
+ * stop first empties its input: a committed model swap must reach pass 2
+ * (see MODEL TIERS + HOT-SWAP in rnnoise_wrapper.cpp).
+ */
+void RNNoisePipeline::runStage(PipelineStage stage, IndexQueue& in, IndexQueue& out,
+                               const std::atomic<bool>& stopping) {
+  const int s = static_cast<int>(stage);
+  const PipelineStage next = static_cast<PipelineStage>(s + 1);
+  int idle = 0;
+
+  for (;;) {
+    uint32_t i;
+    if (!in.pop(i)) {
+      if (stopping.load(std::memory_order_acquire) && in.empty()) return;
+      if (++idle <= kSpinYields) {
+        std::this_thread::yield();
+      } else {
+        std::this_thread::sleep_for(std::chrono::microseconds(kIdleSleepUs));
+      }
+      continue;
+    }
+    idle = 0;
+
+    Slot& slot = slots_[i];
+    const auto t0 = std::chrono::steady_clock::now();
+    if (stage == PipelineStage::kPass1) {
+      slot.infer = stream_->beginFrame(slot.frame, slot.ctx);
+      slot.vad = slot.infer ? stream_->runPrimaryPass(slot.frame, slot.ctx) : 0.0f;
+    } else if (slot.infer) {
+      slot.vad = std::max(slot.vad, stream_->runSecondPass(slot.frame, slot.vad, slot.ctx));
+    } else {
+      stream_->skipSecondPass(slot.ctx);
+    }
+    slot.stageUs[s] = elapsedUs(t0);
+    stageUs_[s].store(slot.stageUs[s], std::memory_order_relaxed);
+
+    pushNoted(out, i, next);
+  }
+}
+
+/* Push, then note the queue's depth as seen by its producer. */
+void RNNoisePipeline::pushNoted(IndexQueue& q, uint32_t slot, PipelineStage stage) {
+  q.push(slot);
+  const int s = static_cast<int>(stage);
+  const uint32_t depth = static_cast<uint32_t>(q.size());
+  if (depth > maxDepth_[s].load(std::memory_order_relaxed)) {
+    maxDepth_[s].store(depth, std::memory_order_relaxed);
+  }
+}
+
+bool RNNoisePipeline::submit(const float* frame, uint64_t tag) {
+  uint32_t i;
+  if (!running() || !free_.pop(i)) return false;
+
+  Slot& slot = slots_[i];
+  std::memcpy(slot.frame, frame, sizeof(slot.frame));
+  slot.tag = tag;
+  framesIn_.fetch_add(1, std::memory_order_relaxed);
+  pushNoted(toPass1_, i, PipelineStage::kPass1);
+  return true;
+}
+
+bool RNNoisePipeline::collect(float* frame, Result* result) {
+  uint32_t i;
+  if (!running() || !toPost_.pop(i)) return false;
+
+  Slot& slot = slots_[i];
+  constexpr int kPost = static_cast<int>(PipelineStage::kPost);
+  const auto t0 = std::chrono::steady_clock::now();
+  if (slot.infer) {
+    stream_->finishFrame(slot.frame, slot.vad, slot.ctx);
+  } else {
+    stream_->finishFastPath(slot.frame, slot.ctx);
+  }
+  slot.stageUs[kPost] = elapsedUs(t0);
+  stageUs_[kPost].store(slot.stageUs[kPost], std::memory_order_relaxed);
+
+  std::memcpy(frame, slot.frame, sizeof(slot.frame));
+  if (result) {
+    result->tag = slot.tag;
+    result->vad = slot.vad;
+    std::copy(slot.stageUs, slot.stageUs + PipelineStats::kStageCount, result->stageUs);
+  }
+  free_.push(i);
+  framesOut_.fetch_add(1, std::memory_order_relaxed);
+  return true;
+}
+
+void RNNoisePipeline::process(float* frames, size_t count, float* vads) {
+  size_t in = 0;
+  size_t out = 0;
+  Result r;
+  while (out < count) {
+    bool progress = false;
+    while (in < count && submit(frames + in * kRNNoiseFrameSize, in)) {
+      in++;
+      progress = true;
+    }
+    while (collect(frames + out * kRNNoiseFrameSize, &r)) {
+      if (vads) vads[out] = r.vad;
+      out++;
+      progress = true;
+    }
+    if (!progress) std::this_thread::yield();
+  }
+}
+
+PipelineStats RNNoisePipeline::stats() const {
+  PipelineStats s;
+  s.running = running();
+  s.depth[static_cast<int>(PipelineStage::kPass1)] = static_cast<uint32_t>(toPass1_.size());
+  s.depth[static_cast<int>(PipelineStage::kPass2)] = static_cast<uint32_t>(toPass2_.size());
+  s.depth[static_cast<int>(PipelineStage::kPost)] = static_cast<uint32_t>(toPost_.size());
+  for (int i = 0; i < PipelineStats::kStageCount; i++) {
+    s.maxDepth[i] = maxDepth_[i].load(std::memory_order_relaxed);
+    s.stageUs[i] = stageUs_[i].load(std::memory_order_relaxed);
+  }
+  s.framesIn = framesIn_.load(std::memory_order_relaxed);
+  s.framesOut = framesOut_.load(std::memory_order_relaxed);
+  return s;
+}
+
+}  // namespace ainoiceguard
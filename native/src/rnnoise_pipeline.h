@@ -0,0 +1,170 @@
+/**
+ * Stage-pipelined RNNoise processing for one stream.
+ *
+ * processFrame() runs a frame's work back to back on one thread: pass 1,
+ * pass 2, then the post-filters. With heavy chains (both passes plus a
+ * filter bank and custom stages) that sum can approach the 10 ms frame
+ * period, while the other cores idle. This driver runs the phases of
+ * consecutive frames concurrently on three threads:
+ *
+ *   submit() ─▶ [pass 1 thread]   beginFrame + primary pass
+ *            ─▶ [pass 2 thread]   residual pass
+ *            ─▶ collect()          finishFrame / finishFastPath, on the caller
+ *
+ * Stages are connected by SPSC queues of slot indices into a fixed pool
+ * of kDepth frames, so a frame's samples and its per-frame context never
+ * move. Throughput is bounded by the slowest stage instead of the sum of
+ * all three, at the price of about one frame of extra latency (a frame
+ * is collected a stage or two after a serial run would have finished it).
+ * Output is bit-identical to processFrame(): each phase still sees frames
+ * in order and touches only its own state (see rnnoise_wrapper.h).
+ *
+ * REAL-TIME RULES:
+ * - submit() / collect() do NO allocations and never block: a full
+ *   pipeline rejects the frame, an empty one returns nothing.
+ * - start() / stop() create and join threads: NOT real-time safe.
+ * - While started, the wrapper must not be driven by anything else.
+ */
+
+#ifndef AINOICEGUARD_RNNOISE_PIPELINE_H
+#define AINOICEGUARD_RNNOISE_PIPELINE_H
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <thread>
+
+#include "rnnoise_wrapper.h"
+#include "spsc_queue.h"
+
+namespace ainoiceguard {
+
+/* Pipeline stages, in frame order. */
+enum class PipelineStage : int {
+  kPass1 = 0,  /* beginFrame + primary pass (worker thread) */
+  kPass2 = 1,  /* Residual pass (worker thread) */
+  kPost = 2,   /* Post-filters, gate, metrics (collect() caller) */
+};
+
+/**
+ * Queue depth and timing per stage. depth[s] counts frames waiting for
+ * stage s (not the one it is working on); maxDepth[s] is the peak since
+ * start().
+ */
+struct PipelineStats {
+  static constexpr int kStageCount = 3;
+  bool running = false;
+  uint32_t depth[kStageCount] = {};
+  uint32_t maxDepth[kStageCount] = {};
+  uint32_t stageUs[kStageCount] = {};  /* Last frame's time in each stage */
+  uint64_t framesIn = 0;               /* Submitted since start() */
+  uint64_t framesOut = 0;              /* Collected since start() */
+};
+
+class RNNoisePipeline {
+ public:
+  /* Frames in flight (pool size; also every queue's capacity). */
+  static constexpr size_t kDepth = 8;
+
+  /* An idle worker yields this many times before it starts sleeping. */
+  static constexpr int kSpinYields = 64;
+
+  /* Worker sleep while idle (µs): well below a frame period. */
+  static constexpr int kIdleSleepUs = 250;
+
+  /** What collect() hands back with a frame. */
+  struct Result {
+    uint64_t tag = 0;  /* As passed to submit() */
+    float vad = 0.0f;  /* processFrame()'s return value */
+    uint32_t stageUs[PipelineStats::kStageCount] = {};
+  };
+
+  RNNoisePipeline() = default;
+  ~RNNoisePipeline() { stop(); }
+
+  RNNoisePipeline(const RNNoisePipeline&) = delete;
+  RNNoisePipeline& operator=(const RNNoisePipeline&) = delete;
+
+  /**
+   * Start the worker threads on `stream` (initialized; processFrame() may
+   * already have run on it). Frames left over from a previous run are
+   * discarded.
+   */
+  void start(RNNoiseWrapper* stream);
+
+  /**
+   * Let the workers finish the frames they already hold, then join them.
+   * Frames not yet collected are dropped by the next start().
+   */
+  void stop();
+
+  bool running() const { return running_.load(std::memory_order_acquire); }
+
+  /**
+   * Queue a copy of one kRNNoiseFrameSize frame. Returns false (frame not
+   * taken) when kDepth frames are already in flight. `tag` comes back
+   * with the frame from collect().
+   */
+  bool submit(const float* frame, uint64_t tag = 0);
+
+  /** True when submit() would take a frame. */
+  bool canSubmit() const { return !free_.empty(); }
+
+  /**
+   * Finish the oldest frame that has cleared pass 2: run its post stage on
+   * the calling thread and copy it to `frame`. Returns false when none is
+   * ready. Call from the submit() thread.
+   */
+  bool collect(float* frame, Result* result = nullptr);
+
+  /** Frames submitted and not collected yet. */
+  size_t inFlight() const { return kDepth - free_.size(); }
+
+  /**
+   * Offline helper: run `count` consecutive frames IN-PLACE through the
+   * started pipeline, waiting as needed. If vads is non-null, vads[i]
+   * receives processFrame()'s return value for frame i.
+   */
+  void process(float* frames, size_t count, float* vads = nullptr);
+
+  /** Queue depths and stage times (lock-free, any thread). */
+  PipelineStats stats() const;
+
+ private:
+  struct Slot {
+    float frame[kRNNoiseFrameSize];
+    RNNoiseWrapper::FrameContext ctx;
+    bool infer;
+    float vad;
+    uint64_t tag;
+    uint32_t stageUs[PipelineStats::kStageCount];
+  };
+
+  using IndexQueue = SpscQueue<uint32_t, kDepth>;
+
+  void runStage(PipelineStage stage, IndexQueue& in, IndexQueue& out,
+                const std::atomic<bool>& stopping);
+  void pushNoted(IndexQueue& q, uint32_t slot, PipelineStage stage);
+
+  RNNoiseWrapper* stream_ = nullptr;
+  std::atomic<bool> running_{false};
+  Slot slots_[kDepth];
+  IndexQueue free_;      /* collect() → submit() */
+  IndexQueue toPass1_;   /* submit() → pass 1 */
+  IndexQueue toPass2_;   /* pass 1 → pass 2 */
+  IndexQueue toPost_;    /* pass 2 → collect() */
+
+  /* Stop the pass-1 thread before the pass-2 thread, so pass 2 drains everything. */
+  std::atomic<bool> stopping_[2] = {};
+  std::thread workers_[2];
+
+  /* Published for stats(). */
+  std::atomic<uint32_t> maxDepth_[PipelineStats::kStageCount] = {};
+  std::atomic<uint32_t> stageUs_[PipelineStats::kStageCount] = {};
+  std::atomic<uint64_t> framesIn_{0};
+  std::atomic<uint64_t> framesOut_{0};
+};
+
+}  // namespace ainoiceguard
+
+#endif  // AINOICEGUARD_RNNOISE_PIPELINE_H
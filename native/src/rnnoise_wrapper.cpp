@@ -2,8 +2,12 @@
  * Production-grade RNNoise wrapper with multi-stage post-processing.
  *
  * Processing chain (per 10ms frame):
- *   RNNoise (×2 passes) → HPF 80Hz → LPF 8kHz → Adaptive Noise Gate
- *   → Spectral Floor Clamp → Soft Silence Injection
+ *   RNNoise (×2 passes) → HPF 80Hz → LPF 8kHz → [Filter Bank]
+ *   → Adaptive Noise Gate → Spectral Floor Clamp → Soft Silence Injection
+ *
+ * Everything after RNNoise runs as two fused sweeps over the frame
+ * (see post_filter.h): the gate decision is the only data dependency
+ * that forces a split.
  *
  * Design goals:
  *   - Keyboard / fan / environmental noise: gated to true silence.
@@ -18,8 +22,13 @@
 #include <algorithm>
 #include <cmath>
 #include <cstring>
+#include <string>
+#include <utility>
 
-#include "rnnoise.h"
+#include "dsp_kernels.h"
+#include "filter_bank.h"
+#include "post_filter.h"
+#include "rnnoise_kernels.h"
 
 namespace ainoiceguard {
 
@@ -53,11 +62,12 @@ static constexpr float kMinGateGain = 0.0005f;
 
 /*
  * HOLD TIME: frames to keep the gate open after the last speech frame.
- * 15 frames × 10ms = 150ms.
+ * Default 15 frames × 10ms = 150ms (setGateHoldFrames()).
  * Catches trailing consonants, breaths, and short inter-word pauses.
  * Prevents gate "chattering" on natural speech rhythm.
+ * Capped at 1 s: longer holds stop gating between sentences at all.
  */
-static constexpr int kHoldFrames = 15;
+static constexpr int kMaxHoldFrames = 100;
 
 /*
  * VAD hysteresis band.
@@ -83,13 +93,15 @@ static constexpr float kCalibrationAlpha = 0.08f;
 static constexpr float kTrackingAlpha = 0.005f;
 
 /*
- * Gate threshold = noiseFloor × kFloorMultiplier.
+ * Gate threshold = noiseFloor × floor multiplier (setGateFloorMultiplier()).
  * Signals below this (AND low VAD) get gated out.
- * 1.3 = gate closes when signal is only 30% above the noise floor.
+ * Default 1.3 = gate closes when signal is only 30% above the noise floor.
  * Increase to 1.5-2.0 for more aggressive silencing; decrease to 1.1 for
  * more sensitivity (at the cost of occasionally letting noise through).
+ * Below 1.0 the gate would close on the noise floor itself.
  */
-static constexpr float kFloorMultiplier = 1.3f;
+static constexpr float kMinFloorMultiplier = 1.0f;
+static constexpr float kMaxFloorMultiplier = 4.0f;
 
 /*
  * Absolute minimum noise floor (~-70 dBFS).
@@ -122,46 +134,128 @@ static constexpr float kClampGateThreshold = 0.05f;
 
 /* ── Soft Silence (Comfort Noise) ────────────────────────────────────────── */
 
+/* Level and spectral shaping live with the generator: see ComfortNoise. */
+
 /*
- * Comfort noise amplitude: -70 dBFS = 0.0003.
- * Very low to avoid audible buzz/hiss; still prevents dead silence in headphones.
+ * Gate gain below which soft silence is injected.
+ * 0.1 = inject only when the gate is nearly or fully closed.
  */
-static constexpr float kSoftSilenceLevel = 0.0003f;
+static constexpr float kSoftSilenceGateThresh = 0.1f;
+
+/* ── Adaptive Second Pass ─────────────────────────────────────────────────── */
 
 /*
- * 1-pole lowpass shaping coefficient for comfort noise.
- * 0.92 → strong lowpass so noise is sub-bass rumble, not mid/high buzz or hiss.
+ * Pass-1 residual above which the second pass always runs: -60 dBFS.
+ * Below this the gate + clamp handle what is left and pass 2 buys nothing.
  */
-static constexpr float kNoiseShapeCoeff = 0.92f;
+static constexpr float kResidualAudible = 0.001f;
 
 /*
- * Gate gain below which soft silence is injected.
- * 0.1 = inject only when the gate is nearly or fully closed.
+ * Residual must exceed the learned floor by this factor (+6 dB) to count
+ * as "noise pass 1 missed" (keyboard bursts, door slams in a quiet room).
  */
-static constexpr float kSoftSilenceGateThresh = 0.1f;
+static constexpr float kResidualMargin = 2.0f;
+
+/* Lower bound for the learned residual floor (~-80 dBFS). */
+static constexpr float kResidualMinFloor = 0.0001f;
+
+/* Residual estimate EMA (fast) and floor tracking (fall fast, rise slow). */
+static constexpr float kResidualAlpha = 0.2f;
+static constexpr float kResidualFloorFall = 0.1f;
+static constexpr float kResidualFloorRise = 0.002f;
+
+/*
+ * Hangover: keep pass 2 running 30 frames (300ms) after the residual
+ * clears, so it doesn't flap on and off through short pauses.
+ */
+static constexpr int kPass2HangoverFrames = 30;
+
+/* Duty-cycle EMA: 0.01 → ~1s time constant at 100 frames/s. */
+static constexpr float kDutyCycleAlpha = 0.01f;
+
+/* ── Digital Silence Fast Path ───────────────────────────────────────────── */
+
+/*
+ * Input RMS at or below this (~-120 dBFS) is "digital silence": a hardware
+ * mute or a device delivering exact zeros. No real microphone noise floor
+ * gets anywhere near it.
+ */
+static constexpr float kDigitalSilenceRms = 1e-6f;
+
+/* ── Prewarm ─────────────────────────────────────────────────────────────── */
+
+/*
+ * Prewarm input: uniform noise at about -65 dBFS RMS. Loud enough to stay
+ * clear of the digital-silence fast path (which would skip inference),
+ * quiet enough that the one frame RNNoise still holds is inaudible.
+ */
+static constexpr float kPrewarmLevel = 0.001f;
 
 /* ═══════════════════════════════════════════════════════════════════════════
  *  LIFECYCLE
  * ═══════════════════════════════════════════════════════════════════════════ */
 
-RNNoiseWrapper::RNNoiseWrapper() = default;
+RNNoiseWrapper::RNNoiseWrapper()
+    : kernels_(&dspKernels()), rnnoise_(&rnnoiseKernels()) {}
 
-RNNoiseWrapper::~RNNoiseWrapper() { destroy(); }
+RNNoiseWrapper::~RNNoiseWrapper() {
+  destroy();
+  releaseBank(pendingBank_.exchange(nullptr, std::memory_order_acq_rel));
+  releaseBank(retiredBank_.exchange(nullptr, std::memory_order_acq_rel));
+}
 
-bool RNNoiseWrapper::init() {
+bool RNNoiseWrapper::init(std::shared_ptr<const RNNoiseModel> model,
+                          std::shared_ptr<const RNNoiseModel> littleModel) {
   if (state_) destroy();
 
-  state_  = rnnoise_create(nullptr);
-  state2_ = rnnoise_create(nullptr);
+  /* Both passes share one copy of the weights (nullptr = built-in model). */
+  model_ = std::move(model);
+  RNNModel* weights = model_ ? model_->get() : nullptr;
+  state_  = rnnoise_->create(weights);
+  state2_ = rnnoise_->create(weights);
+
+  littleModel_ = std::move(littleModel);
+  if (littleModel_) stateLittle_ = rnnoise_->create(littleModel_->get());
+
+  /* The tier selected before init() applies from the first frame. */
+  const bool little = effectiveModelTier() == ModelTier::kLittle;
+  primary_ = (little && stateLittle_) ? stateLittle_ : state_;
+  tierWarmup_ = 0;
+
+  resetProcessingState();
+  reclaimRetired();
+  applyPendingBank();  /* A bank set while stopped applies from frame one */
 
+  /* Warm start: gate from the first frame with the saved floor. */
+  if (hasWarmStart_) {
+    applyCalibration(warmStart_);
+    hasWarmStart_ = false;
+  }
+
+  ready_ = state_ != nullptr && state2_ != nullptr &&
+           (!littleModel_ || stateLittle_ != nullptr);
+  return ready_;
+}
+
+/* Gate, floor, filter and second-pass state + metrics, as for a fresh start. */
+void RNNoiseWrapper::resetProcessingState() {
   smoothGain_ = 1.0f;
   holdCounter_ = 0;
   noiseFloorEstimate_ = 0.0f;
   calibrationFrames_ = 0;
-  noiseState_ = 0x12345678;
-  prevNoise_ = 0.0f;
+  comfortNoise_.reset();
+
+  pass2Active_ = true;
+  pass2Hangover_ = kPass2HangoverFrames;  /* Let the residual estimate settle */
+  residualHot_ = true;
+  residualEstimate_ = 0.0f;
+  residualFloor_ = 0.0f;
+  std::memset(pass1Delay_, 0, sizeof(pass1Delay_));
+  silentFrames_ = 0;
 
   initFilters();
+  filterBank_.reset();
+  resetCustomStages();
 
   metrics_.framesProcessed.store(0, std::memory_order_relaxed);
   metrics_.inputRms.store(0.0f, std::memory_order_relaxed);
@@ -169,19 +263,67 @@ bool RNNoiseWrapper::init() {
   metrics_.vadProbability.store(0.0f, std::memory_order_relaxed);
   metrics_.currentGain.store(1.0f, std::memory_order_relaxed);
   metrics_.noiseFloor.store(0.0f, std::memory_order_relaxed);
+  metrics_.pass2Frames.store(0, std::memory_order_relaxed);
+  metrics_.pass2DutyCycle.store(1.0f, std::memory_order_relaxed);
+  metrics_.silentFrames.store(0, std::memory_order_relaxed);
+  metrics_.modelTier.store((stateLittle_ && primary_ == stateLittle_) ? 1 : 0,
+                           std::memory_order_relaxed);
+  metrics_.modelSwaps.store(0, std::memory_order_relaxed);
+  metrics_.qualityTier.store(qualityTier_.load(std::memory_order_relaxed),
+                             std::memory_order_relaxed);
+  metrics_.qualityTierChanges.store(0, std::memory_order_relaxed);
+  leanPlan_ = false;
+}
+
+/*
+ * First frames after init() are slow: the weights, the states and the
+ * kernels' code are all cold. Run them through the full pipeline on faint
+ * synthetic noise now, off the audio path, then put the gate, filters and
+ * metrics back to where init() left them. The DenoiseStates keep what
+ * they learned -- a quiet room, which is where the first real frame most
+ * likely comes from.
+ */
+void RNNoiseWrapper::prewarm(size_t frames) {
+  if (!ready_) return;
+  const Calibration saved = exportCalibration();
 
-  return state_ != nullptr && state2_ != nullptr;
+  float frame[kRNNoiseFrameSize];
+  uint32_t seed = 0x2545F491u;
+  for (size_t f = 0; f < frames; f++) {
+    for (size_t i = 0; i < kRNNoiseFrameSize; i++) {
+      seed = seed * 1664525u + 1013904223u;
+      frame[i] = kPrewarmLevel * static_cast<float>(static_cast<int32_t>(seed)) /
+                 2147483648.0f;
+    }
+    processFrame(frame);
+  }
+
+  resetProcessingState();
+  applyCalibration(saved);
 }
 
 void RNNoiseWrapper::destroy() {
-  if (state_)  { rnnoise_destroy(state_);  state_  = nullptr; }
-  if (state2_) { rnnoise_destroy(state2_); state2_ = nullptr; }
+  ready_ = false;
+  if (state_)  { rnnoise_->destroy(state_);  state_  = nullptr; }
+  if (state2_) { rnnoise_->destroy(state2_); state2_ = nullptr; }
+  if (stateLittle_) { rnnoise_->destroy(stateLittle_); stateLittle_ = nullptr; }
+  primary_ = nullptr;
+  warmupTarget_ = nullptr;
+
+  /* Swap records in any stage (processing has stopped). */
+  releaseSwap(swap_);
+  swap_ = nullptr;
+  releaseSwap(pendingSwap_.exchange(nullptr, std::memory_order_acq_rel));
+  reclaimRetired();
+
+  /* States reference the weights: release the models only after them. */
+  model_.reset();
+  littleModel_.reset();
 }
 
 /*
- * Set biquad coefficients for 48 kHz sample rate.
- * Computed offline using the Audio EQ Cookbook (Robert Bristow-Johnson)
- * with Butterworth Q = 1/sqrt(2) ≈ 0.7071.
+ * Design the fixed biquads for RNNoise's 48 kHz (see designBiquad(): Audio
+ * EQ Cookbook, Butterworth Q = 1/sqrt(2) ≈ 0.7071).
  */
 void RNNoiseWrapper::initFilters() {
   /*
@@ -192,11 +334,12 @@ void RNNoiseWrapper::initFilters() {
    *   w0    = 2π × 80 / 48000 = 0.01047
    *   alpha = sin(w0) / (2 × Q) = 0.00741
    */
-  hpf_.b0 =  0.992631f;
-  hpf_.b1 = -1.985261f;
-  hpf_.b2 =  0.992631f;
-  hpf_.a1 = -1.985199f;
-  hpf_.a2 =  0.985323f;
+  FilterSpec hp;
+  hp.type = FilterType::kHighPass;
+  hp.frequency = 80.0;
+  BiquadCoeffs c;
+  designBiquad(hp, kRNNoiseSampleRate, &c);
+  hpf_.setCoeffs(c);
   hpf_.reset();
 
   /*
@@ -210,11 +353,11 @@ void RNNoiseWrapper::initFilters() {
    *   w0    = 2π × 8000 / 48000 = π/3
    *   alpha = sin(w0) / (2 × Q) = 0.6124
    */
-  lpf_.b0 = 0.155029f;
-  lpf_.b1 = 0.310059f;
-  lpf_.b2 = 0.155029f;
-  lpf_.a1 = -0.620209f;
-  lpf_.a2 =  0.240326f;
+  FilterSpec lp;
+  lp.type = FilterType::kLowPass;
+  lp.frequency = 8000.0;
+  designBiquad(lp, kRNNoiseSampleRate, &c);
+  lpf_.setCoeffs(c);
   lpf_.reset();
 }
 
@@ -223,92 +366,654 @@ void RNNoiseWrapper::initFilters() {
  * ═══════════════════════════════════════════════════════════════════════════ */
 
 float RNNoiseWrapper::processFrame(float* frame) {
-  if (!state_ || !state2_) return 0.0f;
+  if (!beginFrame(frame, ctx_)) {
+    skipSecondPass(ctx_);
+    finishFastPath(frame, ctx_);
+    return 0.0f;
+  }
+
+  /* ── 3. Double-pass RNNoise (second pass scheduled by SecondPassMode) ── */
+  float vad1 = runPrimaryPass(frame, ctx_);
+  float vad2 = runSecondPass(frame, vad1, ctx_);
+
+  return finishFrame(frame, std::max(vad1, vad2), ctx_);
+}
 
-  float level = suppressionLevel_.load(std::memory_order_relaxed);
+/*
+ * Steps 1-2. Returns false when the frame takes a fast path (bypass /
+ * digital silence, see ctx.path) and needs no inference; finishFastPath()
+ * then produces its output.
+ */
+bool RNNoiseWrapper::beginFrame(float* frame, FrameContext& ctx) {
+  ctx.resumed = false;
+  ctx.residualSwap = nullptr;
+  if (!ready_) {
+    ctx.path = FramePath::kIdle;
+    return false;
+  }
+
+  ctx.level = suppressionLevel_.load(std::memory_order_relaxed);
 
   /* Fast path: suppression fully off → passthrough. */
-  if (level <= 0.0f) {
+  if (ctx.level <= 0.0f) {
+    ctx.path = FramePath::kBypass;
+    return false;
+  }
+
+  /* ── 1. Measure input RMS (raw mic level) ── */
+  float inputRms = computeRms(frame, kRNNoiseFrameSize);
+  metrics_.inputRms.store(inputRms, std::memory_order_relaxed);
+
+  /* Fast path: sustained digital silence → skip inference entirely. */
+  if (inputRms <= kDigitalSilenceRms) {
+    if (silentFrames_ < kDigitalSilenceFrames) {
+      silentFrames_++;
+    } else {
+      ctx.path = FramePath::kSilent;
+      return false;
+    }
+  } else if (silentFrames_ > 0) {
+    /* Signal is back; the later phases reset their memories (see DIGITAL SILENCE). */
+    ctx.resumed = silentFrames_ >= kDigitalSilenceFrames;
+    silentFrames_ = 0;
+  }
+
+  /* ── 2. Save original for blending at partial suppression ── */
+  kernels_->scaleCopy(frame, ctx.original, 32767.0f,   /* RNNoise expects int16 range. */
+                      kRNNoiseFrameSize);
+  ctx.path = FramePath::kInfer;
+  return true;
+}
+
+/* Output of a frame beginFrame() routed to a fast path. */
+void RNNoiseWrapper::finishFastPath(float* frame, const FrameContext& ctx) {
+  if (ctx.path == FramePath::kSilent) {
+    processDigitalSilence(frame);
+  } else if (ctx.path == FramePath::kBypass) {
     float rms = computeRms(frame, kRNNoiseFrameSize);
     metrics_.inputRms.store(rms, std::memory_order_relaxed);
     metrics_.outputRms.store(rms, std::memory_order_relaxed);
     metrics_.vadProbability.store(0.0f, std::memory_order_relaxed);
     metrics_.currentGain.store(1.0f, std::memory_order_relaxed);
     metrics_.framesProcessed.fetch_add(1, std::memory_order_relaxed);
-    return 0.0f;
   }
+}
 
-  /* ── 1. Measure input RMS (raw mic level) ── */
-  float inputRms = computeRms(frame, kRNNoiseFrameSize);
-  metrics_.inputRms.store(inputRms, std::memory_order_relaxed);
+/* ═══════════════════════════════════════════════════════════════════════════
+ *  MODEL TIERS + HOT-SWAP
+ *
+ *  kStandard: primary state_ + residual pass per SecondPassMode.
+ *  kLittle:   single pass (the residual pass exits through its usual
+ *             crossfade), on stateLittle_ when a little model was loaded,
+ *             otherwise on state_.
+ *
+ *  Switching the pass-1 state (tier change or model hot-swap): the
+ *  incoming state processes the same input in parallel for
+ *  kTierWarmupFrames while the outgoing one still feeds the output; both
+ *  carry RNNoise's one-frame delay, so their outputs are time-aligned and
+ *  the last warm-up frame crossfades outgoing → incoming.
+ *
+ *  Hot-swap hand-off (no allocation or free on the audio thread):
+ *    control thread  -- prepareModelSwap(): create states, publish to
+ *                       pendingSwap_.
+ *    audio thread    -- take pendingSwap_ at a frame boundary, warm up,
+ *                       crossfade, swap pointers INTO the record and park
+ *                       it in retired_. A kStandard swap also replaces
+ *                       state2_, which belongs to the second pass: the
+ *                       committing frame carries the record to
+ *                       runSecondPass(), which installs state2 and parks
+ *                       it (residualHandoff_ holds off the next swap).
+ *    control thread  -- reclaimRetired(): destroy the old states, drop
+ *                       the old model reference.
+ * ═══════════════════════════════════════════════════════════════════════════ */
 
-  /* ── 2. Save original for blending at partial suppression ── */
-  float original[kRNNoiseFrameSize];
-  for (size_t i = 0; i < kRNNoiseFrameSize; i++) {
-    original[i] = frame[i];
-    frame[i] *= 32767.0f;   /* RNNoise expects int16 range. */
+struct RNNoiseWrapper::ModelSwap {
+  ModelTier tier = ModelTier::kStandard;
+  std::shared_ptr<const RNNoiseModel> model;
+  DenoiseState* state = nullptr;
+  DenoiseState* state2 = nullptr;  /* kStandard only */
+};
+
+float RNNoiseWrapper::runPrimaryPass(float* frame, FrameContext& ctx) {
+  /*
+   * Take a published swap only once the previous one has been reclaimed
+   * (hand-off first: runSecondPass() parks the record before clearing it).
+   */
+  if (!swap_ && !residualHandoff_.load(std::memory_order_acquire) &&
+      !retired_.load(std::memory_order_acquire)) {
+    swap_ = pendingSwap_.exchange(nullptr, std::memory_order_acq_rel);
+  }
+  if (swap_) {
+    DenoiseState* slot = swap_->tier == ModelTier::kLittle ? stateLittle_ : state_;
+    if (slot != primary_) commitSwap(ctx);  /* Idle slot: nothing audible to fade */
   }
 
-  /* ── 3. Double-pass RNNoise ── */
-  float vad1 = rnnoise_process_frame(state_,  frame, frame);
-  float vad2 = rnnoise_process_frame(state2_, frame, frame);
-  float vad = std::max(vad1, vad2);
-  metrics_.vadProbability.store(vad, std::memory_order_relaxed);
+  const bool little = effectiveModelTier() == ModelTier::kLittle;
+  DenoiseState* target = swap_ ? swap_->state
+                               : (little && stateLittle_) ? stateLittle_ : state_;
 
-  /* Convert back to [-1.0, 1.0] float range. */
-  constexpr float kInvScale = 1.0f / 32767.0f;
-  for (size_t i = 0; i < kRNNoiseFrameSize; i++) {
-    frame[i] *= kInvScale;
+  if (target == primary_) {
+    tierWarmup_ = 0;
+    metrics_.modelTier.store(little ? 1 : 0, std::memory_order_relaxed);
+    return rnnoise_->processFrame(primary_, frame, frame);
   }
 
-  /* ── 4. Blend with original based on suppression level ── */
-  if (level < 1.0f) {
-    float dry = 1.0f - level;
-    for (size_t i = 0; i < kRNNoiseFrameSize; i++) {
-      frame[i] = frame[i] * level + original[i] * dry;
-    }
+  if (target != warmupTarget_) {
+    warmupTarget_ = target;
+    tierWarmup_ = 0;
+  }
+
+  const bool handOver = ++tierWarmup_ >= kTierWarmupFrames;
+
+  float incoming[kRNNoiseFrameSize];
+  float vadIn = rnnoise_->processFrame(target, incoming, frame);
+  if (swap_ && swap_->state2 && !handOver) {
+    /* Warm the new residual state on the new primary's output (on the
+     * hand-over frame runSecondPass() feeds it for real). */
+    float scratch[kRNNoiseFrameSize];
+    rnnoise_->processFrame(swap_->state2, scratch, incoming);
   }
+  float vadOut = rnnoise_->processFrame(primary_, frame, frame);
+  if (!handOver) return vadOut;
 
-  /* ── 5. Biquad filters: HPF (80 Hz) then LPF (8 kHz) ── */
+  constexpr float kFadeStep = 1.0f / static_cast<float>(kRNNoiseFrameSize);
   for (size_t i = 0; i < kRNNoiseFrameSize; i++) {
-    frame[i] = hpf_.process(frame[i]);
-    frame[i] = lpf_.process(frame[i]);
+    float w = static_cast<float>(i) * kFadeStep;
+    frame[i] = frame[i] * (1.0f - w) + incoming[i] * w;
+  }
+  if (swap_) {
+    commitSwap(ctx);
+  } else {
+    primary_ = target;
+  }
+  tierWarmup_ = 0;
+  warmupTarget_ = nullptr;
+  metrics_.modelTier.store(little ? 1 : 0, std::memory_order_relaxed);
+  return vadIn;
+}
+
+/*
+ * Install swap_'s pass-1 state; the record then holds the old one for
+ * reclaim. A kStandard record still carries the new state2 (and keeps the
+ * old weights alive for state2_): ctx hands it to runSecondPass().
+ */
+void RNNoiseWrapper::commitSwap(FrameContext& ctx) {
+  ModelSwap* s = swap_;
+  DenoiseState*& slot = s->tier == ModelTier::kLittle ? stateLittle_ : state_;
+  const bool wasPrimary = slot == primary_;
+
+  std::swap(slot, s->state);
+  if (s->tier == ModelTier::kLittle) {
+    littleModel_.swap(s->model);
+    retired_.store(s, std::memory_order_release);
+  } else {
+    model_.swap(s->model);
+    residualHandoff_.store(true, std::memory_order_release);
+    ctx.residualSwap = s;
   }
+  if (wasPrimary) primary_ = slot;
 
-  /* ── 6. Post-filter RMS (used for adaptive gate threshold) ── */
-  float postRms = computeRms(frame, kRNNoiseFrameSize);
+  swap_ = nullptr;
+  metrics_.modelSwaps.fetch_add(1, std::memory_order_relaxed);
+}
 
-  /* ── 7. Update adaptive noise floor ── */
-  updateNoiseFloor(postRms, vad);
+bool RNNoiseWrapper::prepareModelSwap(std::shared_ptr<const RNNoiseModel> model,
+                                      ModelTier tier) {
+  if (tier == ModelTier::kLittle && !model) return false;
+  reclaimRetired();
+
+  auto* s = new ModelSwap;
+  s->tier = tier;
+  s->model = std::move(model);
+  RNNModel* weights = s->model ? s->model->get() : nullptr;
+  s->state = rnnoise_->create(weights);
+  if (tier == ModelTier::kStandard) s->state2 = rnnoise_->create(weights);
+  if (!s->state || (tier == ModelTier::kStandard && !s->state2)) {
+    releaseSwap(s);
+    return false;
+  }
 
-  /* ── 8. Gate decision + hold timer ── */
-  float targetGain = computeGateTarget(vad, postRms);
+  /* A newer request supersedes one the audio thread has not taken yet. */
+  releaseSwap(pendingSwap_.exchange(s, std::memory_order_acq_rel));
+  return true;
+}
 
-  /* ── 9. Asymmetric gain smoothing (fast close, slow open) ── */
-  float coeff = (targetGain < smoothGain_) ? kGateCloseCoeff : kGateOpenCoeff;
-  smoothGain_ += coeff * (targetGain - smoothGain_);
-  smoothGain_ = std::clamp(smoothGain_, kMinGateGain, 1.0f);
-  metrics_.currentGain.store(smoothGain_, std::memory_order_relaxed);
+bool RNNoiseWrapper::swapPending() const {
+  return pendingSwap_.load(std::memory_order_acquire) != nullptr;
+}
 
-  /* ── 10. Apply gate gain ── */
-  for (size_t i = 0; i < kRNNoiseFrameSize; i++) {
-    frame[i] *= smoothGain_;
+bool RNNoiseWrapper::reclaimPending() const {
+  return retired_.load(std::memory_order_acquire) != nullptr;
+}
+
+void RNNoiseWrapper::reclaimRetired() {
+  releaseSwap(retired_.exchange(nullptr, std::memory_order_acq_rel));
+  releaseBank(retiredBank_.exchange(nullptr, std::memory_order_acq_rel));
+}
+
+void RNNoiseWrapper::releaseSwap(ModelSwap* s) {
+  if (!s) return;
+  /* Static: the states came from rnnoiseKernels(), same as rnnoise_. */
+  const RNNoiseKernels& rnn = rnnoiseKernels();
+  if (s->state) rnn.destroy(s->state);
+  if (s->state2) rnn.destroy(s->state2);
+  delete s;  /* Drops the model reference after its states are gone. */
+}
+
+/* ═══════════════════════════════════════════════════════════════════════════
+ *  FILTER BANK
+ *
+ *  Same hand-off as a model swap, minus the warm-up: setFilterBank()
+ *  designs the sections into a record and publishes it in pendingBank_;
+ *  the audio thread copies it into filterBank_ at the next frame boundary
+ *  and parks the record in retiredBank_ for reclaimRetired(). A retune
+ *  with the same section count keeps the filter state, so sweeping an EQ
+ *  gain does not click.
+ * ═══════════════════════════════════════════════════════════════════════════ */
+
+struct RNNoiseWrapper::BankUpdate {
+  BiquadCoeffs coeffs[FilterBank::kMaxSections];
+  size_t count = 0;
+};
+
+void RNNoiseWrapper::releaseBank(BankUpdate* u) { delete u; }
+
+std::string RNNoiseWrapper::setFilterBank(const std::vector<FilterSpec>& specs) {
+  if (specs.size() > FilterBank::kMaxSections) {
+    return "At most " + std::to_string(FilterBank::kMaxSections) +
+           " filter sections are supported";
+  }
+  auto* u = new BankUpdate;
+  for (size_t i = 0; i < specs.size(); i++) {
+    std::string err = designBiquad(specs[i], kRNNoiseSampleRate, &u->coeffs[i]);
+    if (!err.empty()) {
+      releaseBank(u);
+      return "Filter " + std::to_string(i) + ": " + err;
+    }
   }
+  u->count = specs.size();
+  reclaimRetired();
 
-  /* ── 11. Spectral floor clamp (when VAD low + gate closing) ── */
-  spectralClamp(frame, vad);
+  /* A newer bank supersedes one the audio thread has not taken yet. */
+  releaseBank(pendingBank_.exchange(u, std::memory_order_acq_rel));
+  bankSpecs_ = specs;
+  return "";
+}
 
-  /* ── 12. Soft silence (inject comfort noise when gate closed) ── */
-  applySoftSilence(frame);
+std::vector<FilterSpec> RNNoiseWrapper::getFilterBank() const {
+  return bankSpecs_;
+}
 
-  /* ── 13. Output RMS + metrics ── */
-  float outputRms = computeRms(frame, kRNNoiseFrameSize);
+void RNNoiseWrapper::applyPendingBank() {
+  if (retiredBank_.load(std::memory_order_acquire)) return;  /* Not reclaimed yet */
+  BankUpdate* u = pendingBank_.exchange(nullptr, std::memory_order_acq_rel);
+  if (!u) return;
+  filterBank_.setSections(u->coeffs, u->count);
+  retiredBank_.store(u, std::memory_order_release);
+}
+
+/* Steps 4-13. frame holds the RNNoise output (int16 range) on entry. */
+float RNNoiseWrapper::finishFrame(float* frame, float vad, const FrameContext& ctx) {
+  metrics_.vadProbability.store(vad, std::memory_order_relaxed);
+  if (ctx.resumed) {
+    hpf_.reset();
+    lpf_.reset();
+    filterBank_.reset();
+    resetCustomStages();
+  }
+  applyPendingBank();
+
+  StagePlan plan =
+      StagePlan::fromPacked(stagePlan_.load(std::memory_order_relaxed));
+  const bool lean = getQualityTier() >= QualityTier::kLeanFilters;
+  if (lean) {
+    plan = plan.lean();
+  } else if (leanPlan_) {
+    /* Dropped stages resume from silence, not from stale state. */
+    filterBank_.reset();
+    resetCustomStages();
+  }
+  leanPlan_ = lean;
+  float outSum = plan.fused() ? runFusedPlan(frame, vad, plan, ctx)
+                              : runStagePlan(frame, vad, plan, ctx);
+
+  /* ── 13. Output energy → metrics ── */
+  float outputRms = std::sqrt(outSum / static_cast<float>(kRNNoiseFrameSize));
   metrics_.outputRms.store(outputRms, std::memory_order_relaxed);
   metrics_.framesProcessed.fetch_add(1, std::memory_order_relaxed);
 
   return vad;
 }
 
+/* ═══════════════════════════════════════════════════════════════════════════
+ *  STAGE PLAN
+ *
+ *  Fused plans (built-ins in canonical order, the default among them) run
+ *  as the two passes of post_filter.h, each specialized for exactly the
+ *  stages present: a dropped filter is absent from the pass A loop, a
+ *  dropped clamp / comfort noise from pass B. Only the gate's scalar
+ *  bookkeeping is skipped by a per-frame branch.
+ *
+ *  Any other plan runs stage by stage in plan order, one block pass each:
+ *    kHighPass / kLowPass  biquad over the frame
+ *    kFilterBank           the section cascade (FilterBank::process)
+ *    kGate                 noise floor + gate decision on the RMS of the
+ *                          frame as it reaches the gate, then the gain
+ *    kSpectralClamp        clamp using the current gate gain (the previous
+ *                          frame's when placed before kGate)
+ *    kComfortNoise         noise scaled by the current gate gain
+ *    custom                FrameStage::process()
+ *  A plan without kGate ramps the gate fully open at the normal open rate
+ *  and stops learning the noise floor.
+ * ═══════════════════════════════════════════════════════════════════════════ */
+
+/* Returns the output sum of squares. */
+float RNNoiseWrapper::runFusedPlan(float* frame, float vad, StagePlan plan,
+                                   const FrameContext& ctx) {
+  /*
+   * ── 4-6. Pass A (one sweep): convert back to [-1.0, 1.0], blend with
+   *         original by suppression level, HPF (80 Hz) → LPF (8 kHz),
+   *         accumulate post-filter energy for the adaptive gate threshold.
+   */
+  constexpr float kInvScale = 1.0f / 32767.0f;
+  float postSum = fusedPreGatePass(
+      frame, ctx.original, kRNNoiseFrameSize, kInvScale, ctx.level,
+      plan.contains(StageId::kHighPass) ? &hpf_ : nullptr,
+      plan.contains(StageId::kLowPass) ? &lpf_ : nullptr);
+
+  /*
+   * EQ / hum notches: one block cascade (a no-op until sections are set).
+   * Kept out of pass A: its skewed kernel beats per-sample sections only
+   * once there are more than the two fixed ones.
+   */
+  if (plan.contains(StageId::kFilterBank) && filterBank_.size() > 0) {
+    postSum = filterBank_.process(frame, kRNNoiseFrameSize);
+  }
+
+  if (plan.contains(StageId::kGate)) {
+    float postRms = std::sqrt(postSum / static_cast<float>(kRNNoiseFrameSize));
+
+    /* ── 7. Update adaptive noise floor ── */
+    updateNoiseFloor(postRms, vad);
+
+    /* ── 8. Gate decision + hold timer ── */
+    float targetGain = computeGateTarget(vad, postRms);
+
+    /* ── 9. Asymmetric gain smoothing (fast close, slow open) ── */
+    smoothGateGain(targetGain);
+  } else {
+    smoothGateGain(1.0f);
+  }
+
+  /*
+   * ── 10-12. Pass B (one sweep): apply gate gain, spectral floor clamp
+   *           (when VAD low + gate closing), soft silence (comfort noise
+   *           when gate closed), accumulate output energy.
+   */
+  float clampThresh = plan.contains(StageId::kSpectralClamp)
+      ? spectralClampThreshold(vad) : 0.0f;
+  float noiseScale = plan.contains(StageId::kComfortNoise)
+      ? softSilenceScale() : 0.0f;
+  return fusedPostGatePass(frame, kRNNoiseFrameSize, smoothGain_,
+                           clampThresh, &comfortNoise_, noiseScale,
+                           *kernels_);
+}
+
+/* Returns the output sum of squares. */
+float RNNoiseWrapper::runStagePlan(float* frame, float vad, StagePlan plan,
+                                   const FrameContext& ctx) {
+  constexpr float kInvScale = 1.0f / 32767.0f;
+  constexpr size_t kN = kRNNoiseFrameSize;
+
+  /* Rescale + blend always lead: every stage works in [-1.0, 1.0]. */
+  float sum = fusedPreGatePass(frame, ctx.original, kN, kInvScale, ctx.level,
+                               nullptr, nullptr);
+  bool sumStale = false;  /* A custom stage changed the frame after `sum` */
+
+  const StageFrame noParams;
+  const size_t count = plan.size();
+  for (size_t i = 0; i < count; i++) {
+    switch (plan.at(i)) {
+      case StageId::kHighPass:
+        sum = StageChain<BiquadStage>(BiquadStage(&hpf_)).run(frame, kN, noParams);
+        break;
+      case StageId::kLowPass:
+        sum = StageChain<BiquadStage>(BiquadStage(&lpf_)).run(frame, kN, noParams);
+        break;
+      case StageId::kFilterBank:
+        if (filterBank_.size() == 0) continue;  /* Leaves `sum` as it was */
+        sum = filterBank_.process(frame, kN);
+        break;
+      case StageId::kGate: {
+        if (sumStale) sum = kernels_->sumSquares(frame, kN);
+        float rms = std::sqrt(sum / static_cast<float>(kN));
+        updateNoiseFloor(rms, vad);
+        smoothGateGain(computeGateTarget(vad, rms));
+        sum = fusedPostGatePass(frame, kN, smoothGain_, 0.0f, nullptr, 0.0f,
+                                *kernels_);
+        break;
+      }
+      case StageId::kSpectralClamp:
+        sum = fusedPostGatePass(frame, kN, 1.0f, spectralClampThreshold(vad),
+                                nullptr, 0.0f, *kernels_);
+        break;
+      case StageId::kComfortNoise:
+        sum = fusedPostGatePass(frame, kN, 1.0f, 0.0f, &comfortNoise_,
+                                softSilenceScale(), *kernels_);
+        break;
+      default: {
+        size_t slot = static_cast<size_t>(plan.at(i)) -
+                      static_cast<size_t>(StageId::kCustom0);
+        if (slot < customStageCount_) {
+          customStages_[slot]->process(frame, kN);
+          sumStale = true;
+          continue;
+        }
+        break;
+      }
+    }
+    sumStale = false;
+  }
+
+  if (!plan.contains(StageId::kGate)) smoothGateGain(1.0f);
+
+  return sumStale ? kernels_->sumSquares(frame, kN) : sum;
+}
+
+/* ═══════════════════════════════════════════════════════════════════════════
+ *  DIGITAL SILENCE
+ *
+ *  A hardware-muted mic delivers exact zeros, yet the full pipeline would
+ *  still run two RNNoise inferences, two biquads and comfort noise on
+ *  them. Once silence has lasted kDigitalSilenceFrames, frames bypass
+ *  inference and filters: the gate keeps evolving (so it closes exactly as
+ *  it would have), comfort noise is emitted, and metrics stay live.
+ *
+ *  The noise floor is deliberately NOT learned from these frames: a floor
+ *  trained on zeros would make the gate hyper-sensitive on unmute.
+ *
+ *  When signal is back (ctx.resumed), the DenoiseStates already hold the
+ *  settled-on-silence state they reached before the fast path engaged --
+ *  exactly what processing the skipped zeros would have produced -- so
+ *  inference simply resumes. Filter (finishFrame) and pass-2 delay
+ *  (runSecondPass) memories are zeroed to match the silent input they
+ *  would otherwise have seen.
+ * ═══════════════════════════════════════════════════════════════════════════ */
+
+void RNNoiseWrapper::processDigitalSilence(float* frame) {
+  metrics_.vadProbability.store(0.0f, std::memory_order_relaxed);
+  metrics_.noiseFloor.store(noiseFloorEstimate_, std::memory_order_relaxed);
+
+  StagePlan plan =
+      StagePlan::fromPacked(stagePlan_.load(std::memory_order_relaxed));
+
+  /* Gate sees a silent, speech-free frame. */
+  smoothGateGain(plan.contains(StageId::kGate) ? computeGateTarget(0.0f, 0.0f)
+                                               : 1.0f);
+
+  /*
+   * Emit gated silence + comfort noise (clamp is moot on zeros; custom
+   * stages are skipped along with the filters).
+   */
+  std::memset(frame, 0, kRNNoiseFrameSize * sizeof(float));
+  float noiseScale = plan.contains(StageId::kComfortNoise) ? softSilenceScale()
+                                                           : 0.0f;
+  float outSum = fusedPostGatePass(frame, kRNNoiseFrameSize, smoothGain_,
+                                   0.0f, &comfortNoise_, noiseScale,
+                                   *kernels_);
+  float outputRms = std::sqrt(outSum / static_cast<float>(kRNNoiseFrameSize));
+  metrics_.outputRms.store(outputRms, std::memory_order_relaxed);
+  metrics_.silentFrames.fetch_add(1, std::memory_order_relaxed);
+  metrics_.framesProcessed.fetch_add(1, std::memory_order_relaxed);
+}
+
+/* ═══════════════════════════════════════════════════════════════════════════
+ *  ADAPTIVE SECOND PASS
+ *
+ *  The residual pass doubles the dominant CPU cost, but in a quiet room
+ *  pass 1 already leaves nothing audible. In kAdaptive mode pass 2 runs
+ *  only while the pass-1 output of noise-only frames sits above a learned
+ *  floor (or above an absolute audibility level), plus a hangover.
+ *
+ *  Seamless switching relies on RNNoise's fixed one-frame output delay:
+ *    - Skipped frames emit the PREVIOUS pass-1 frame (pass1Delay_), so
+ *      the total latency is identical to running pass 2.
+ *    - Switching on: state2_ is re-primed with pass1Delay_ (refreshing its
+ *      analysis/synthesis memory and GRU state) before processing the
+ *      current frame, then the frame crossfades bypass → pass 2.
+ *    - Switching off: pass 2 runs one last time and the frame crossfades
+ *      pass 2 → bypass.
+ *
+ *  Returns vad2 (0 when pass 2 did not run). frame holds the pass-1 output
+ *  on entry and the frame to emit on exit (int16 range).
+ * ═══════════════════════════════════════════════════════════════════════════ */
+
+float RNNoiseWrapper::runSecondPass(float* frame, float vad1, const FrameContext& ctx) {
+  if (ctx.resumed) std::memset(pass1Delay_, 0, sizeof(pass1Delay_));
+  if (ModelSwap* s = ctx.residualSwap) {
+    /* Second half of a kStandard commit (see MODEL TIERS + HOT-SWAP). */
+    std::swap(state2_, s->state2);
+    retired_.store(s, std::memory_order_release);
+    residualHandoff_.store(false, std::memory_order_release);
+  }
+
+  auto mode = static_cast<SecondPassMode>(
+      secondPassMode_.load(std::memory_order_relaxed));
+  if (effectiveModelTier() == ModelTier::kLittle || catchUp_.load(std::memory_order_relaxed) ||
+      getQualityTier() >= QualityTier::kSinglePass) {
+    mode = SecondPassMode::kNever;
+  }
+
+  bool want;
+  switch (mode) {
+    case SecondPassMode::kAlways:   want = true; break;
+    case SecondPassMode::kNever:    want = false; pass2Hangover_ = 0; break;
+    default:                        want = residualNeedsSecondPass(frame, vad1); break;
+  }
+
+  if (mode != SecondPassMode::kNever) {
+    if (want) {
+      pass2Hangover_ = kPass2HangoverFrames;
+    } else if (pass2Hangover_ > 0) {
+      pass2Hangover_--;
+      want = true;
+    }
+  }
+
+  constexpr float kFadeStep = 1.0f / static_cast<float>(kRNNoiseFrameSize);
+  float vad2 = 0.0f;
+  bool ran = false;
+
+  if (want) {
+    float pass1[kRNNoiseFrameSize];
+    std::memcpy(pass1, frame, sizeof(pass1));
+
+    if (!pass2Active_) {
+      /* Re-prime: replay the frame pass 2 would have seen last time. */
+      float scratch[kRNNoiseFrameSize];
+      rnnoise_->processFrame(state2_, scratch, pass1Delay_);
+    }
+
+    vad2 = rnnoise_->processFrame(state2_, frame, frame);
+    ran = true;
+
+    if (!pass2Active_) {
+      /* Crossfade bypass (previous pass-1 frame) → pass 2. */
+      for (size_t i = 0; i < kRNNoiseFrameSize; i++) {
+        float w = static_cast<float>(i) * kFadeStep;
+        frame[i] = pass1Delay_[i] * (1.0f - w) + frame[i] * w;
+      }
+    }
+
+    std::memcpy(pass1Delay_, pass1, sizeof(pass1));
+    pass2Active_ = true;
+  } else if (pass2Active_) {
+    /* Last pass-2 frame, crossfaded pass 2 → bypass. */
+    float pass2[kRNNoiseFrameSize];
+    vad2 = rnnoise_->processFrame(state2_, pass2, frame);
+    ran = true;
+
+    for (size_t i = 0; i < kRNNoiseFrameSize; i++) {
+      float w = static_cast<float>(i) * kFadeStep;
+      float bypass = pass1Delay_[i];
+      pass1Delay_[i] = frame[i];
+      frame[i] = pass2[i] * (1.0f - w) + bypass * w;
+    }
+    pass2Active_ = false;
+  } else {
+    /* Skipped: emit previous pass-1 frame, keep current one for next time. */
+    std::swap_ranges(frame, frame + kRNNoiseFrameSize, pass1Delay_);
+  }
+
+  if (ran) metrics_.pass2Frames.fetch_add(1, std::memory_order_relaxed);
+  updatePass2Duty(ran);
+
+  return vad2;
+}
+
+/*
+ * Pass-2 share of a frame beginFrame() routed to a fast path: digital
+ * silence counts as a skipped pass 2. Kept in the pass-2 phase so only
+ * one thread ever writes the duty-cycle metric.
+ */
+void RNNoiseWrapper::skipSecondPass(const FrameContext& ctx) {
+  if (ctx.path == FramePath::kSilent) updatePass2Duty(false);
+}
+
+void RNNoiseWrapper::updatePass2Duty(bool ran) {
+  float duty = metrics_.pass2DutyCycle.load(std::memory_order_relaxed);
+  duty += kDutyCycleAlpha * ((ran ? 1.0f : 0.0f) - duty);
+  metrics_.pass2DutyCycle.store(duty, std::memory_order_relaxed);
+}
+
+/*
+ * Residual-noise verdict. Only noise-only frames (low pass-1 VAD) update
+ * the estimate; speech frames keep the last verdict so pass 2 doesn't
+ * drop out mid-sentence in a noisy room.
+ */
+bool RNNoiseWrapper::residualNeedsSecondPass(const float* pass1Out, float vad1) {
+  float vadThresh = vadThreshold_.load(std::memory_order_relaxed);
+  if (vad1 >= vadThresh * 0.5f) return residualHot_;
+
+  constexpr float kInvScale = 1.0f / 32767.0f;
+  float residual = computeRms(pass1Out, kRNNoiseFrameSize) * kInvScale;
+
+  residualEstimate_ += kResidualAlpha * (residual - residualEstimate_);
+
+  if (residualFloor_ <= 0.0f) {
+    residualFloor_ = residualEstimate_;
+  } else {
+    float a = (residualEstimate_ < residualFloor_) ? kResidualFloorFall
+                                                   : kResidualFloorRise;
+    residualFloor_ += a * (residualEstimate_ - residualFloor_);
+  }
+  residualFloor_ = std::max(residualFloor_, kResidualMinFloor);
+
+  residualHot_ = (residualEstimate_ > kResidualAudible) ||
+                 (residualEstimate_ > residualFloor_ * kResidualMargin);
+  return residualHot_;
+}
+
 /* ═══════════════════════════════════════════════════════════════════════════
  *  ADAPTIVE NOISE FLOOR
  *
@@ -316,6 +1021,10 @@ float RNNoiseWrapper::processFrame(float* frame) {
  *  exponential moving average (EMA). During the first ~2 seconds the
  *  learning rate is fast; afterwards it tracks slowly to adapt to
  *  gradual environmental changes (fan turning on/off, etc.).
+ *
+ *  exportCalibration() / importCalibration() carry the floor, the
+ *  residual floor and the gate gain across restarts, so a known device
+ *  skips the calibration period.
  * ═══════════════════════════════════════════════════════════════════════════ */
 
 void RNNoiseWrapper::updateNoiseFloor(float postRms, float vad) {
@@ -351,6 +1060,39 @@ void RNNoiseWrapper::updateNoiseFloor(float postRms, float vad) {
   metrics_.noiseFloor.store(noiseFloorEstimate_, std::memory_order_relaxed);
 }
 
+Calibration RNNoiseWrapper::exportCalibration() const {
+  Calibration c;
+  c.noiseFloor = noiseFloorEstimate_;
+  c.calibratedFrames = static_cast<uint32_t>(
+      std::min<uint64_t>(calibrationFrames_, kCalibrationPeriod));
+  c.residualFloor = residualFloor_;
+  c.gateGain = smoothGain_;
+  return c;
+}
+
+bool RNNoiseWrapper::importCalibration(const Calibration& c) {
+  /* Saved files are user-editable: reject anything a frame could not produce. */
+  auto inRange = [](float v, float lo, float hi) { return v >= lo && v <= hi; };
+  if (!inRange(c.noiseFloor, 0.0f, 1.0f) || !inRange(c.residualFloor, 0.0f, 1.0f) ||
+      !inRange(c.gateGain, 0.0f, 1.0f)) {
+    return false;
+  }
+  /* A floor that was never learned would gate against the fallback. */
+  if (c.calibratedFrames > 0 && c.noiseFloor < kAbsoluteMinFloor) return false;
+  warmStart_ = c;
+  hasWarmStart_ = true;
+  return true;
+}
+
+void RNNoiseWrapper::applyCalibration(const Calibration& c) {
+  noiseFloorEstimate_ = c.noiseFloor;
+  calibrationFrames_ = std::min<uint64_t>(c.calibratedFrames, kCalibrationPeriod);
+  residualFloor_ = c.residualFloor;
+  smoothGain_ = c.gateGain;
+  metrics_.noiseFloor.store(noiseFloorEstimate_, std::memory_order_relaxed);
+  metrics_.currentGain.store(smoothGain_, std::memory_order_relaxed);
+}
+
 /* ═══════════════════════════════════════════════════════════════════════════
  *  GATE STATE MACHINE
  *
@@ -371,15 +1113,16 @@ float RNNoiseWrapper::computeGateTarget(float vad, float postRms) {
    * Keep the gate fully open so the user hears audio immediately
    * and the floor converges on actual ambient noise, not silence.
    */
+  const int holdFrames = gateHoldFrames_.load(std::memory_order_relaxed);
   if (calibrationFrames_ < kCalibrationPeriod) {
-    holdCounter_ = kHoldFrames;
+    holdCounter_ = holdFrames;
     return 1.0f;
   }
 
   float vadThresh = vadThreshold_.load(std::memory_order_relaxed);
 
   float gateThresh = (noiseFloorEstimate_ > kAbsoluteMinFloor)
-      ? noiseFloorEstimate_ * kFloorMultiplier
+      ? noiseFloorEstimate_ * floorMultiplier_.load(std::memory_order_relaxed)
       : kFallbackThreshold;
 
   /* Condition (a): strong VAD confidence. */
@@ -394,7 +1137,7 @@ float RNNoiseWrapper::computeGateTarget(float vad, float postRms) {
                      && (postRms > gateThresh * 1.5f);
 
   if (speechByVad || speechByEnergy) {
-    holdCounter_ = kHoldFrames;
+    holdCounter_ = holdFrames;
     return 1.0f;
   }
 
@@ -416,6 +1159,14 @@ float RNNoiseWrapper::computeGateTarget(float vad, float postRms) {
   return std::clamp(ratio, kMinGateGain, 0.5f);
 }
 
+/* Asymmetric gain smoothing (fast close, slow open) toward targetGain. */
+void RNNoiseWrapper::smoothGateGain(float targetGain) {
+  float coeff = (targetGain < smoothGain_) ? kGateCloseCoeff : kGateOpenCoeff;
+  smoothGain_ += coeff * (targetGain - smoothGain_);
+  smoothGain_ = std::clamp(smoothGain_, kMinGateGain, 1.0f);
+  metrics_.currentGain.store(smoothGain_, std::memory_order_relaxed);
+}
+
 /* ═══════════════════════════════════════════════════════════════════════════
  *  SPECTRAL FLOOR CLAMP
  *
@@ -424,27 +1175,22 @@ float RNNoiseWrapper::computeGateTarget(float vad, float postRms) {
  *  faint hiss / buzz that survives RNNoise + gating.
  *
  *  Only active when VAD is low and the gate is mostly closed, so it
- *  never touches speech harmonics.
+ *  never touches speech harmonics. Returns 0 (clamp disabled) otherwise;
+ *  the clamp itself runs inside the fused post-gate pass.
  * ═══════════════════════════════════════════════════════════════════════════ */
 
-void RNNoiseWrapper::spectralClamp(float* frame, float vad) {
+float RNNoiseWrapper::spectralClampThreshold(float vad) const {
   /* Never clamp during calibration -- floor is unreliable. */
-  if (calibrationFrames_ < kCalibrationPeriod) return;
+  if (calibrationFrames_ < kCalibrationPeriod) return 0.0f;
 
   float vadThresh = vadThreshold_.load(std::memory_order_relaxed);
 
-  if (vad >= vadThresh || smoothGain_ > kClampGateThreshold) return;
+  if (vad >= vadThresh || smoothGain_ > kClampGateThreshold) return 0.0f;
 
-  float clampThresh = std::max(
+  return std::max(
       noiseFloorEstimate_ * kSpectralClampMult,
       kAbsoluteMinFloor * 2.0f
   );
-
-  for (size_t i = 0; i < kRNNoiseFrameSize; i++) {
-    if (std::abs(frame[i]) < clampThresh) {
-      frame[i] = 0.0f;
-    }
-  }
 }
 
 /* ═══════════════════════════════════════════════════════════════════════════
@@ -455,18 +1201,17 @@ void RNNoiseWrapper::spectralClamp(float* frame, float vad) {
  *    - The "dead channel" sensation in headphones.
  *    - Click artifacts from sudden zero-to-signal transitions.
  *    - Some conferencing apps detecting "no audio" and muting the channel.
+ *
+ *  Returns the comfort-noise scale for this frame (0 = none). Samples are
+ *  generated inside the fused post-gate pass.
  * ═══════════════════════════════════════════════════════════════════════════ */
 
-void RNNoiseWrapper::applySoftSilence(float* frame) {
-  if (!comfortNoiseEnabled_.load(std::memory_order_relaxed)) return;
-  if (smoothGain_ >= kSoftSilenceGateThresh) return;
+float RNNoiseWrapper::softSilenceScale() const {
+  if (!comfortNoiseEnabled_.load(std::memory_order_relaxed)) return 0.0f;
+  if (smoothGain_ >= kSoftSilenceGateThresh) return 0.0f;
 
   /* Scale comfort noise proportionally: more as gate approaches zero. */
-  float scale = (kSoftSilenceGateThresh - smoothGain_) / kSoftSilenceGateThresh;
-
-  for (size_t i = 0; i < kRNNoiseFrameSize; i++) {
-    frame[i] += comfortNoiseSample() * scale;
-  }
+  return (kSoftSilenceGateThresh - smoothGain_) / kSoftSilenceGateThresh;
 }
 
 /* ═══════════════════════════════════════════════════════════════════════════
@@ -491,40 +1236,101 @@ float RNNoiseWrapper::getVadThreshold() const {
   return vadThreshold_.load(std::memory_order_relaxed);
 }
 
+void RNNoiseWrapper::setGateHoldFrames(int frames) {
+  gateHoldFrames_.store(std::clamp(frames, 0, kMaxHoldFrames),
+                        std::memory_order_relaxed);
+}
+
+int RNNoiseWrapper::getGateHoldFrames() const {
+  return gateHoldFrames_.load(std::memory_order_relaxed);
+}
+
+void RNNoiseWrapper::setGateFloorMultiplier(float multiplier) {
+  if (!std::isfinite(multiplier)) return;
+  floorMultiplier_.store(std::clamp(multiplier, kMinFloorMultiplier, kMaxFloorMultiplier),
+                         std::memory_order_relaxed);
+}
+
+float RNNoiseWrapper::getGateFloorMultiplier() const {
+  return floorMultiplier_.load(std::memory_order_relaxed);
+}
+
 void RNNoiseWrapper::setComfortNoise(bool enabled) {
   comfortNoiseEnabled_.store(enabled, std::memory_order_relaxed);
 }
 
-/* ═══════════════════════════════════════════════════════════════════════════
- *  HELPERS
- * ═══════════════════════════════════════════════════════════════════════════ */
+void RNNoiseWrapper::setStagePlan(const StagePlan& plan) {
+  stagePlan_.store(plan.packed(), std::memory_order_relaxed);
+}
+
+StagePlan RNNoiseWrapper::getStagePlan() const {
+  return StagePlan::fromPacked(stagePlan_.load(std::memory_order_relaxed));
+}
 
-float RNNoiseWrapper::computeRms(const float* buf, size_t len) {
-  float sum = 0.0f;
-  for (size_t i = 0; i < len; i++) {
-    sum += buf[i] * buf[i];
+std::string RNNoiseWrapper::addCustomStage(std::shared_ptr<FrameStage> stage,
+                                           StageId* id) {
+  if (!stage) return "Custom stage is null";
+  if (customStageCount_ >= kMaxCustomStages) {
+    return "Too many custom stages (max " + std::to_string(kMaxCustomStages) + ")";
   }
-  return std::sqrt(sum / static_cast<float>(len));
+  size_t slot = customStageCount_++;
+  customStages_[slot] = std::move(stage);
+  *id = static_cast<StageId>(static_cast<size_t>(StageId::kCustom0) + slot);
+  return "";
 }
 
-/**
- * LFSR-based comfort noise with 1-pole lowpass shaping.
- * Strong lowpass (kNoiseShapeCoeff) keeps energy in sub-bass to avoid
- * audible buzz/hiss. Final amplitude is kSoftSilenceLevel (~-70 dBFS).
- */
-float RNNoiseWrapper::comfortNoiseSample() {
-  noiseState_ ^= noiseState_ << 13;
-  noiseState_ ^= noiseState_ >> 17;
-  noiseState_ ^= noiseState_ << 5;
+void RNNoiseWrapper::resetCustomStages() {
+  for (size_t i = 0; i < customStageCount_; i++) customStages_[i]->reset();
+}
 
-  float white = static_cast<float>(static_cast<int32_t>(noiseState_)) /
-                2147483648.0f;
+void RNNoiseWrapper::setSecondPassMode(SecondPassMode mode) {
+  secondPassMode_.store(static_cast<int>(mode), std::memory_order_relaxed);
+}
+
+SecondPassMode RNNoiseWrapper::getSecondPassMode() const {
+  return static_cast<SecondPassMode>(
+      secondPassMode_.load(std::memory_order_relaxed));
+}
 
-  float shaped = kNoiseShapeCoeff * prevNoise_
-               + (1.0f - kNoiseShapeCoeff) * white;
-  prevNoise_ = shaped;
+void RNNoiseWrapper::setCatchUp(bool on) {
+  catchUp_.store(on, std::memory_order_relaxed);
+}
 
-  return shaped * kSoftSilenceLevel;
+bool RNNoiseWrapper::getCatchUp() const {
+  return catchUp_.load(std::memory_order_relaxed);
+}
+
+void RNNoiseWrapper::setModelTier(ModelTier tier) {
+  modelTier_.store(static_cast<int>(tier), std::memory_order_relaxed);
+}
+
+ModelTier RNNoiseWrapper::getModelTier() const {
+  return static_cast<ModelTier>(modelTier_.load(std::memory_order_relaxed));
+}
+
+void RNNoiseWrapper::setQualityTier(QualityTier tier) {
+  int prev = qualityTier_.exchange(static_cast<int>(tier), std::memory_order_relaxed);
+  if (prev == static_cast<int>(tier)) return;
+  metrics_.qualityTier.store(static_cast<int>(tier), std::memory_order_relaxed);
+  metrics_.qualityTierChanges.fetch_add(1, std::memory_order_relaxed);
+}
+
+QualityTier RNNoiseWrapper::getQualityTier() const {
+  return static_cast<QualityTier>(qualityTier_.load(std::memory_order_relaxed));
+}
+
+/* The user's tier, or kLittle while the governor sheds down to it. */
+ModelTier RNNoiseWrapper::effectiveModelTier() const {
+  return getQualityTier() >= QualityTier::kLittleModel ? ModelTier::kLittle : getModelTier();
+}
+
+/* ═══════════════════════════════════════════════════════════════════════════
+ *  HELPERS
+ * ═══════════════════════════════════════════════════════════════════════════ */
+
+float RNNoiseWrapper::computeRms(const float* buf, size_t len) const {
+  float sum = kernels_->sumSquares(buf, len);
+  return std::sqrt(sum / static_cast<float>(len));
 }
 
 }  // namespace ainoiceguard
@@ -4,7 +4,9 @@
  * RNNoise processes exactly 480 float samples per frame (10ms @ 48kHz).
  * This wrapper adds a multi-stage post-processing chain on top:
  *
- *   1. Double-pass RNNoise (two DenoiseState instances in series).
+ *   1. Double-pass RNNoise (two DenoiseState instances in series). The
+ *      residual (second) pass can run adaptively: only while the first
+ *      pass's output still carries noise above a learned floor.
  *   2. Biquad HPF (80 Hz) + LPF (8 kHz) to remove hum and HF hiss.
  *   3. Adaptive noise gate that learns the room's noise floor and
  *      uses VAD + energy to decide when to silence the output.
@@ -13,11 +15,28 @@
  *   5. Soft silence: injects shaped comfort noise at -60 dBFS when the
  *      gate is closed, preventing ear fatigue and channel "dead air".
  *   6. Real-time metrics (input/output RMS, VAD, gate gain, noise floor).
+ *   7. Digital-silence fast path: sustained exact-zero input (hardware
+ *      mute) skips inference and filters, emitting gated comfort noise.
+ *   8. Model tiers: kLittle runs a single pass, optionally on a smaller
+ *      model, for CPUs that cannot afford the standard double pass.
+ *   9. Model hot-swap: new weights are prepared off the audio thread and
+ *      crossfaded in at a frame boundary.
+ *  10. Configurable stage plan (stage_chain.h): steps 2-5 can be dropped,
+ *      reordered, or interleaved with custom FrameStages per wrapper.
+ *  11. Filter bank (filter_bank.h): user EQ / hum-notch sections designed
+ *      for 48 kHz, run as one block cascade after the HPF / LPF.
+ *  12. Quality tier override (cpu_governor.h): the engine's CPU governor
+ *      sheds the residual pass, the filter bank and custom stages, then
+ *      the standard model, without touching the user's settings.
  *
  * REAL-TIME RULES:
  * - processFrame() does NO allocations -- pure arithmetic, fixed loops.
+ * - Element-wise loops run through SIMD kernels (dsp_kernels.h) chosen once
+ *   at construction for the host CPU.
  * - setSuppressionLevel() / setVadThreshold() are lock-free (atomic store).
- * - init() and destroy() are NOT real-time safe.
+ * - init(), destroy(), prepareModelSwap(), setFilterBank() and
+ *   reclaimRetired() are NOT real-time safe. The audio thread only
+ *   exchanges swap-record pointers.
  */
 
 #ifndef AINOICEGUARD_RNNOISE_WRAPPER_H
@@ -26,15 +45,72 @@
 #include <atomic>
 #include <cstddef>
 #include <cstdint>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "cpu_governor.h"
+#include "filter_bank.h"
+#include "post_filter.h"
+#include "rnnoise_model.h"
+#include "stage_chain.h"
 
 /* Forward-declare RNNoise opaque type. */
 struct DenoiseState;
 
 namespace ainoiceguard {
 
+struct DspKernels;
+struct RNNoiseKernels;
+
 /* RNNoise operates on exactly 480 samples per frame (10ms at 48kHz). */
 static constexpr size_t kRNNoiseFrameSize = 480;
 
+/* The only rate RNNoise runs at; every filter is designed for it. */
+static constexpr double kRNNoiseSampleRate = 48000.0;
+
+/*
+ * Silent frames processed normally before the digital-silence fast path
+ * engages: 20 frames = 200ms. This exceeds RNNoise's longest history (the
+ * 1728-sample pitch buffer) so every DenoiseState buffer has been flushed
+ * with zeros and its GRU state has settled on silence before inference is
+ * skipped.
+ */
+static constexpr int kDigitalSilenceFrames = 20;
+
+/*
+ * Frames an incoming tier's (or swapped-in model's) DenoiseState runs in
+ * parallel with the outgoing one (same input) before taking over: 10
+ * frames = 100ms lets its GRU state and overlap memory converge, so the
+ * one-frame crossfade joins two outputs that already agree. Costs one
+ * extra inference per frame for the duration of a switch only.
+ */
+static constexpr int kTierWarmupFrames = 10;
+
+/**
+ * When the residual (second) RNNoise pass runs.
+ *   kAlways   -- every frame (classic double pass, default).
+ *   kNever    -- never (single pass; output stays latency-aligned).
+ *   kAdaptive -- only while pass-1 output shows residual noise above a
+ *                learned floor, with a short hangover.
+ */
+enum class SecondPassMode : int {
+  kAlways = 0,
+  kNever = 1,
+  kAdaptive = 2,
+};
+
+/**
+ * Inference cost tier. Switchable at runtime without a gap in the audio.
+ *   kStandard -- primary model, residual pass per SecondPassMode.
+ *   kLittle   -- single pass; uses the little model passed to init() if
+ *                any, otherwise the primary model.
+ */
+enum class ModelTier : int {
+  kStandard = 0,
+  kLittle = 1,
+};
+
 /**
  * Real-time metrics exposed to the UI via atomic reads.
  * All fields are updated every frame from the processing thread.
@@ -46,28 +122,27 @@ struct AudioMetrics {
   std::atomic<float> currentGain{1.0f};    /* Applied gate gain [0..1] */
   std::atomic<float> noiseFloor{0.0f};     /* Learned noise floor RMS */
   std::atomic<uint64_t> framesProcessed{0};
+  std::atomic<uint64_t> pass2Frames{0};    /* Frames that ran the second pass */
+  std::atomic<float> pass2DutyCycle{1.0f}; /* Recent second-pass share [0..1] (~1s EMA) */
+  std::atomic<uint64_t> silentFrames{0};   /* Frames served by the digital-silence fast path */
+  std::atomic<int> modelTier{0};           /* ModelTier currently producing output */
+  std::atomic<uint64_t> modelSwaps{0};     /* Hot-swaps completed since init() */
+  std::atomic<int> qualityTier{0};         /* QualityTier set by the CPU governor */
+  std::atomic<uint64_t> qualityTierChanges{0};  /* Governor steps since init() */
 };
 
 /**
- * 2nd-order IIR biquad filter (Direct Form I).
- * Two instances are used: one HPF at 80 Hz, one LPF at 8 kHz.
- * Coefficients are pre-computed for 48 kHz in initFilters().
- * No allocations; state lives in fixed member variables.
+ * Learned gate state, saved per input device so the next start gates from
+ * its first frame instead of recalibrating for ~2 s. Plain values: the
+ * caller persists them (the app keeps JSON per device). RNNoise's own
+ * recurrent state is not included -- it is opaque and holds pointers, and
+ * it settles within a few frames anyway.
  */
-struct BiquadState {
-  float b0 = 1.f, b1 = 0.f, b2 = 0.f;  /* feedforward (numerator) */
-  float a1 = 0.f, a2 = 0.f;              /* feedback (denominator), a0 = 1 */
-  float x1 = 0.f, x2 = 0.f;             /* input delay line */
-  float y1 = 0.f, y2 = 0.f;             /* output delay line */
-
-  void reset() { x1 = x2 = y1 = y2 = 0.f; }
-
-  inline float process(float x) {
-    float y = b0 * x + b1 * x1 + b2 * x2 - a1 * y1 - a2 * y2;
-    x2 = x1; x1 = x;
-    y2 = y1; y1 = y;
-    return y;
-  }
+struct Calibration {
+  float noiseFloor = 0.0f;        /* Learned noise-floor RMS */
+  uint32_t calibratedFrames = 0;  /* Noise frames learned from (saturates at the calibration period) */
+  float residualFloor = 0.0f;     /* Adaptive second pass: learned residual floor */
+  float gateGain = 1.0f;          /* Smoothed gate gain */
 };
 
 class RNNoiseWrapper {
@@ -78,18 +153,33 @@ class RNNoiseWrapper {
   RNNoiseWrapper(const RNNoiseWrapper&) = delete;
   RNNoiseWrapper& operator=(const RNNoiseWrapper&) = delete;
 
-  /** Initialize RNNoise states, filters, and gate state. */
-  bool init();
+  /**
+   * Initialize RNNoise states, filters, and gate state. Both passes use
+   * `model` (shared, see rnnoise_model.h); nullptr = built-in model.
+   * `littleModel`, if given, backs ModelTier::kLittle.
+   */
+  bool init(std::shared_ptr<const RNNoiseModel> model = nullptr,
+            std::shared_ptr<const RNNoiseModel> littleModel = nullptr);
+
+  /**
+   * Run `frames` synthetic frames through the pipeline to fault in the
+   * weights, states and kernel code, then restore the gate, filters,
+   * calibration and metrics init() set up. Call after init(), before the
+   * first real frame. NOT real-time safe (it is the slow part on purpose).
+   */
+  void prewarm(size_t frames);
 
-  /** Destroy RNNoise states. */
+  /** Destroy RNNoise states and release the model reference. */
   void destroy();
 
   /**
    * Process a single frame IN-PLACE. frame must point to kRNNoiseFrameSize floats.
    *
-   * Full pipeline (all real-time safe):
+   * Full pipeline (all real-time safe; steps 4-6 and 10-13 are each one
+   * fused sweep over the frame):
    *   1.  Measure input RMS
-   *   2.  Double-pass RNNoise (primary + residual suppression)
+   *   2.  Double-pass RNNoise (primary + residual suppression; the residual
+   *       pass may be skipped per SecondPassMode)
    *   3.  Blend with original based on suppression level
    *   4.  Biquad HPF (80 Hz) + LPF (8 kHz)
    *   5.  Compute post-filter RMS for adaptive noise floor
@@ -101,6 +191,7 @@ class RNNoiseWrapper {
    *   11. Spectral floor clamp (force residuals to zero when VAD low)
    *   12. Soft silence injection (shaped -60 dBFS noise when gate closed)
    *   13. Measure output RMS, update metrics
+   * Steps 4 and 6-12 follow the stage plan (see setStagePlan()).
    *
    * Returns the RNNoise VAD probability [0.0, 1.0].
    */
@@ -117,20 +208,215 @@ class RNNoiseWrapper {
   /** Enable/disable soft silence injection during gated silence. */
   void setComfortNoise(bool enabled);
 
+  /**
+   * Gate tuning. Hold: frames the gate stays open after the last speech
+   * frame [0..100], default 15 (150 ms). Floor multiplier: gate threshold
+   * relative to the learned noise floor [1.0..4.0], default 1.3.
+   * Thread-safe; applied per frame.
+   */
+  void setGateHoldFrames(int frames);
+  int getGateHoldFrames() const;
+  void setGateFloorMultiplier(float multiplier);
+  float getGateFloorMultiplier() const;
+
+  /**
+   * Select the post-RNNoise stages and their order. Thread-safe; applied
+   * at the next frame boundary. Built-ins in canonical order run as the
+   * two fused passes specialized for exactly that subset; anything else
+   * runs stage by stage. Custom ids must have been registered with
+   * addCustomStage() (unregistered ones are skipped). Default:
+   * StagePlan::defaults().
+   */
+  void setStagePlan(const StagePlan& plan);
+  StagePlan getStagePlan() const;
+
+  /**
+   * Register a custom stage; *id receives its StageId for use in a plan.
+   * Returns empty string on success, or an error message. Call before
+   * init() or while processFrame() is not running. NOT real-time safe.
+   */
+  std::string addCustomStage(std::shared_ptr<FrameStage> stage, StageId* id);
+
+  /**
+   * Replace the filter-bank sections (EQ, hum notches; at most
+   * FilterBank::kMaxSections). Designs the coefficients for 48 kHz on the
+   * CALLING thread and publishes them; the processing thread installs
+   * them at a frame boundary (kept filter state when only the
+   * coefficients change). The bank runs where the plan places
+   * StageId::kFilterBank. Returns empty string on success, or an error
+   * message (the previous bank stays). Control thread only, never
+   * concurrently with init() / destroy(). NOT real-time safe.
+   */
+  std::string setFilterBank(const std::vector<FilterSpec>& specs);
+  std::vector<FilterSpec> getFilterBank() const;
+
+  /**
+   * Gate state learned so far. Call while processFrame() is not running
+   * (e.g. after the processing thread stopped, before destroy()).
+   */
+  Calibration exportCalibration() const;
+
+  /**
+   * Start the next init() from `c` instead of an uncalibrated gate (used
+   * once). Returns false (nothing staged) when a value is out of range.
+   * Call before init(), never concurrently with processFrame().
+   */
+  bool importCalibration(const Calibration& c);
+
+  /** Select when the residual RNNoise pass runs. Thread-safe; applied per frame. */
+  void setSecondPassMode(SecondPassMode mode);
+  SecondPassMode getSecondPassMode() const;
+
+  /**
+   * Catch-up override: while on, the residual pass is skipped whatever the
+   * SecondPassMode (switching crossfades as usual). The engine sets it
+   * while it works off a capture backlog. Thread-safe; applied per frame.
+   */
+  void setCatchUp(bool on);
+  bool getCatchUp() const;
+
+  /**
+   * Load-shedding override from the engine's CPU governor (see
+   * cpu_governor.h). kSinglePass skips the residual pass, kLeanFilters
+   * also runs StagePlan::lean(), kLittleModel also runs the little tier.
+   * The SecondPassMode, stage plan and model tier settings stay as they
+   * are and apply again at kFull. Thread-safe; applied per frame (pass
+   * and model changes crossfade as usual).
+   */
+  void setQualityTier(QualityTier tier);
+  QualityTier getQualityTier() const;
+
+  /**
+   * Select the inference tier. Thread-safe. Set before init() to start in
+   * that tier; later changes cross over within ~100ms (the incoming
+   * pass-1 state warms up in parallel, then crossfades in).
+   */
+  void setModelTier(ModelTier tier);
+  ModelTier getModelTier() const;
+
+  /**
+   * Hot-swap the model behind `tier` while processFrame() keeps running.
+   * Creates the new DenoiseState(s) on the CALLING thread and publishes
+   * them; the processing thread warms them up for ~100ms on live input and
+   * crossfades them in at a frame boundary. A newer call supersedes a swap
+   * the processing thread has not picked up yet. `model` may be nullptr
+   * (built-in) for kStandard only. Returns false if state creation
+   * failed. Call only between init() and destroy(), never concurrently
+   * with them. NOT real-time safe.
+   */
+  bool prepareModelSwap(std::shared_ptr<const RNNoiseModel> model,
+                        ModelTier tier = ModelTier::kStandard);
+
+  /** True while a published swap has not been picked up yet. */
+  bool swapPending() const;
+
+  /** True while a completed swap's old states wait for reclaimRetired(). */
+  bool reclaimPending() const;
+
+  /**
+   * Free the states and model reference replaced by the last completed
+   * swap, and the last installed filter-bank record. Call periodically
+   * from a non-real-time thread (the engine's event thread does). The
+   * next swap waits until this has run.
+   */
+  void reclaimRetired();
+
   bool isInitialized() const { return state_ != nullptr; }
 
+  /** Model the states were created from (nullptr = built-in). */
+  const std::shared_ptr<const RNNoiseModel>& model() const { return model_; }
+
   /** Access real-time metrics (lock-free atomic reads). */
   const AudioMetrics& metrics() const { return metrics_; }
 
  private:
+  /* Drives the split-phase steps below across threads. */
+  friend class RNNoisePipeline;
+
   /* ── RNNoise instances (double-pass) ── */
   DenoiseState* state_ = nullptr;
   DenoiseState* state2_ = nullptr;
+  std::shared_ptr<const RNNoiseModel> model_;  /* Weights behind both states */
+  bool ready_ = false;  /* init() created every state; tested by beginFrame() only */
+
+  /* ── Little tier (optional single-pass model) ── */
+  DenoiseState* stateLittle_ = nullptr;
+  std::shared_ptr<const RNNoiseModel> littleModel_;
+  DenoiseState* primary_ = nullptr;  /* Pass-1 state feeding the output */
+  int tierWarmup_ = 0;               /* Frames the incoming pass-1 state has run */
+  DenoiseState* warmupTarget_ = nullptr;  /* State tierWarmup_ counts for */
+
+  /* ── Model hot-swap hand-off (see MODEL TIERS + HOT-SWAP in the .cpp) ── */
+  struct ModelSwap;
+  std::atomic<ModelSwap*> pendingSwap_{nullptr};  /* control → audio */
+  ModelSwap* swap_ = nullptr;                     /* warming up (audio thread) */
+  std::atomic<ModelSwap*> retired_{nullptr};      /* audio → control */
+  std::atomic<bool> residualHandoff_{false};      /* Committed; state2 not installed yet */
+
+  /* ── Filter-bank hand-off (see FILTER BANK in the .cpp) ── */
+  struct BankUpdate;
+  std::atomic<BankUpdate*> pendingBank_{nullptr};  /* control → audio */
+  std::atomic<BankUpdate*> retiredBank_{nullptr};  /* audio → control */
+  std::vector<FilterSpec> bankSpecs_;              /* Control thread only */
 
   /* ── User-configurable parameters (atomic for lock-free UI access) ── */
   std::atomic<float> suppressionLevel_{1.0f};
   std::atomic<float> vadThreshold_{0.65f};
   std::atomic<bool> comfortNoiseEnabled_{true};
+  std::atomic<int> gateHoldFrames_{15};
+  std::atomic<float> floorMultiplier_{1.3f};
+  std::atomic<int> secondPassMode_{static_cast<int>(SecondPassMode::kAlways)};
+  std::atomic<bool> catchUp_{false};
+  std::atomic<int> modelTier_{static_cast<int>(ModelTier::kStandard)};
+  std::atomic<int> qualityTier_{static_cast<int>(QualityTier::kFull)};
+  std::atomic<uint64_t> stagePlan_{StagePlan::defaults().packed()};
+
+  /* ── Custom stages (registered before processing, see addCustomStage) ── */
+  std::shared_ptr<FrameStage> customStages_[kMaxCustomStages];
+  size_t customStageCount_ = 0;
+
+  /* ── Second-pass scheduling (processing thread only) ── */
+  bool pass2Active_ = true;      /* Did state2_ run on the previous frame? */
+  int pass2Hangover_ = 0;        /* Frames to keep pass 2 after residual clears */
+  bool residualHot_ = true;      /* Last noise-frame verdict: residual audible */
+  float residualEstimate_ = 0.0f;
+  float residualFloor_ = 0.0f;
+  /*
+   * Pass-1 output of the previous frame (int16 range). RNNoise delays its
+   * output by one frame, so when pass 2 is skipped this is emitted instead
+   * to keep latency -- and therefore the waveform -- continuous.
+   */
+  float pass1Delay_[kRNNoiseFrameSize] = {};
+
+  /* How beginFrame() routed a frame. */
+  enum class FramePath : int {
+    kInfer = 0,     /* Both passes + finishFrame() */
+    kBypass = 1,    /* Suppression off: passthrough */
+    kSilent = 2,    /* Sustained digital silence: processDigitalSilence() */
+    kIdle = 3,      /* Not initialized: frame left untouched */
+  };
+
+  /*
+   * Per-frame scratch carried from one processing phase to the next.
+   * processFrame() uses ctx_; RNNoisePipeline keeps one
+   * per frame in flight, since its phases work on different frames at
+   * once. Flags hand state changes made in one phase to the phase that
+   * owns the state, so each phase touches only its own state.
+   */
+  struct FrameContext {
+    float original[kRNNoiseFrameSize];  /* Dry input for blending */
+    float level;                        /* Suppression level latched for this frame */
+    FramePath path;
+    bool resumed;                       /* First frame after a digital-silence stretch */
+    ModelSwap* residualSwap;            /* Committed swap whose state2 this frame installs */
+  };
+  FrameContext ctx_ = {};
+
+  /* ── Lean plan in force on the previous frame (processing thread only) ── */
+  bool leanPlan_ = false;
+
+  /* ── Digital silence detection (processing thread only) ── */
+  int silentFrames_ = 0;  /* Consecutive frames at digital silence */
 
   /* ── Gate state (processing thread only -- NOT atomic) ── */
   float smoothGain_ = 1.0f;
@@ -139,27 +425,63 @@ class RNNoiseWrapper {
   /* ── Adaptive noise floor (processing thread only) ── */
   float noiseFloorEstimate_ = 0.0f;
   uint64_t calibrationFrames_ = 0;
+  Calibration warmStart_;         /* Staged by importCalibration() */
+  bool hasWarmStart_ = false;
 
   /* ── Biquad filters (processing thread only) ── */
   BiquadState hpf_;   /* High-pass at 80 Hz */
   BiquadState lpf_;   /* Low-pass at 8 kHz */
+  FilterBank filterBank_;  /* User sections (empty by default) */
 
   /* ── LFSR + shaping state for comfort noise ── */
-  uint32_t noiseState_ = 0x12345678;
-  float prevNoise_ = 0.0f;
+  ComfortNoise comfortNoise_;
 
   /* ── Metrics ── */
   AudioMetrics metrics_;
 
+  /* ── SIMD kernel tables (resolved once in the constructor) ── */
+  const DspKernels* kernels_;
+  const RNNoiseKernels* rnnoise_;  /* RNNoise copy every state_ comes from */
+
   /* ── Helper functions (all real-time safe) ── */
   void initFilters();
+  void resetProcessingState();
+  void applyCalibration(const Calibration& c);
+
+  /*
+   * Split-phase processing. processFrame() == beginFrame() → primary pass
+   * → second pass → finishFrame(), or beginFrame() → finishFastPath().
+   * RNNoisePipeline runs the phases on different threads. State owned by
+   * each phase:
+   *   beginFrame, runPrimaryPass  silence detection, pass-1 states, swaps
+   *   runSecondPass,              state2_, pass1Delay_, residual tracking,
+   *     skipSecondPass            pass-2 duty cycle
+   *   finishFrame, finishFastPath gate, floor, filters, stages, comfort noise
+   */
+  bool beginFrame(float* frame, FrameContext& ctx);
+  void finishFastPath(float* frame, const FrameContext& ctx);
+  float runPrimaryPass(float* frame, FrameContext& ctx);
+  float finishFrame(float* frame, float vad, const FrameContext& ctx);
+  float runFusedPlan(float* frame, float vad, StagePlan plan, const FrameContext& ctx);
+  float runStagePlan(float* frame, float vad, StagePlan plan, const FrameContext& ctx);
+  void processDigitalSilence(float* frame);
+  void resetCustomStages();
+  ModelTier effectiveModelTier() const;
+  void commitSwap(FrameContext& ctx);
+  static void releaseSwap(ModelSwap* s);
+  void applyPendingBank();
+  static void releaseBank(BankUpdate* u);
+  void smoothGateGain(float targetGain);
+  float runSecondPass(float* frame, float vad1, const FrameContext& ctx);
+  void skipSecondPass(const FrameContext& ctx);
+  void updatePass2Duty(bool ran);
+  bool residualNeedsSecondPass(const float* pass1Out, float vad1);
   void updateNoiseFloor(float postRms, float vad);
   float computeGateTarget(float vad, float postRms);
-  void spectralClamp(float* frame, float vad);
-  void applySoftSilence(float* frame);
-  float comfortNoiseSample();
+  float spectralClampThreshold(float vad) const;
+  float softSilenceScale() const;
 
-  static float computeRms(const float* buf, size_t len);
+  float computeRms(const float* buf, size_t len) const;
 };
 
 }  // namespace ainoiceguard
@@ -0,0 +1,77 @@
+/**
+ * Lock-free Single-Producer Single-Consumer (SPSC) queue of fixed-size records.
+ *
+ * Companion to RingBuffer (which moves raw float samples): this queue moves
+ * whole POD records -- status events, anomaly reports -- from a real-time
+ * thread to a non-real-time consumer.
+ *
+ * RULES FOR REAL-TIME AUDIO:
+ * - Storage is a fixed in-object array. No allocations, ever.
+ * - push()/pop() are wait-free: a memcpy-sized copy plus two atomics.
+ * - T must be trivially copyable so a push never runs user code.
+ * - Capacity must be a power of 2 for O(1) indexing via bitwise mask.
+ */
+
+#ifndef AINOICEGUARD_SPSC_QUEUE_H
+#define AINOICEGUARD_SPSC_QUEUE_H
+
+#include <atomic>
+#include <cstddef>
+#include <type_traits>
+
+namespace ainoiceguard {
+
+template <typename T, size_t Capacity>
+class SpscQueue {
+  static_assert(std::is_trivially_copyable<T>::value,
+                "SpscQueue records must be trivially copyable (POD)");
+  static_assert(Capacity >= 2 && (Capacity & (Capacity - 1)) == 0,
+                "SpscQueue capacity must be a power of 2");
+
+ public:
+  SpscQueue() = default;
+
+  SpscQueue(const SpscQueue&) = delete;
+  SpscQueue& operator=(const SpscQueue&) = delete;
+
+  /** Producer side. Returns false (record dropped) if the queue is full. */
+  bool push(const T& item) {
+    size_t w = write_idx_.load(std::memory_order_relaxed);
+    size_t r = read_idx_.load(std::memory_order_acquire);
+    if (w - r >= Capacity) return false;
+    slots_[w & kMask] = item;
+    write_idx_.store(w + 1, std::memory_order_release);
+    return true;
+  }
+
+  /** Consumer side. Returns false if the queue is empty. */
+  bool pop(T& out) {
+    size_t r = read_idx_.load(std::memory_order_relaxed);
+    size_t w = write_idx_.load(std::memory_order_acquire);
+    if (r == w) return false;
+    out = slots_[r & kMask];
+    read_idx_.store(r + 1, std::memory_order_release);
+    return true;
+  }
+
+  /** Approximate number of queued records (exact when called by either side). */
+  size_t size() const {
+    return write_idx_.load(std::memory_order_acquire) -
+           read_idx_.load(std::memory_order_acquire);
+  }
+
+  bool empty() const { return size() == 0; }
+
+  static constexpr size_t capacity() { return Capacity; }
+
+ private:
+  static constexpr size_t kMask = Capacity - 1;
+
+  T slots_[Capacity]{};
+  std::atomic<size_t> read_idx_{0};
+  std::atomic<size_t> write_idx_{0};
+};
+
+}  // namespace ainoiceguard
+
+#endif  // AINOICEGUARD_SPSC_QUEUE_H
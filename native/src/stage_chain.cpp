@@ -0,0 +1,85 @@
+/**
+ * StagePlan packing and stage names. See stage_chain.h.
+ */
+
+#include "stage_chain.h"
+
+namespace ainoiceguard {
+
+namespace {
+
+const char* const kBuiltinNames[] = {
+    nullptr,  "highPass",      "lowPass",      "filterBank",
+    "gate",   "spectralClamp", "comfortNoise",
+};
+
+const char* const kCustomNames[kMaxCustomStages] = {
+    "custom0", "custom1", "custom2", "custom3",
+};
+
+bool isBuiltinStage(StageId id) {
+  return id >= StageId::kHighPass && id <= StageId::kComfortNoise;
+}
+
+}  // namespace
+
+const char* stageName(StageId id) {
+  if (isBuiltinStage(id)) return kBuiltinNames[static_cast<uint8_t>(id)];
+  if (isCustomStage(id)) {
+    return kCustomNames[static_cast<uint8_t>(id) -
+                        static_cast<uint8_t>(StageId::kCustom0)];
+  }
+  return "none";
+}
+
+bool stageFromName(const std::string& name, StageId* out) {
+  for (uint8_t v = 1; v < 16; v++) {
+    StageId id = static_cast<StageId>(v);
+    if (!isBuiltinStage(id) && !isCustomStage(id)) continue;
+    if (name == stageName(id)) {
+      *out = id;
+      return true;
+    }
+  }
+  return false;
+}
+
+StagePlan StagePlan::defaults() {
+  StagePlan p;
+  p.append(StageId::kHighPass);
+  p.append(StageId::kLowPass);
+  p.append(StageId::kFilterBank);
+  p.append(StageId::kGate);
+  p.append(StageId::kSpectralClamp);
+  p.append(StageId::kComfortNoise);
+  return p;
+}
+
+StagePlan StagePlan::lean() const {
+  StagePlan p;
+  for (StageId id : {StageId::kHighPass, StageId::kLowPass, StageId::kGate,
+                     StageId::kSpectralClamp, StageId::kComfortNoise}) {
+    if (contains(id)) p.append(id);
+  }
+  return p;
+}
+
+bool StagePlan::append(StageId id) {
+  if (!isBuiltinStage(id) && !isCustomStage(id)) return false;
+  if (contains(id)) return false;
+
+  size_t n = size();
+  if (n >= kMaxStages) return false;
+
+  /* Still fused only while built-ins arrive in canonical order. */
+  bool fusedStill = fused() && isBuiltinStage(id) &&
+                    (n == 0 || static_cast<uint8_t>(at(n - 1)) <
+                                   static_cast<uint8_t>(id));
+
+  bits_ |= static_cast<uint64_t>(id) << (4 * n);
+  bits_ |= uint64_t{1} << (kMaskShift + static_cast<unsigned>(id));
+  if (!fusedStill) bits_ &= ~(uint64_t{1} << kFusedBit);
+  return true;
+}
+
+}  // namespace ainoiceguard
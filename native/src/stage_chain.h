@@ -0,0 +1,269 @@
+/**
+ * Post-RNNoise processing as a chain of stages.
+ *
+ * Two layers:
+ *
+ *   StageChain<Stages...>  compile-time chain of per-sample stage objects.
+ *                          run() is ONE loop over the frame with every
+ *                          stage inlined into the body; a stage that is not
+ *                          in the type list does not exist in the generated
+ *                          code (no branch, no state load, no extra pass).
+ *                          post_filter.cpp instantiates one chain per
+ *                          common configuration and picks among them once
+ *                          per frame.
+ *
+ *   StagePlan              runtime description of the frame pipeline: the
+ *                          built-in stages (HPF, LPF, filter bank, gate,
+ *                          spectral clamp, comfort noise) and custom
+ *                          FrameStages, in any order, any subset. Packed
+ *                          into one 64-bit word so the processing thread
+ *                          reads it with a single relaxed atomic load per
+ *                          frame.
+ *
+ * A plan whose stages are built-ins in canonical order (StageId order) is
+ * "fused": RNNoiseWrapper runs it as the two specialized passes of
+ * post_filter.h. Any other plan (reordered, or with custom stages) runs
+ * stage by stage, one block pass each, in the order given.
+ *
+ * REAL-TIME RULES:
+ * - StageChain::run() and StagePlan accessors are allocation-free and
+ *   lock-free.
+ * - FrameStage::process() runs on the audio thread and must follow the
+ *   same rules (no allocation, no locks, no I/O).
+ */
+
+#ifndef AINOICEGUARD_STAGE_CHAIN_H
+#define AINOICEGUARD_STAGE_CHAIN_H
+
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <tuple>
+
+#include "post_filter.h"
+
+namespace ainoiceguard {
+
+/* ═══════════════════════════════════════════════════════════════════════════
+ *  COMPILE-TIME CHAINS
+ * ═══════════════════════════════════════════════════════════════════════════ */
+
+/** Per-frame values the sample stages latch in begin(). */
+struct StageFrame {
+  const float* original = nullptr;  /* Dry signal for BlendStage */
+  float inScale = 1.0f;             /* ScaleStage factor */
+  float level = 1.0f;               /* Wet share for BlendStage */
+  float gain = 1.0f;                /* GainStage factor */
+  float clampThresh = 0.0f;         /* ClampStage threshold */
+  float noiseScale = 0.0f;          /* NoiseStage amplitude */
+};
+
+/*
+ * Sample stages. Each one provides:
+ *   void  begin(const StageFrame&)  latch per-frame values, copy state to locals
+ *   float tick(float x, size_t i)   process sample i
+ *   void  end()                     write state back
+ * State is copied in and out so the compiler can keep it in registers for
+ * the whole loop instead of reloading it through a pointer every sample.
+ */
+
+struct ScaleStage {
+  float k = 1.0f;
+  void begin(const StageFrame& f) { k = f.inScale; }
+  float tick(float x, size_t) const { return x * k; }
+  void end() {}
+};
+
+struct BlendStage {
+  const float* dry = nullptr;
+  float wet = 1.0f, dryGain = 0.0f;
+  void begin(const StageFrame& f) {
+    dry = f.original;
+    wet = f.level;
+    dryGain = 1.0f - f.level;
+  }
+  float tick(float x, size_t i) const { return x * wet + dry[i] * dryGain; }
+  void end() {}
+};
+
+struct BiquadStage {
+  explicit BiquadStage(BiquadState* state) : ref(state) {}
+  BiquadState* ref;
+  BiquadState s;
+  void begin(const StageFrame&) { s = *ref; }
+  float tick(float x, size_t) { return s.process(x); }
+  void end() { *ref = s; }
+};
+
+struct GainStage {
+  float g = 1.0f;
+  void begin(const StageFrame& f) { g = f.gain; }
+  float tick(float x, size_t) const { return x * g; }
+  void end() {}
+};
+
+struct ClampStage {
+  float t = 0.0f;
+  void begin(const StageFrame& f) { t = f.clampThresh; }
+  float tick(float x, size_t) const { return std::abs(x) < t ? 0.0f : x; }
+  void end() {}
+};
+
+struct NoiseStage {
+  explicit NoiseStage(ComfortNoise* noise) : ref(noise) {}
+  ComfortNoise* ref;
+  ComfortNoise s;
+  float scale = 0.0f;
+  void begin(const StageFrame& f) {
+    s = *ref;
+    scale = f.noiseScale;
+  }
+  float tick(float x, size_t) { return x + s.sample() * scale; }
+  void end() { *ref = s; }
+};
+
+/**
+ * Fuses Stages into one sweep: frame[i] = stageN(...stage1(frame[i])).
+ * run() returns the sum of squares of the output (every consumer needs an
+ * RMS of the frame it just produced).
+ */
+template <typename... Stages>
+class StageChain {
+ public:
+  explicit StageChain(Stages... stages) : stages_(stages...) {}
+
+  float run(float* frame, size_t len, const StageFrame& f) {
+    std::apply([&](auto&... s) { (s.begin(f), ...); }, stages_);
+
+    float sum = 0.0f;
+    for (size_t i = 0; i < len; i++) {
+      float y = frame[i];
+      std::apply([&](auto&... s) { ((y = s.tick(y, i)), ...); }, stages_);
+      frame[i] = y;
+      sum += y * y;
+    }
+
+    std::apply([](auto&... s) { (s.end(), ...); }, stages_);
+    return sum;
+  }
+
+ private:
+  std::tuple<Stages...> stages_;
+};
+
+/* ═══════════════════════════════════════════════════════════════════════════
+ *  RUNTIME PLAN
+ * ═══════════════════════════════════════════════════════════════════════════ */
+
+/** Stage identifiers. Built-ins are listed in their canonical order. */
+enum class StageId : uint8_t {
+  kNone = 0,
+  kHighPass = 1,       /* Biquad HPF */
+  kLowPass = 2,        /* Biquad LPF */
+  kFilterBank = 3,     /* User EQ / hum-notch cascade (filter_bank.h) */
+  kGate = 4,           /* Noise floor + VAD/energy gate + gain */
+  kSpectralClamp = 5,  /* Zero residual samples while the gate is closing */
+  kComfortNoise = 6,   /* Shaped noise while the gate is closed */
+  kCustom0 = 8,        /* First custom FrameStage slot */
+};
+
+/* Custom stage slots: StageId kCustom0 .. kCustom0 + kMaxCustomStages - 1. */
+static constexpr size_t kMaxCustomStages = 4;
+
+inline bool isCustomStage(StageId id) {
+  return static_cast<uint8_t>(id) >= static_cast<uint8_t>(StageId::kCustom0) &&
+         static_cast<uint8_t>(id) <
+             static_cast<uint8_t>(StageId::kCustom0) + kMaxCustomStages;
+}
+
+/** "highPass", "lowPass", "filterBank", "gate", ..., "custom0".. */
+const char* stageName(StageId id);
+
+/** Inverse of stageName(). Returns false for unknown names. */
+bool stageFromName(const std::string& name, StageId* out);
+
+/**
+ * Ordered list of up to kMaxStages distinct stages, packed into 64 bits:
+ *   bits 0..39   stage ids, 4 bits each, in run order (0 terminates)
+ *   bits 40..55  membership mask, bit (40 + id)
+ *   bit  63      fused: built-ins only, canonical order
+ */
+class StagePlan {
+ public:
+  static constexpr size_t kMaxStages = 10;
+
+  /** Empty plan: only the rescale / blend back to [-1, 1] runs. */
+  StagePlan() = default;
+
+  /** HPF -> LPF -> filter bank -> gate -> spectral clamp -> comfort noise. */
+  static StagePlan defaults();
+
+  /**
+   * This plan's built-ins minus the filter bank, in canonical order, with
+   * custom stages dropped: the cheapest plan that still gates the same
+   * way (fused). Used while the CPU governor sheds load.
+   */
+  StagePlan lean() const;
+
+  static StagePlan fromPacked(uint64_t packed) {
+    StagePlan p;
+    p.bits_ = packed;
+    return p;
+  }
+
+  /**
+   * Append a stage. Returns false (plan unchanged) when the plan is full,
+   * the id is invalid, or the stage is already in the plan.
+   */
+  bool append(StageId id);
+
+  size_t size() const {
+    size_t n = 0;
+    while (n < kMaxStages && at(n) != StageId::kNone) n++;
+    return n;
+  }
+
+  StageId at(size_t i) const {
+    return static_cast<StageId>((bits_ >> (4 * i)) & 0xF);
+  }
+
+  bool contains(StageId id) const {
+    return (bits_ >> (kMaskShift + static_cast<unsigned>(id))) & 1u;
+  }
+
+  bool fused() const { return (bits_ >> kFusedBit) & 1u; }
+
+  uint64_t packed() const { return bits_; }
+
+  bool operator==(const StagePlan& o) const { return bits_ == o.bits_; }
+  bool operator!=(const StagePlan& o) const { return bits_ != o.bits_; }
+
+ private:
+  static constexpr unsigned kMaskShift = 40;
+  static constexpr unsigned kFusedBit = 63;
+
+  /* An empty plan is trivially in canonical order. */
+  uint64_t bits_ = uint64_t{1} << kFusedBit;
+};
+
+/**
+ * User-defined stage for the runtime plan. Runs on the audio thread on a
+ * whole frame of [-1, 1] floats, in the position the plan gives it.
+ */
+class FrameStage {
+ public:
+  virtual ~FrameStage() = default;
+
+  virtual const char* name() const = 0;
+
+  /** Process `len` samples in place. Real-time safe. */
+  virtual void process(float* frame, size_t len) = 0;
+
+  /** Clear internal state (wrapper init, resume after digital silence). */
+  virtual void reset() {}
+};
+
+}  // namespace ainoiceguard
+
+#endif  // AINOICEGUARD_STAGE_CHAIN_H
@@ -0,0 +1,270 @@
+/**
+ * Capture backlog bound: each OverflowPolicy against an overfilled
+ * capture ring.
+ *
+ * The test plays both sides of captureRing_: the capture callback writes
+ * whole frames (samples the ring rejects are dropped input), and the
+ * processing loop applies the bound before each read, as
+ * AudioEngine::processingLoop() does. Checked per policy:
+ *
+ * - A backlog at the limit is left alone.
+ * - A stall just past the limit: kDropNewest reads the whole backlog,
+ *   kDropOldest skips all but the newest frame, kCatchUp runs the backlog
+ *   as catch-up frames and emits only the newest. Nothing is dropped.
+ * - A stall that overfills the ring: the callback drops the excess;
+ *   kDropNewest keeps the full ring, kDropOldest and kCatchUp cut it to
+ *   the newest frame.
+ * - A backlog that keeps growing during catch-up is cut as in kDropOldest
+ *   before the ring fills, ending the catch-up.
+ * - configure() cancels a catch-up in progress.
+ * - A catch-up after one stall is not reported to the CPU governor as a
+ *   backlog, so it does not step the tier down; without a catch-up the
+ *   backlog is reported.
+ */
+
+#include <cstddef>
+#include <cstdio>
+#include <cstdlib>
+#include <vector>
+
+#include "backlog_bound.h"
+#include "cpu_governor.h"
+#include "ringbuffer.h"
+#include "test_util.h"
+
+using namespace ainoiceguard;
+
+namespace {
+
+constexpr size_t kFrame = 480;         /* kRNNoiseFrameSize */
+constexpr size_t kCapacity = 4096;     /* kRingCapacity in audio.cpp: 8 whole frames */
+constexpr size_t kRingFrames = (kCapacity - 1) / kFrame;
+constexpr size_t kLimitFrames = 3;     /* AudioConfig::maxBacklogFrames default */
+
+/* Both ends of a capture ring, with what happened to every frame. */
+class Capture {
+ public:
+  explicit Capture(OverflowPolicy policy) : ring_(kCapacity), frame_(kFrame, 0.0f) {
+    bound_.configure(policy, kLimitFrames, kFrame);
+  }
+
+  /* Capture callback: `frames` frames arrive; what does not fit is dropped. */
+  void arrive(size_t frames) {
+    for (size_t f = 0; f < frames; f++) {
+      droppedSamples += kFrame - ring_.write(frame_.data(), kFrame);
+    }
+  }
+
+  /* One processing-loop pass: bound, then read and classify one frame. */
+  bool step() {
+    discardedSamples += bound_.apply(ring_);
+    if (ring_.available_read() < kFrame) return false;
+    ring_.read(frame_.data(), kFrame);
+    if (bound_.takeCatchUpFrame()) {
+      catchUpFrames++;
+    } else {
+      emittedFrames++;
+    }
+    return true;
+  }
+
+  /* Processing catches up with no new input. */
+  void drain() {
+    while (step()) {}
+  }
+
+  size_t backlogFrames() const { return ring_.available_read() / kFrame; }
+
+  size_t pressureFrames() const { return bound_.pressureFrames(ring_); }
+
+  BacklogBound& bound() { return bound_; }
+
+  size_t droppedSamples = 0;    /* Rejected by the full ring */
+  size_t discardedSamples = 0;  /* Skipped by the bound */
+  size_t catchUpFrames = 0;     /* Processed, not emitted */
+  size_t emittedFrames = 0;
+
+ private:
+  RingBuffer ring_;
+  BacklogBound bound_;
+  std::vector<float> frame_;
+};
+
+const char* name(OverflowPolicy policy) {
+  switch (policy) {
+    case OverflowPolicy::kDropNewest: return "kDropNewest";
+    case OverflowPolicy::kDropOldest: return "kDropOldest";
+    case OverflowPolicy::kCatchUp: return "kCatchUp";
+  }
+  return "?";
+}
+
+void testAtLimit() {
+  const OverflowPolicy policies[] = {OverflowPolicy::kDropNewest, OverflowPolicy::kDropOldest,
+                                     OverflowPolicy::kCatchUp};
+  for (OverflowPolicy policy : policies) {
+    Capture c(policy);
+    c.arrive(kLimitFrames);
+    c.drain();
+    CHECK(c.emittedFrames == kLimitFrames && c.discardedSamples == 0 && c.catchUpFrames == 0,
+          "%s: backlog of %zu frames bounded", name(policy), kLimitFrames);
+  }
+}
+
+void testShortStall() {
+  constexpr size_t kStall = kLimitFrames + 2;
+
+  {
+    Capture c(OverflowPolicy::kDropNewest);
+    c.arrive(kStall);
+    c.drain();
+    CHECK(c.discardedSamples == 0 && c.catchUpFrames == 0, "kDropNewest: backlog cut");
+    CHECK(c.emittedFrames == kStall, "kDropNewest: %zu of %zu frames emitted", c.emittedFrames,
+          kStall);
+    CHECK(c.droppedSamples == 0, "kDropNewest: %zu samples dropped", c.droppedSamples);
+  }
+  {
+    Capture c(OverflowPolicy::kDropOldest);
+    c.arrive(kStall);
+    c.step();
+    CHECK(c.discardedSamples == (kStall - 1) * kFrame, "kDropOldest: %zu samples skipped",
+          c.discardedSamples);
+    CHECK(c.emittedFrames == 1 && c.backlogFrames() == 0, "kDropOldest: backlog %zu after cut",
+          c.backlogFrames());
+    c.drain();
+    CHECK(c.emittedFrames == 1 && c.catchUpFrames == 0, "kDropOldest: %zu frames emitted",
+          c.emittedFrames);
+    CHECK(c.droppedSamples == 0, "kDropOldest: %zu samples dropped", c.droppedSamples);
+  }
+  {
+    Capture c(OverflowPolicy::kCatchUp);
+    c.arrive(kStall);
+    c.step();
+    CHECK(c.discardedSamples == 0, "kCatchUp: %zu samples skipped", c.discardedSamples);
+    CHECK(c.catchUpFrames == 1 && c.bound().catchUpPending() == kStall - 2,
+          "kCatchUp: %zu catch-up frames pending", c.bound().catchUpPending());
+    c.drain();
+    CHECK(c.catchUpFrames == kStall - 1 && c.emittedFrames == 1,
+          "kCatchUp: %zu catch-up, %zu emitted", c.catchUpFrames, c.emittedFrames);
+    CHECK(c.bound().catchUpPending() == 0 && c.backlogFrames() == 0, "kCatchUp: not caught up");
+    CHECK(c.droppedSamples == 0, "kCatchUp: %zu samples dropped", c.droppedSamples);
+  }
+}
+
+void testOverfill() {
+  constexpr size_t kStall = 2 * kRingFrames;
+  constexpr size_t kDropped = kStall * kFrame - (kCapacity - 1);
+
+  const OverflowPolicy policies[] = {OverflowPolicy::kDropNewest, OverflowPolicy::kDropOldest,
+                                     OverflowPolicy::kCatchUp};
+  for (OverflowPolicy policy : policies) {
+    const char* p = name(policy);
+    Capture c(policy);
+    c.arrive(kStall);
+    CHECK(c.droppedSamples == kDropped, "%s: %zu samples dropped, expected %zu", p,
+          c.droppedSamples, kDropped);
+    CHECK(c.backlogFrames() == kRingFrames, "%s: %zu frames held", p, c.backlogFrames());
+
+    c.step();
+    c.arrive(1);  /* Room again: nothing more is dropped */
+    CHECK(c.droppedSamples == kDropped, "%s: %zu samples dropped after the read", p,
+          c.droppedSamples);
+    CHECK(c.catchUpFrames == 0 && c.bound().catchUpPending() == 0, "%s: caught up on a full ring",
+          p);
+    if (policy == OverflowPolicy::kDropNewest) {
+      CHECK(c.discardedSamples == 0, "%s: %zu samples skipped", p, c.discardedSamples);
+      CHECK(c.backlogFrames() == kRingFrames, "%s: backlog %zu, expected %zu", p,
+            c.backlogFrames(), kRingFrames);
+    } else {
+      CHECK(c.discardedSamples == (kRingFrames - 1) * kFrame, "%s: %zu samples skipped", p,
+            c.discardedSamples);
+      CHECK(c.backlogFrames() == 1, "%s: backlog %zu after cut, expected 1", p,
+            c.backlogFrames());
+    }
+  }
+}
+
+void testCatchUpFallsBack() {
+  Capture c(OverflowPolicy::kCatchUp);
+  c.arrive(kLimitFrames + 2);
+  c.step();
+  CHECK(c.bound().catchUpPending() > 0, "catch-up not started");
+
+  /* Processing now runs at half speed: the backlog grows a frame per pass. */
+  size_t passes = 0;
+  while (c.discardedSamples == 0 && passes++ < kRingFrames) {
+    c.arrive(2);
+    c.step();
+  }
+  CHECK(c.discardedSamples > 0, "growing backlog never cut");
+  CHECK(c.discardedSamples % kFrame == 0, "cut of %zu samples is not whole frames",
+        c.discardedSamples);
+  CHECK(c.bound().catchUpPending() == 0, "catch-up still pending after the cut");
+  CHECK(c.backlogFrames() == 0, "backlog %zu after the cut's read", c.backlogFrames());
+  CHECK(c.droppedSamples == 0, "%zu samples dropped before the cut", c.droppedSamples);
+}
+
+void testConfigureCancelsCatchUp() {
+  Capture c(OverflowPolicy::kCatchUp);
+  c.arrive(kLimitFrames + 2);
+  c.step();
+  CHECK(c.bound().catchUpPending() > 0, "catch-up not started");
+  c.bound().configure(OverflowPolicy::kCatchUp, kLimitFrames, kFrame);
+  CHECK(c.bound().catchUpPending() == 0, "configure() kept the catch-up");
+  CHECK(!c.bound().takeCatchUpFrame(), "catch-up frame after configure()");
+}
+
+void testCatchUpIsNotPressure() {
+  constexpr uint32_t kBudgetUs = 10000;
+  constexpr uint32_t kLightUs = 2000;  /* Load 0.2: only a backlog could read as pressure */
+  constexpr size_t kHostFrames = 1;
+  constexpr size_t kStall = kLimitFrames + 2;
+
+  Capture c(OverflowPolicy::kCatchUp);
+  CpuGovernor g;
+  /* One pass of the processing loop, then the engine's governor update. */
+  auto pass = [&] {
+    if (c.step()) g.update(kLightUs, kBudgetUs, c.pressureFrames(), kHostFrames);
+  };
+
+  for (int i = 0; i < 50; i++) {
+    c.arrive(1);
+    pass();
+  }
+  c.arrive(kStall);
+  /* Work the stall off at two frames per frame period. */
+  for (int i = 0; i < 40; i++) {
+    if (i % 2 == 1) c.arrive(1);
+    pass();
+  }
+  CHECK(c.catchUpFrames == kStall - 1, "%zu catch-up frames, expected %zu", c.catchUpFrames,
+        kStall - 1);
+  CHECK(g.tier() == QualityTier::kFull && g.stepsDown() == 0,
+        "one stall under kCatchUp stepped the tier down %llu time(s)",
+        static_cast<unsigned long long>(g.stepsDown()));
+
+  /* No catch-up to excuse it: a backlog is still reported as pressure. */
+  Capture d(OverflowPolicy::kDropNewest);
+  d.arrive(kStall);
+  d.step();
+  CHECK(d.pressureFrames() == kStall - 1, "kDropNewest: %zu pressure frames, expected %zu",
+        d.pressureFrames(), kStall - 1);
+}
+
+}  // namespace
+
+int main() {
+  testAtLimit();
+  testShortStall();
+  testOverfill();
+  testCatchUpFallsBack();
+  testConfigureCancelsCatchUp();
+  testCatchUpIsNotPressure();
+
+  if (g_failures) {
+    std::fprintf(stderr, "%d failure(s)\n", g_failures);
+    return EXIT_FAILURE;
+  }
+  std::printf("backlog_bound OK\n");
+  return EXIT_SUCCESS;
+}
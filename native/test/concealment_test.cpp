@@ -0,0 +1,125 @@
+/**
+ * UnderrunConcealer (output-side packet-loss concealment).
+ *
+ * - Full blocks pass through untouched.
+ * - A shortfall after a steady tone continues the tone: the detected
+ *   period matches, and past the entry ramp the fill tracks the real
+ *   continuation.
+ * - Long gaps decay to comfort-noise level; with no history the fill is
+ *   comfort noise only.
+ * - Returning audio is crossfaded in: no step larger than the tone's own
+ *   slope plus the crossfade increment, even when the new audio is out
+ *   of phase.
+ */
+
+#include <algorithm>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <vector>
+
+#include "concealment.h"
+#include "test_util.h"
+
+using namespace ainoiceguard;
+
+namespace {
+
+constexpr float kPi = 3.14159265358979f;
+constexpr size_t kPeriod = 240;  /* 200 Hz at 48 kHz */
+constexpr float kAmp = 0.5f;
+
+float tone(size_t n, float phase = 0.0f) {
+  return kAmp * std::sin(2.0f * kPi * static_cast<float>(n) / kPeriod + phase);
+}
+
+/* Feed `count` tone samples starting at sample `n` in blocks of 128. */
+void feed(UnderrunConcealer& c, size_t n, size_t count) {
+  float block[128];
+  for (size_t done = 0; done < count; done += 128) {
+    for (size_t i = 0; i < 128; i++) block[i] = tone(n + done + i);
+    c.process(block, 128, 128);
+    for (size_t i = 0; i < 128; i++) {
+      CHECK(block[i] == tone(n + done + i), "full block altered at %zu", done + i);
+    }
+  }
+}
+
+void testContinuesTone() {
+  UnderrunConcealer c;
+  feed(c, 0, 1024);
+
+  float gap[256];
+  c.process(gap, 0, 256);
+  CHECK(c.concealing(), "not concealing after a shortfall");
+  CHECK(c.period() + 1 >= kPeriod && c.period() <= kPeriod + 1, "period %zu, expected %zu",
+        c.period(), kPeriod);
+
+  float worst = 0.0f;
+  for (size_t i = UnderrunConcealer::kEntrySamples; i < 256; i++) {
+    worst = std::max(worst, std::abs(gap[i] - tone(1024 + i)));
+  }
+  CHECK(worst < 0.02f, "concealment strays %.4f from the tone", worst);
+}
+
+void testLongGapDecays() {
+  UnderrunConcealer c;
+  feed(c, 0, 1024);
+
+  const size_t total = UnderrunConcealer::kHoldSamples + UnderrunConcealer::kFadeSamples + 480;
+  std::vector<float> gap(total);
+  c.process(gap.data(), 0, total);
+  float tail = 0.0f;
+  for (size_t i = total - 480; i < total; i++) tail = std::max(tail, std::abs(gap[i]));
+  CHECK(tail <= ComfortNoise::kLevel, "tail peak %.6f above comfort noise", tail);
+
+  UnderrunConcealer fresh;
+  float empty[480];
+  fresh.process(empty, 0, 480);
+  float peak = 0.0f;
+  for (float v : empty) peak = std::max(peak, std::abs(v));
+  CHECK(peak <= ComfortNoise::kLevel, "no-history fill peak %.6f", peak);
+}
+
+void testSpliceBack() {
+  UnderrunConcealer c;
+  feed(c, 0, 1024);
+
+  /* Block: 64 real samples, then a 200-sample shortfall. */
+  std::vector<float> out;
+  float block[264];
+  for (size_t i = 0; i < 64; i++) block[i] = tone(1024 + i);
+  c.process(block, 64, 264);
+  out.insert(out.end(), block, block + 264);
+
+  /* Audio returns half a period out of phase. */
+  for (size_t b = 0; b < 4; b++) {
+    float next[128];
+    for (size_t i = 0; i < 128; i++) next[i] = tone(2000 + b * 128 + i, kPi);
+    c.process(next, 128, 128);
+    out.insert(out.end(), next, next + 128);
+  }
+  CHECK(!c.concealing(), "still concealing after real audio returned");
+
+  const float slope = 2.0f * kPi * kAmp / kPeriod;
+  const float fadeStep = 2.0f * kAmp / (UnderrunConcealer::kSpliceSamples + 1);
+  float step = 0.0f;
+  for (size_t i = 1; i < out.size(); i++) step = std::max(step, std::abs(out[i] - out[i - 1]));
+  CHECK(step <= 1.5f * slope + fadeStep, "step %.4f at a splice (limit %.4f)", step,
+        1.5f * slope + fadeStep);
+}
+
+}  // namespace
+
+int main() {
+  testContinuesTone();
+  testLongGapDecays();
+  testSpliceBack();
+
+  if (g_failures) {
+    std::fprintf(stderr, "%d failure(s)\n", g_failures);
+    return EXIT_FAILURE;
+  }
+  std::printf("concealment OK\n");
+  return EXIT_SUCCESS;
+}
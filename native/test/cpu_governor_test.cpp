@@ -0,0 +1,123 @@
+/**
+ * CpuGovernor (load shedding through QualityTier).
+ *
+ * - Light load stays at kFull; a backlog within the host-buffer
+ *   allowance is not pressure.
+ * - Sustained overload steps down one tier per pressure + settle period
+ *   and stops at the floor.
+ * - When shedding the residual pass fixes the overload, the governor
+ *   stays on kSinglePass: the predicted full-tier load is still too high,
+ *   so it never steps back up.
+ * - Real headroom steps back up to kFull, one tier per headroom wait.
+ * - A step up that has to be undone doubles the wait.
+ */
+
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+
+#include "cpu_governor.h"
+#include "test_util.h"
+
+using namespace ainoiceguard;
+
+namespace {
+
+constexpr uint32_t kBudget = 10000;
+
+/* Relative processing cost per tier: pass 2 is half the work. */
+constexpr float kCost[CpuGovernor::kTierCount] = {1.0f, 0.5f, 0.45f, 0.3f};
+
+/* Run `frames` frames whose full-tier cost is `fullLoad` of the budget. */
+void run(CpuGovernor& g, float fullLoad, size_t frames, size_t backlog = 0) {
+  for (size_t i = 0; i < frames; i++) {
+    const float cost = fullLoad * kCost[static_cast<int>(g.tier())];
+    g.update(static_cast<uint32_t>(cost * kBudget), kBudget, backlog, 1);
+  }
+}
+
+void testLightLoad() {
+  CpuGovernor g;
+  run(g, 0.3f, 2000, 1);
+  CHECK(g.tier() == QualityTier::kFull, "tier %d under light load", static_cast<int>(g.tier()));
+  CHECK(g.stepsDown() == 0, "%llu steps down", static_cast<unsigned long long>(g.stepsDown()));
+}
+
+void testStepsDownToFloor() {
+  CpuGovernor g;
+  run(g, 4.0f, 1000);
+  CHECK(g.tier() == QualityTier::kLittleModel, "tier %d, expected the floor",
+        static_cast<int>(g.tier()));
+  CHECK(g.stepsDown() == 3, "%llu steps down", static_cast<unsigned long long>(g.stepsDown()));
+
+  /* One tier per pressure + settle period, not all at once. */
+  CpuGovernor h;
+  run(h, 4.0f, 2 + CpuGovernor::kPressureFrames);  /* Load EMA crosses 0.8 on frame 3 */
+  CHECK(h.tier() == QualityTier::kSinglePass, "tier %d after one pressure period",
+        static_cast<int>(h.tier()));
+  run(h, 4.0f, CpuGovernor::kSettleFrames + CpuGovernor::kPressureFrames - 1);
+  CHECK(h.tier() == QualityTier::kSinglePass, "stepped again while settling");
+
+  CpuGovernor floored;
+  floored.setFloor(QualityTier::kSinglePass);
+  run(floored, 4.0f, 1000);
+  CHECK(floored.tier() == QualityTier::kSinglePass, "floor ignored: tier %d",
+        static_cast<int>(floored.tier()));
+
+  CpuGovernor behind;
+  run(behind, 0.3f, 50, 3);
+  CHECK(behind.tier() != QualityTier::kFull, "backlog beyond the allowance not acted on");
+}
+
+void testNoOscillation() {
+  CpuGovernor g;
+  run(g, 0.9f, 20000);
+  CHECK(g.tier() == QualityTier::kSinglePass, "tier %d, expected kSinglePass",
+        static_cast<int>(g.tier()));
+  CHECK(g.stepsUp() == 0, "%llu steps up: oscillating",
+        static_cast<unsigned long long>(g.stepsUp()));
+}
+
+void testRecovers() {
+  CpuGovernor g;
+  run(g, 4.0f, 1000);
+  run(g, 0.2f, 3 * (CpuGovernor::kHeadroomFrames + CpuGovernor::kSettleFrames) + 100);
+  CHECK(g.tier() == QualityTier::kFull, "tier %d after headroom returned",
+        static_cast<int>(g.tier()));
+  CHECK(g.stepsUp() == 3, "%llu steps up", static_cast<unsigned long long>(g.stepsUp()));
+  CHECK(g.headroomWait() == CpuGovernor::kHeadroomFrames, "wait %u",
+        static_cast<unsigned>(g.headroomWait()));
+}
+
+void testBounceBacksOff() {
+  /* Backlog at kFull only: each step up is undone straight away. */
+  CpuGovernor g;
+  g.setFloor(QualityTier::kSinglePass);
+  uint64_t ups = 0;
+  for (size_t i = 0; i < 20000; i++) {
+    const size_t backlog = g.tier() == QualityTier::kFull ? 3 : 0;
+    g.update(2000, kBudget, backlog, 1);
+    ups = g.stepsUp();
+  }
+  CHECK(g.headroomWait() == CpuGovernor::kMaxHeadroomFrames, "wait %u after bounces",
+        static_cast<unsigned>(g.headroomWait()));
+  /* Waits of 200, 400, 800, 1600, then 3200 frames: 9 bounces (50 at a fixed wait). */
+  CHECK(ups <= 10, "%llu steps up in 200 s", static_cast<unsigned long long>(ups));
+}
+
+}  // namespace
+
+int main() {
+  testLightLoad();
+  testStepsDownToFloor();
+  testNoOscillation();
+  testRecovers();
+  testBounceBacksOff();
+
+  if (g_failures) {
+    std::fprintf(stderr, "%d failure(s)\n", g_failures);
+    return EXIT_FAILURE;
+  }
+  std::printf("cpu_governor OK\n");
+  return EXIT_SUCCESS;
+}
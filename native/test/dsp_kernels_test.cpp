@@ -0,0 +1,121 @@
+/**
+ * Kernel conformance test: every SIMD table supported by this CPU must
+ * match the scalar reference (within float tolerance) on odd lengths,
+ * unaligned pointers and edge values.
+ *
+ * Run via ctest (configure with -DNOISEGUARD_BUILD_TESTS=ON).
+ */
+
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <vector>
+
+#include "dsp_kernels.h"
+#include "test_util.h"
+
+using ainoiceguard::DspKernels;
+
+namespace {
+
+bool near(float a, float b, float relTol) {
+  float scale = std::max(1.0f, std::max(std::abs(a), std::abs(b)));
+  return std::abs(a - b) <= relTol * scale;
+}
+
+/* Deterministic signal in [-1, 1] with some exact zeros and tiny values. */
+std::vector<float> makeSignal(size_t n, uint32_t seed) {
+  std::vector<float> v(n);
+  for (size_t i = 0; i < n; i++) {
+    seed = seed * 1664525u + 1013904223u;
+    float x = static_cast<float>(static_cast<int32_t>(seed)) / 2147483648.0f;
+    if (i % 17 == 0) x = 0.0f;
+    if (i % 13 == 0) x *= 1e-4f;
+    v[i] = x;
+  }
+  return v;
+}
+
+void testTable(const DspKernels& ref, const DspKernels& k) {
+  /* 480 = RNNoise frame; others exercise vector tails and offsets. */
+  const size_t lengths[] = {0, 1, 3, 7, 8, 15, 16, 17, 31, 479, 480, 481};
+  const size_t offsets[] = {0, 1, 3};
+  constexpr float kTol = 1e-5f;
+
+  for (size_t n : lengths) {
+    for (size_t off : offsets) {
+      std::vector<float> base = makeSignal(n + off, static_cast<uint32_t>(n * 31 + off));
+      const float* x = base.data() + off;
+
+      /* sumSquares */
+      float a = ref.sumSquares(x, n);
+      float b = k.sumSquares(x, n);
+      CHECK(near(a, b, kTol), "[%s] sumSquares n=%zu off=%zu: %g vs %g",
+            k.name, n, off, a, b);
+
+      /* scaleCopy */
+      std::vector<float> r1(base), r2(base), o1(n + off), o2(n + off);
+      ref.scaleCopy(r1.data() + off, o1.data() + off, 32767.0f, n);
+      k.scaleCopy(r2.data() + off, o2.data() + off, 32767.0f, n);
+      for (size_t i = off; i < n + off; i++) {
+        CHECK(r1[i] == r2[i] && o1[i] == o2[i],
+              "[%s] scaleCopy n=%zu i=%zu", k.name, n, i);
+      }
+
+      /* scale */
+      r1 = base; r2 = base;
+      ref.scale(r1.data() + off, 1.0f / 32767.0f, n);
+      k.scale(r2.data() + off, 1.0f / 32767.0f, n);
+      for (size_t i = off; i < n + off; i++) {
+        CHECK(r1[i] == r2[i], "[%s] scale n=%zu i=%zu", k.name, n, i);
+      }
+
+      /* blend (FMA variants may round differently) */
+      std::vector<float> dry = makeSignal(n + off, 99);
+      r1 = base; r2 = base;
+      ref.blend(r1.data() + off, dry.data() + off, 0.7f, 0.3f, n);
+      k.blend(r2.data() + off, dry.data() + off, 0.7f, 0.3f, n);
+      for (size_t i = off; i < n + off; i++) {
+        CHECK(near(r1[i], r2[i], kTol), "[%s] blend n=%zu i=%zu: %g vs %g",
+              k.name, n, i, r1[i], r2[i]);
+      }
+
+      /* clampBelow: threshold hits both sides of many samples */
+      r1 = base; r2 = base;
+      ref.clampBelow(r1.data() + off, 0.25f, n);
+      k.clampBelow(r2.data() + off, 0.25f, n);
+      for (size_t i = off; i < n + off; i++) {
+        CHECK(r1[i] == r2[i], "[%s] clampBelow n=%zu i=%zu", k.name, n, i);
+      }
+    }
+  }
+
+  /* Exact-threshold samples are kept (|x| < t is strict); NaN survives. */
+  float edge[9] = {0.25f, -0.25f, 0.2499f, -0.2499f, NAN, 1.0f, -1.0f, 0.0f, 0.3f};
+  k.clampBelow(edge, 0.25f, 9);
+  CHECK(edge[0] == 0.25f && edge[1] == -0.25f, "[%s] clamp edge kept", k.name);
+  CHECK(edge[2] == 0.0f && edge[3] == 0.0f, "[%s] clamp edge zeroed", k.name);
+  CHECK(std::isnan(edge[4]), "[%s] clamp keeps NaN", k.name);
+}
+
+}  // namespace
+
+int main() {
+  const DspKernels& ref = ainoiceguard::scalarDspKernels();
+  auto tables = ainoiceguard::supportedDspKernels();
+
+  std::printf("dispatch selects: %s\n", ainoiceguard::dspKernels().name);
+  for (const DspKernels* k : tables) {
+    std::printf("testing %s\n", k->name);
+    testTable(ref, *k);
+  }
+
+  if (g_failures) {
+    std::fprintf(stderr, "%d failure(s)\n", g_failures);
+    return EXIT_FAILURE;
+  }
+  std::printf("all kernel tables match scalar reference\n");
+  return EXIT_SUCCESS;
+}
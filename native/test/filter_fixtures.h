@@ -0,0 +1,39 @@
+/**
+ * Shared fixtures for the post-filter tests (post_filter_test,
+ * stage_chain_test): the 80 Hz high-pass / 8 kHz low-pass biquads
+ * and a deterministic RNNoise-range frame to run through them.
+ */
+
+#ifndef AINOICEGUARD_FILTER_FIXTURES_H
+#define AINOICEGUARD_FILTER_FIXTURES_H
+
+#include <cmath>
+#include <cstdint>
+
+#include "post_filter.h"
+
+namespace ainoiceguard {
+namespace test {
+
+constexpr size_t kFrame = 480;
+
+inline void makeFilters(BiquadState& hpf, BiquadState& lpf) {
+  hpf.b0 = 0.992631f; hpf.b1 = -1.985261f; hpf.b2 = 0.992631f;
+  hpf.a1 = -1.985199f; hpf.a2 = 0.985323f;
+  lpf.b0 = 0.155029f; lpf.b1 = 0.310059f; lpf.b2 = 0.155029f;
+  lpf.a1 = -0.620209f; lpf.a2 = 0.240326f;
+}
+
+/* RNNoise-range frame (int16 scale), deterministic. */
+inline void makeFrame(float* f, uint32_t seed) {
+  for (size_t i = 0; i < kFrame; i++) {
+    seed = seed * 1664525u + 1013904223u;
+    float noise = static_cast<float>(static_cast<int32_t>(seed)) / 2147483648.0f;
+    f[i] = 3000.0f * std::sin(0.03f * static_cast<float>(i)) + 200.0f * noise;
+  }
+}
+
+}  // namespace test
+}  // namespace ainoiceguard
+
+#endif  // AINOICEGUARD_FILTER_FIXTURES_H
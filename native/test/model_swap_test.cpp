@@ -0,0 +1,346 @@
+/**
+ * Model hot-swap hand-off (pendingSwap_ → swap_ → retired_), checked
+ * against raw RNNoise states.
+ *
+ * The wrapper runs an empty stage plan at full suppression, so its output
+ * is exactly its RNNoise passes; the test mirrors the outgoing and the
+ * incoming pass-1/pass-2 pair with its own DenoiseStates:
+ *
+ * - A swap published mid-stream is taken on the next frame, warms up
+ *   beside the old pair, hands over with a crossfade into the new
+ *   state2, and from then on only the new pair runs: every frame matches
+ *   the reference, so no frame ever ran a pass-1 state with the other
+ *   model's state2.
+ * - The replaced states wait in retired_ until reclaimRetired(), and a
+ *   swap published meanwhile is held until they are freed.
+ * - Through RNNoisePipeline, where pass 2 installs the new state2 on its
+ *   own thread, the output is the same frame for frame.
+ * - A model file rewritten in place and loaded again by path yields the
+ *   new weights, and swapping to it runs them.
+ * - A missing or empty model file fails to load.
+ */
+
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <memory>
+#include <vector>
+
+#include "rnnoise_fixtures.h"
+#include "rnnoise_kernels.h"
+#include "rnnoise_model.h"
+#include "rnnoise_pipeline.h"
+#include "rnnoise_wrapper.h"
+#include "test_util.h"
+
+using namespace ainoiceguard;
+using namespace ainoiceguard::test;
+
+namespace {
+
+/* The frame a swap taken on frame 0 hands over on. */
+constexpr size_t kHandOver = static_cast<size_t>(kTierWarmupFrames) - 1;
+
+/* The pass-1 / pass-2 pair one model generation runs. */
+struct RefChain {
+  explicit RefChain(RNNModel* model = nullptr) : pass1(model), pass2(model) {}
+
+  RefPass pass1;
+  RefPass pass2;
+
+  void run(float* out, const float* in) {
+    float p1[kN];
+    pass1.run(p1, in);
+    pass2.run(out, p1);
+  }
+};
+
+/*
+ * Expected output `age` frames after a swap from `from` to `to` was taken
+ * (`in` in int16 range): both pairs run during warm-up, the hand-over
+ * frame feeds the crossfaded pass-1 output to the new state2, then only
+ * `to` runs.
+ */
+void swapFrame(RefChain& from, RefChain& to, size_t age, const float* in, float* expect) {
+  if (age > kHandOver) {
+    to.run(expect, in);
+    return;
+  }
+  float incoming[kN];
+  to.pass1.run(incoming, in);
+  if (age < kHandOver) {
+    float scratch[kN];
+    to.pass2.run(scratch, incoming);
+    from.run(expect, in);
+    return;
+  }
+  float outgoing[kN];
+  from.pass1.run(outgoing, in);
+  for (size_t i = 0; i < kN; i++) {
+    float w = static_cast<float>(i) * kFadeStep;
+    outgoing[i] = outgoing[i] * (1.0f - w) + incoming[i] * w;
+  }
+  to.pass2.run(expect, outgoing);
+}
+
+/*
+ * Writes an RNNoise model file (text format, version 1) with the
+ * built-in model's layer shapes and small pseudo-random weights.
+ * Returns the file size in bytes, or 0 on failure.
+ */
+size_t writeModelFile(const char* path, uint32_t seed) {
+  FILE* f = std::fopen(path, "w");
+  if (!f) return 0;
+  auto values = [&](size_t n) {
+    for (size_t i = 0; i < n; i++) {
+      seed = seed * 1664525u + 1013904223u;
+      std::fprintf(f, "%d ", static_cast<int>(seed >> 27) - 16);
+    }
+    std::fprintf(f, "\n");
+  };
+  /* inputs, neurons, activation (0 tanh, 1 sigmoid, 2 relu) */
+  auto dense = [&](int in, int out, int act) {
+    std::fprintf(f, "%d %d %d\n", in, out, act);
+    values(static_cast<size_t>(in) * out);
+    values(static_cast<size_t>(out));
+  };
+  auto gru = [&](int in, int out, int act) {
+    std::fprintf(f, "%d %d %d\n", in, out, act);
+    values(static_cast<size_t>(in) * out * 3);
+    values(static_cast<size_t>(out) * out * 3);
+    values(static_cast<size_t>(out) * 3);
+  };
+  std::fprintf(f, "rnnoise-nu model file version 1\n");
+  dense(42, 24, 0);   /* input_dense */
+  gru(24, 24, 2);     /* vad_gru */
+  gru(90, 48, 2);     /* noise_gru */
+  gru(114, 96, 2);    /* denoise_gru */
+  dense(96, 22, 1);   /* denoise_output */
+  dense(24, 1, 1);    /* vad_output */
+  const long size = std::ftell(f);
+  const bool ok = std::fclose(f) == 0;
+  return ok && size > 0 ? static_cast<size_t>(size) : 0;
+}
+
+/* The file's weights parsed directly, bypassing RNNoiseModel's cache. */
+RNNModel* parseModelFile(const char* path) {
+  FILE* f = std::fopen(path, "rb");
+  if (!f) return nullptr;
+  RNNModel* model = rnnoiseKernels().modelFromFile(f);
+  std::fclose(f);
+  return model;
+}
+
+void testSwapHandsOverMatchedStates() {
+  constexpr size_t kSwapAt = 20;
+  constexpr size_t kFrames = 60;
+
+  RNNoiseWrapper w;
+  initPlain(w);
+  RefChain oldChain, newChain;
+  uint32_t seed = 1;
+
+  for (size_t f = 0; f < kFrames; f++) {
+    if (f == kSwapAt) CHECK(w.prepareModelSwap(nullptr), "prepareModelSwap failed");
+
+    float frame[kN], in[kN], expect[kN];
+    fillFrame(frame, f, 0.05f, 0.2f, &seed);
+    toInt16Range(frame, in);
+    if (f < kSwapAt) {
+      oldChain.run(expect, in);
+    } else {
+      swapFrame(oldChain, newChain, f - kSwapAt, in, expect);
+    }
+
+    w.processFrame(frame);
+    float err = maxError(frame, expect);
+    CHECK(err <= kTolerance, "frame %zu: output off by %g", f, err);
+
+    const bool done = f >= kSwapAt + kHandOver;
+    CHECK(!w.swapPending(), "frame %zu: swap not taken", f);
+    CHECK(w.metrics().modelSwaps.load() == (done ? 1u : 0u), "frame %zu: %llu swaps", f,
+          static_cast<unsigned long long>(w.metrics().modelSwaps.load()));
+    CHECK(w.reclaimPending() == done, "frame %zu: reclaim pending=%d", f, w.reclaimPending());
+  }
+
+  w.reclaimRetired();
+  CHECK(!w.reclaimPending(), "old states not freed by reclaimRetired()");
+}
+
+void testSwapWaitsForReclaim() {
+  constexpr size_t kFirstAt = 10;
+  constexpr size_t kSecondAt = kFirstAt + 3;  /* Published while the first warms up */
+  constexpr size_t kReclaimAt = 40;
+  constexpr size_t kFrames = 80;
+
+  RNNoiseWrapper w;
+  initPlain(w);
+  std::unique_ptr<RefChain> chains[3];
+  for (auto& c : chains) c = std::make_unique<RefChain>();
+  uint32_t seed = 2;
+
+  for (size_t f = 0; f < kFrames; f++) {
+    if (f == kFirstAt) CHECK(w.prepareModelSwap(nullptr), "first swap failed");
+    if (f == kSecondAt) CHECK(w.prepareModelSwap(nullptr), "second swap failed");
+    if (f == kReclaimAt) {
+      CHECK(w.swapPending(), "second swap taken before the first was reclaimed");
+      CHECK(w.metrics().modelSwaps.load() == 1, "%llu swaps before reclaim",
+            static_cast<unsigned long long>(w.metrics().modelSwaps.load()));
+      w.reclaimRetired();
+      CHECK(!w.reclaimPending(), "first swap's states not freed");
+    }
+
+    float frame[kN], in[kN], expect[kN];
+    fillFrame(frame, f, 0.05f, 0.2f, &seed);
+    toInt16Range(frame, in);
+    if (f < kFirstAt) {
+      chains[0]->run(expect, in);
+    } else if (f < kReclaimAt) {
+      swapFrame(*chains[0], *chains[1], f - kFirstAt, in, expect);
+    } else {
+      swapFrame(*chains[1], *chains[2], f - kReclaimAt, in, expect);
+    }
+
+    w.processFrame(frame);
+    float err = maxError(frame, expect);
+    CHECK(err <= kTolerance, "frame %zu: output off by %g", f, err);
+  }
+
+  CHECK(!w.swapPending() && w.metrics().modelSwaps.load() == 2, "second swap not completed");
+  w.reclaimRetired();
+  CHECK(!w.reclaimPending(), "second swap's states not freed");
+}
+
+void testPipelinedHandOff() {
+  constexpr size_t kSwapAt = 30;
+  constexpr size_t kFrames = 100;
+
+  std::vector<float> input(kFrames * kN);
+  std::vector<float> expect(kFrames * kN);
+  RefChain oldChain, newChain;
+  uint32_t seed = 3;
+  for (size_t f = 0; f < kFrames; f++) {
+    float* frame = input.data() + f * kN;
+    float in[kN];
+    fillFrame(frame, f, 0.05f, 0.2f, &seed);
+    toInt16Range(frame, in);
+    if (f < kSwapAt) {
+      oldChain.run(expect.data() + f * kN, in);
+    } else {
+      swapFrame(oldChain, newChain, f - kSwapAt, in, expect.data() + f * kN);
+    }
+  }
+
+  RNNoiseWrapper w;
+  initPlain(w);
+  RNNoisePipeline pipeline;
+  pipeline.start(&w);
+  std::vector<float> out = input;
+  pipeline.process(out.data(), kSwapAt);
+  CHECK(w.prepareModelSwap(nullptr), "prepareModelSwap failed");  /* Drained: taken next */
+  pipeline.process(out.data() + kSwapAt * kN, kFrames - kSwapAt);
+  pipeline.stop();
+
+  for (size_t f = 0; f < kFrames; f++) {
+    float err = maxError(out.data() + f * kN, expect.data() + f * kN);
+    CHECK(err <= kTolerance, "pipelined frame %zu: output off by %g", f, err);
+  }
+  CHECK(w.metrics().modelSwaps.load() == 1, "%llu swaps",
+        static_cast<unsigned long long>(w.metrics().modelSwaps.load()));
+  CHECK(w.reclaimPending(), "pass 2 did not retire the old states");
+  w.reclaimRetired();
+  CHECK(!w.reclaimPending(), "old states not freed by reclaimRetired()");
+}
+
+void testSwapReloadsRewrittenFile() {
+  constexpr const char* kPath = "model_swap_test.rnnn";
+  constexpr size_t kFirstAt = 10;
+  constexpr size_t kSecondAt = 40;
+  constexpr size_t kFrames = 80;
+
+  /* The same path, retuned in place between the two swaps. */
+  std::shared_ptr<const RNNoiseModel> first, second, again;
+  CHECK(writeModelFile(kPath, 11) > 0, "cannot write %s", kPath);
+  CHECK(RNNoiseModel::load(kPath, &first).empty(), "first load failed");
+  RNNModel* refFirst = parseModelFile(kPath);
+  const size_t bytes = writeModelFile(kPath, 22);
+  CHECK(RNNoiseModel::load(kPath, &second).empty(), "reload failed");
+  RNNModel* refSecond = parseModelFile(kPath);
+  CHECK(RNNoiseModel::load(kPath, &again).empty(), "third load failed");
+  std::remove(kPath);
+  if (!first || !second || !refFirst || !refSecond) {
+    CHECK(false, "model files not parsed");
+    rnnoiseKernels().modelFree(refFirst);
+    rnnoiseKernels().modelFree(refSecond);
+    return;
+  }
+  CHECK(second != first, "rewritten file returned the cached model");
+  CHECK(second->fileBytes() == bytes, "reloaded model reports %zu bytes, file has %zu",
+        second->fileBytes(), bytes);
+  CHECK(again == second, "unchanged file not shared from the cache");
+
+  {
+    RNNoiseWrapper w;
+    initPlain(w);
+    RefChain builtIn, oldWeights(refFirst), newWeights(refSecond);
+    uint32_t seed = 4;
+
+    for (size_t f = 0; f < kFrames; f++) {
+      if (f == kFirstAt) CHECK(w.prepareModelSwap(first), "first swap failed");
+      if (f == kSecondAt) {
+        w.reclaimRetired();
+        CHECK(w.prepareModelSwap(second), "second swap failed");
+      }
+
+      float frame[kN], in[kN], expect[kN];
+      fillFrame(frame, f, 0.05f, 0.2f, &seed);
+      toInt16Range(frame, in);
+      if (f < kFirstAt) {
+        builtIn.run(expect, in);
+      } else if (f < kSecondAt) {
+        swapFrame(builtIn, oldWeights, f - kFirstAt, in, expect);
+      } else {
+        swapFrame(oldWeights, newWeights, f - kSecondAt, in, expect);
+      }
+
+      w.processFrame(frame);
+      float err = maxError(frame, expect);
+      CHECK(err <= kTolerance, "frame %zu: output off by %g", f, err);
+    }
+    CHECK(w.metrics().modelSwaps.load() == 2, "%llu swaps",
+          static_cast<unsigned long long>(w.metrics().modelSwaps.load()));
+  }
+
+  rnnoiseKernels().modelFree(refFirst);
+  rnnoiseKernels().modelFree(refSecond);
+}
+
+void testLoadRejectsUnreadableFiles() {
+  constexpr const char* kPath = "model_swap_test_empty.rnnn";
+  std::shared_ptr<const RNNoiseModel> model;
+  CHECK(!RNNoiseModel::load("model_swap_test_missing.rnnn", &model).empty(),
+        "missing file loaded");
+  FILE* f = std::fopen(kPath, "wb");
+  if (f) std::fclose(f);
+  CHECK(!RNNoiseModel::load(kPath, &model).empty(), "empty file loaded");
+  std::remove(kPath);
+  CHECK(!model, "failed load set the model");
+}
+
+}  // namespace
+
+int main() {
+  testSwapHandsOverMatchedStates();
+  testSwapWaitsForReclaim();
+  testPipelinedHandOff();
+  testSwapReloadsRewrittenFile();
+  testLoadRejectsUnreadableFiles();
+
+  if (g_failures) {
+    std::fprintf(stderr, "%d failure(s)\n", g_failures);
+    return EXIT_FAILURE;
+  }
+  std::printf("model_swap OK\n");
+  return EXIT_SUCCESS;
+}
@@ -0,0 +1,125 @@
+/**
+ * Fused post-filter passes vs the original multi-sweep pipeline.
+ *
+ * The reference below is the pre-fusion processFrame() post-processing,
+ * written out as separate loops over the frame. Pass A (rescale, blend,
+ * HPF, LPF) must match it bit-for-bit sample-wise; pass B and both energy
+ * sums must match within float tolerance (SIMD summation order / FMA).
+ */
+
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <vector>
+
+#include "dsp_kernels.h"
+#include "filter_fixtures.h"
+#include "post_filter.h"
+#include "test_util.h"
+
+using namespace ainoiceguard;
+using namespace ainoiceguard::test;
+
+namespace {
+
+bool near(float a, float b, float relTol) {
+  float scale = std::max(1e-3f, std::max(std::abs(a), std::abs(b)));
+  return std::abs(a - b) <= relTol * scale;
+}
+
+/* ── Reference: the original unfused sequence ── */
+
+float refPreGate(float* frame, const float* original, float level,
+                 BiquadState& hpf, BiquadState& lpf) {
+  for (size_t i = 0; i < kFrame; i++) frame[i] *= 1.0f / 32767.0f;
+  if (level < 1.0f) {
+    float dry = 1.0f - level;
+    for (size_t i = 0; i < kFrame; i++) {
+      frame[i] = frame[i] * level + original[i] * dry;
+    }
+  }
+  for (size_t i = 0; i < kFrame; i++) {
+    frame[i] = hpf.process(frame[i]);
+    frame[i] = lpf.process(frame[i]);
+  }
+  float sum = 0.0f;
+  for (size_t i = 0; i < kFrame; i++) sum += frame[i] * frame[i];
+  return sum;
+}
+
+float refPostGate(float* frame, float gain, float clampThresh,
+                  ComfortNoise& cn, float noiseScale) {
+  for (size_t i = 0; i < kFrame; i++) frame[i] *= gain;
+  if (clampThresh > 0.0f) {
+    for (size_t i = 0; i < kFrame; i++) {
+      if (std::abs(frame[i]) < clampThresh) frame[i] = 0.0f;
+    }
+  }
+  if (noiseScale > 0.0f) {
+    for (size_t i = 0; i < kFrame; i++) frame[i] += cn.sample() * noiseScale;
+  }
+  float sum = 0.0f;
+  for (size_t i = 0; i < kFrame; i++) sum += frame[i] * frame[i];
+  return sum;
+}
+
+void runScenario(const DspKernels& k, float level, float gain,
+                 float clampThresh, float noiseScale) {
+  BiquadState rh, rl, fh, fl;
+  makeFilters(rh, rl);
+  makeFilters(fh, fl);
+  ComfortNoise rcn, fcn;
+
+  /* Several consecutive frames so filter/noise state carry-over is covered. */
+  for (uint32_t f = 0; f < 8; f++) {
+    float ref[kFrame], fused[kFrame], original[kFrame];
+    makeFrame(ref, 7 + f);
+    for (size_t i = 0; i < kFrame; i++) {
+      fused[i] = ref[i];
+      original[i] = ref[i] / 32767.0f * 0.9f;
+    }
+
+    float refSum = refPreGate(ref, original, level, rh, rl);
+    float fusedSum = fusedPreGatePass(fused, original, kFrame, 1.0f / 32767.0f,
+                                      level, fh, fl);
+    bool exact = std::equal(ref, ref + kFrame, fused);
+    CHECK(exact, "[%s] pass A not bit-exact (level=%g, frame %u)", k.name,
+          level, f);
+    CHECK(near(refSum, fusedSum, 1e-5f), "[%s] pass A energy %g vs %g",
+          k.name, refSum, fusedSum);
+
+    refSum = refPostGate(ref, gain, clampThresh, rcn, noiseScale);
+    fusedSum = fusedPostGatePass(fused, kFrame, gain, clampThresh, &fcn,
+                                 noiseScale, k);
+    for (size_t i = 0; i < kFrame; i++) {
+      CHECK(near(ref[i], fused[i], 1e-5f), "[%s] pass B sample %zu: %g vs %g",
+            k.name, i, ref[i], fused[i]);
+    }
+    CHECK(near(refSum, fusedSum, 1e-4f), "[%s] pass B energy %g vs %g",
+          k.name, refSum, fusedSum);
+    CHECK(rcn.state == fcn.state && rcn.prev == fcn.prev,
+          "[%s] comfort noise state diverged", k.name);
+  }
+}
+
+}  // namespace
+
+int main() {
+  for (const DspKernels* k : supportedDspKernels()) {
+    std::printf("testing fused passes with %s kernels\n", k->name);
+    runScenario(*k, 1.0f, 1.0f, 0.0f, 0.0f);      /* speech: gate open */
+    runScenario(*k, 0.6f, 0.8f, 0.0f, 0.0f);      /* partial suppression */
+    runScenario(*k, 1.0f, 0.04f, 0.002f, 0.0f);   /* closing gate + clamp */
+    runScenario(*k, 1.0f, 0.0005f, 0.001f, 0.9f); /* closed: clamp + comfort noise */
+    runScenario(*k, 0.3f, 0.05f, 0.0f, 0.5f);     /* comfort noise, no clamp */
+  }
+
+  if (g_failures) {
+    std::fprintf(stderr, "%d failure(s)\n", g_failures);
+    return EXIT_FAILURE;
+  }
+  std::printf("fused passes match the reference pipeline\n");
+  return EXIT_SUCCESS;
+}
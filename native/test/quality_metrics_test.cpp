@@ -0,0 +1,193 @@
+/**
+ * Offline quality metrics.
+ *
+ * - readWav() decodes 16-bit PCM (stereo, mixed to mono), 24-bit PCM and
+ *   32-bit float files written here, and rejects non-WAV input.
+ * - snrDb() / segmentalSnrDb() give the analytic values for scaled
+ *   signals, cap identical signals and skip silent reference frames.
+ * - estimateDelay() recovers a known lag.
+ * - readLabels() / energyLabels() / scoreVad() agree with hand counts.
+ */
+
+#include <cmath>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <string>
+#include <vector>
+
+#include "quality_metrics.h"
+#include "test_util.h"
+
+using namespace ainoiceguard;
+
+namespace {
+
+constexpr double kPi = 3.14159265358979323846;
+
+std::string tempPath(const std::string& name) {
+  const char* dir = std::getenv("TMPDIR");
+  return std::string(dir ? dir : "/tmp") + "/quality_metrics_test_" + name;
+}
+
+void put16(std::string& s, uint16_t v) {
+  s.push_back(static_cast<char>(v & 0xFF));
+  s.push_back(static_cast<char>(v >> 8));
+}
+
+void put32(std::string& s, uint32_t v) {
+  put16(s, static_cast<uint16_t>(v & 0xFFFF));
+  put16(s, static_cast<uint16_t>(v >> 16));
+}
+
+/* Canonical 44-byte-header WAV around `payload`, plus an unknown chunk. */
+std::string writeWav(const std::string& name, uint16_t format, uint16_t channels,
+                     uint16_t bits, const std::string& payload) {
+  std::string f = "RIFF";
+  put32(f, static_cast<uint32_t>(4 + 8 + 16 + 8 + 4 + 8 + payload.size()));
+  f += "WAVEfmt ";
+  put32(f, 16);
+  put16(f, format);
+  put16(f, channels);
+  put32(f, 48000);
+  put32(f, 48000u * channels * bits / 8);
+  put16(f, static_cast<uint16_t>(channels * bits / 8));
+  put16(f, bits);
+  f += "LIST";
+  put32(f, 4);
+  f += "INFO";
+  f += "data";
+  put32(f, static_cast<uint32_t>(payload.size()));
+  f += payload;
+
+  std::string path = tempPath(name);
+  std::ofstream(path, std::ios::binary) << f;
+  return path;
+}
+
+void testWav() {
+  WavData wav;
+
+  /* 16-bit stereo: L = 0.5, R = -0.25 -> mono 0.125. */
+  std::string pcm16;
+  for (int i = 0; i < 4; i++) {
+    put16(pcm16, static_cast<uint16_t>(16384));
+    put16(pcm16, static_cast<uint16_t>(-8192));
+  }
+  std::string err = readWav(writeWav("s16.wav", 1, 2, 16, pcm16), &wav);
+  CHECK(err.empty(), "16-bit: %s", err.c_str());
+  CHECK(wav.sampleRate == 48000 && wav.samples.size() == 4, "16-bit: %u Hz, %zu samples",
+        wav.sampleRate, wav.samples.size());
+  CHECK(!wav.samples.empty() && std::abs(wav.samples[0] - 0.125f) < 1e-6f,
+        "16-bit mixdown %f", wav.samples.empty() ? 0.0f : wav.samples[0]);
+
+  /* 24-bit mono: -0.5 (0xC00000). */
+  std::string pcm24 = {'\x00', '\x00', '\xC0'};
+  err = readWav(writeWav("s24.wav", 1, 1, 24, pcm24), &wav);
+  CHECK(err.empty() && wav.samples.size() == 1 && std::abs(wav.samples[0] + 0.5f) < 1e-6f,
+        "24-bit: '%s' %zu", err.c_str(), wav.samples.size());
+
+  /* 32-bit float mono. */
+  std::string f32;
+  float v = 0.75f;
+  uint32_t u;
+  std::memcpy(&u, &v, sizeof(u));
+  put32(f32, u);
+  err = readWav(writeWav("f32.wav", 3, 1, 32, f32), &wav);
+  CHECK(err.empty() && wav.samples.size() == 1 && wav.samples[0] == 0.75f,
+        "float: '%s' %zu", err.c_str(), wav.samples.size());
+
+  /* 8-bit is not supported; neither is a non-WAV file. */
+  CHECK(!readWav(writeWav("u8.wav", 1, 1, 8, "abcd"), &wav).empty(), "8-bit accepted");
+  std::string junk = tempPath("junk.wav");
+  std::ofstream(junk) << "not a wav file at all";
+  CHECK(!readWav(junk, &wav).empty(), "junk accepted");
+  CHECK(!readWav(junk + ".missing", &wav).empty(), "missing file accepted");
+}
+
+void testSnr() {
+  const size_t n = 4800;
+  std::vector<float> ref(n), est(n);
+  for (size_t i = 0; i < n; i++) {
+    double t = static_cast<double>(i) / 48000.0;
+    ref[i] = static_cast<float>(0.5 * std::sin(2.0 * kPi * 440.0 * t));
+    est[i] = 0.9f * ref[i];  /* Error = 0.1 * ref -> 20 dB */
+  }
+  double snr = snrDb(ref.data(), est.data(), n);
+  CHECK(std::abs(snr - 20.0) < 1e-3, "SNR %.4f dB, expected 20", snr);
+  CHECK(snrDb(ref.data(), ref.data(), n) == 100.0, "identical signals not capped");
+
+  /* Segmental: half the frames silent (skipped), the rest at 20 dB. */
+  for (size_t i = n / 2; i < n; i++) ref[i] = est[i] = 0.0f;
+  double seg = segmentalSnrDb(ref.data(), est.data(), n, 480);
+  CHECK(std::abs(seg - 20.0) < 1e-3, "segmental SNR %.4f dB, expected 20", seg);
+
+  /* Per-frame clamp: error 4x the signal (-12 dB) counts as -10 dB. */
+  std::vector<float> wrong(n);
+  for (size_t i = 0; i < n; i++) wrong[i] = -3.0f * ref[i];
+  seg = segmentalSnrDb(ref.data(), wrong.data(), n, 480);
+  CHECK(std::abs(seg + 10.0) < 1e-9, "segmental SNR %.3f dB, expected -10 (clamped)", seg);
+}
+
+void testDelay() {
+  const size_t n = 9600, lag = 480;
+  std::vector<float> ref(n), est(n, 0.0f);
+  uint32_t seed = 3;
+  for (size_t i = 0; i < n; i++) {
+    seed = seed * 1664525u + 1013904223u;
+    ref[i] = static_cast<float>(static_cast<int32_t>(seed)) / 2147483648.0f;
+    if (i >= lag) est[i] = 0.8f * ref[i - lag];
+  }
+  size_t d = estimateDelay(ref.data(), est.data(), n, 960, 4800);
+  CHECK(d == lag, "delay %zu, expected %zu", d, lag);
+}
+
+void testVad() {
+  std::string path = tempPath("labels.txt");
+  /* Frames are 10 ms: speech 0.01-0.03 s -> frames 1, 2; 0.045-0.05 -> half of frame 4. */
+  std::ofstream(path) << "0.010000\t0.030000\tspeech\n\\\t100\t200\n0.045\t0.050\n";
+  std::vector<uint8_t> labels;
+  std::string err = readLabels(path, 48000.0, 480, 6, &labels);
+  CHECK(err.empty(), "labels: %s", err.c_str());
+  const std::vector<uint8_t> expected = {0, 1, 1, 0, 1, 0};
+  CHECK(labels == expected, "labels do not match the segments");
+
+  std::ofstream(path) << "0.5\n";
+  CHECK(!readLabels(path, 48000.0, 480, 6, &labels).empty(), "malformed label accepted");
+
+  std::vector<float> vad = {0.1f, 0.9f, 0.3f, 0.8f, 0.7f, 0.0f};
+  VadScore s = scoreVad(vad, expected, 0.5f);
+  /* Correct: 0, 1, 4, 5. Miss: frame 2. False alarm: frame 3. */
+  CHECK(s.frames == 6 && std::abs(s.accuracy - 4.0 / 6.0) < 1e-9,
+        "accuracy %.3f over %zu", s.accuracy, s.frames);
+  CHECK(std::abs(s.missRate - 1.0 / 3.0) < 1e-9, "miss rate %.3f", s.missRate);
+  CHECK(std::abs(s.falseAlarmRate - 1.0 / 3.0) < 1e-9, "false-alarm rate %.3f",
+        s.falseAlarmRate);
+
+  /* Energy labels: loud, 40 dB down, 20 dB down. */
+  std::vector<float> clean(3 * 480);
+  for (size_t i = 0; i < clean.size(); i++) {
+    float amp = i < 480 ? 0.5f : (i < 960 ? 0.005f : 0.05f);
+    clean[i] = (i & 1) ? amp : -amp;
+  }
+  std::vector<uint8_t> energy = energyLabels(clean.data(), clean.size(), 480);
+  CHECK(energy == std::vector<uint8_t>({1, 0, 1}), "energy labels");
+}
+
+}  // namespace
+
+int main() {
+  testWav();
+  testSnr();
+  testDelay();
+  testVad();
+
+  if (g_failures) {
+    std::fprintf(stderr, "%d failure(s)\n", g_failures);
+    return EXIT_FAILURE;
+  }
+  std::printf("quality metrics OK\n");
+  return EXIT_SUCCESS;
+}
@@ -0,0 +1,78 @@
+/**
+ * Shared fixtures for the tests that check RNNoiseWrapper against raw
+ * RNNoise states (rnnoise_wrapper_test, model_swap_test).
+ *
+ * The wrapper is run with an empty stage plan at full suppression
+ * (initPlain), so its output is exactly its RNNoise passes scaled back to
+ * [-1, 1]; RefPass mirrors one pass with its own DenoiseState, fed with
+ * the same frames in int16 range (toInt16Range).
+ */
+
+#ifndef AINOICEGUARD_RNNOISE_FIXTURES_H
+#define AINOICEGUARD_RNNOISE_FIXTURES_H
+
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+
+#include "rnnoise_kernels.h"
+#include "rnnoise_wrapper.h"
+
+namespace ainoiceguard {
+namespace test {
+
+constexpr size_t kN = kRNNoiseFrameSize;
+constexpr float kInvScale = 1.0f / 32767.0f;
+constexpr float kFadeStep = 1.0f / static_cast<float>(kN);
+
+/* Output match: the wrapper rescales with its own (vector) kernels. */
+constexpr float kTolerance = 1e-6f;
+
+/* One raw RNNoise pass: a DenoiseState on `model` (nullptr: built-in). */
+class RefPass {
+ public:
+  explicit RefPass(RNNModel* model = nullptr) : st_(rnnoiseKernels().create(model)) {}
+  ~RefPass() { rnnoiseKernels().destroy(st_); }
+  RefPass(const RefPass&) = delete;
+  RefPass& operator=(const RefPass&) = delete;
+
+  void run(float* out, const float* in) {
+    rnnoiseKernels().processFrame(st_, out, in);
+  }
+
+ private:
+  DenoiseState* st_;
+};
+
+/* White noise plus a 200 Hz tone, [-1, 1]. */
+inline void fillFrame(float* frame, size_t f, float noise, float tone, uint32_t* seed) {
+  for (size_t i = 0; i < kN; i++) {
+    *seed = *seed * 1664525u + 1013904223u;
+    float n = static_cast<float>(static_cast<int32_t>(*seed)) / 2147483648.0f;
+    float t = static_cast<float>(f * kN + i) / 48000.0f;
+    frame[i] = noise * n + tone * std::sin(6.2831853f * 200.0f * t);
+  }
+}
+
+inline void toInt16Range(const float* in, float* out) {
+  for (size_t i = 0; i < kN; i++) out[i] = in[i] * 32767.0f;
+}
+
+/* Largest |out - expect * kInvScale|. */
+inline float maxError(const float* out, const float* expect) {
+  float err = 0.0f;
+  for (size_t i = 0; i < kN; i++) err = std::max(err, std::fabs(out[i] - expect[i] * kInvScale));
+  return err;
+}
+
+/* Initialized wrapper whose output is exactly its RNNoise passes. */
+inline void initPlain(RNNoiseWrapper& w, SecondPassMode mode = SecondPassMode::kAlways) {
+  w.init();
+  w.setStagePlan(StagePlan());
+  w.setSecondPassMode(mode);
+}
+
+}  // namespace test
+}  // namespace ainoiceguard
+
+#endif  // AINOICEGUARD_RNNOISE_FIXTURES_H
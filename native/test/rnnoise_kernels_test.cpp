@@ -0,0 +1,115 @@
+/**
+ * RNNoise copy conformance test: every RNNoise copy supported by this CPU
+ * must denoise like the generic one. The AVX2 / AVX-512 copies are the
+ * same sources compiled with FMA and wider vectors, so outputs may differ
+ * by rounding, never by more.
+ *
+ * Run via ctest (configure with -DNOISEGUARD_BUILD_TESTS=ON).
+ */
+
+#include <cmath>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <vector>
+
+#include "rnnoise_kernels.h"
+#include "test_util.h"
+
+using ainoiceguard::RNNoiseKernels;
+
+namespace {
+
+constexpr size_t kFrame = 480;
+constexpr double kPi = 3.14159265358979;
+constexpr size_t kFrames = 300;  /* 3 s: long enough for the GRUs to drift */
+
+/* Output-vs-generic floor. Rounding alone stays far above it. */
+constexpr double kMinSnrDb = 40.0;
+constexpr double kMaxMeanVadDiff = 0.02;
+
+/* Voiced-like tone pair with a slow envelope over LCG noise, int16 scale. */
+std::vector<float> makeInput() {
+  std::vector<float> v(kFrame * kFrames);
+  uint32_t seed = 12345u;
+  for (size_t i = 0; i < v.size(); i++) {
+    seed = seed * 1664525u + 1013904223u;
+    double noise = static_cast<int32_t>(seed) / 2147483648.0;
+    double t = static_cast<double>(i) / 48000.0;
+    double env = 0.5 + 0.5 * std::sin(2.0 * kPi * 0.7 * t);
+    double voice = env * (std::sin(2.0 * kPi * 180.0 * t) +
+                          0.5 * std::sin(2.0 * kPi * 360.0 * t));
+    v[i] = static_cast<float>(3000.0 * voice + 800.0 * noise);
+  }
+  return v;
+}
+
+/* Runs one copy over the input; returns the output and per-frame VAD. */
+void run(const RNNoiseKernels& k, const std::vector<float>& in,
+         std::vector<float>* out, std::vector<float>* vad) {
+  DenoiseState* st = k.create(nullptr);
+  CHECK(st != nullptr, "[%s] create", k.name);
+  if (!st) return;
+  out->assign(in.size(), 0.0f);
+  vad->assign(kFrames, 0.0f);
+  for (size_t f = 0; f < kFrames; f++) {
+    (*vad)[f] = k.processFrame(st, out->data() + f * kFrame,
+                               in.data() + f * kFrame);
+  }
+  k.destroy(st);
+}
+
+void testCopy(const RNNoiseKernels& ref, const RNNoiseKernels& k,
+              const std::vector<float>& in) {
+  std::vector<float> refOut, refVad, out, vad;
+  run(ref, in, &refOut, &refVad);
+  run(k, in, &out, &vad);
+  if (out.size() != refOut.size() || vad.size() != refVad.size()) return;
+
+  double sig = 0.0, err = 0.0;
+  for (size_t i = 0; i < out.size(); i++) {
+    CHECK(std::isfinite(out[i]), "[%s] non-finite output at %zu", k.name, i);
+    if (!std::isfinite(out[i])) return;
+    sig += static_cast<double>(refOut[i]) * refOut[i];
+    err += static_cast<double>(out[i] - refOut[i]) * (out[i] - refOut[i]);
+  }
+  double snr = err > 0.0 ? 10.0 * std::log10(sig / err) : 999.0;
+  CHECK(snr >= kMinSnrDb, "[%s] output vs %s: %.1f dB < %.1f dB",
+        k.name, ref.name, snr, kMinSnrDb);
+
+  double vadDiff = 0.0;
+  for (size_t f = 0; f < kFrames; f++) vadDiff += std::abs(vad[f] - refVad[f]);
+  vadDiff /= kFrames;
+  CHECK(vadDiff <= kMaxMeanVadDiff, "[%s] mean VAD diff %.4f > %.4f",
+        k.name, vadDiff, kMaxMeanVadDiff);
+
+  std::printf("%s: %.1f dB vs %s, mean VAD diff %.4f\n",
+              k.name, snr, ref.name, vadDiff);
+}
+
+}  // namespace
+
+int main() {
+  auto copies = ainoiceguard::supportedRNNoiseKernels();
+  const RNNoiseKernels& selected = ainoiceguard::rnnoiseKernels();
+  std::printf("dispatch selects: %s\n", selected.name);
+
+  CHECK(!copies.empty() && std::strcmp(copies.front()->name, "generic") == 0,
+        "generic copy must always be supported");
+  CHECK(!copies.empty() && &selected == copies.back(),
+        "dispatch must pick the widest supported copy");
+
+  const std::vector<float> in = makeInput();
+  for (const RNNoiseKernels* k : copies) {
+    if (k == copies.front()) continue;
+    testCopy(*copies.front(), *k, in);
+  }
+
+  if (g_failures) {
+    std::fprintf(stderr, "%d failure(s)\n", g_failures);
+    return EXIT_FAILURE;
+  }
+  std::printf("all RNNoise copies match generic\n");
+  return EXIT_SUCCESS;
+}
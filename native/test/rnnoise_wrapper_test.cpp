@@ -0,0 +1,248 @@
+/**
+ * RNNoiseWrapper frame routing, checked against raw RNNoise states.
+ *
+ * Every case runs an empty stage plan at full suppression, so the wrapper
+ * emits exactly what its RNNoise passes produce (scaled back to [-1, 1]),
+ * and mirrors the passes with its own DenoiseStates:
+ *
+ * - Second pass switched off and on mid-stream: skipped frames emit the
+ *   previous pass-1 frame (pass1Delay_), so latency never changes;
+ *   switching crossfades and the re-primed state2 picks up in step.
+ * - Adaptive mode: every frame the residual pass skipped is the delayed
+ *   pass-1 frame.
+ * - Digital silence: inference stops after kDigitalSilenceFrames silent
+ *   frames, output is silence, and the first frame with signal resumes
+ *   the states where they stopped.
+ * - prewarm(): leaves metrics and the imported calibration exactly as
+ *   init() set them.
+ */
+
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+
+#include "rnnoise_fixtures.h"
+#include "rnnoise_wrapper.h"
+#include "test_util.h"
+
+using namespace ainoiceguard;
+using namespace ainoiceguard::test;
+
+namespace {
+
+/* Silent frames before the fast path engages. */
+constexpr size_t kSilenceEntryFrames = kDigitalSilenceFrames;
+
+void testSecondPassSwitching() {
+  constexpr size_t kFrames = 120;
+  constexpr size_t kOffAt = 40;  /* Governor sheds pass 2 ... */
+  constexpr size_t kOnAt = 80;   /* ... and restores it */
+
+  RNNoiseWrapper w;
+  initPlain(w, SecondPassMode::kAlways);
+  RefPass pass1, pass2;
+  float delay[kN] = {};  /* Previous pass-1 frame */
+  bool active = true;
+  uint32_t seed = 1;
+
+  for (size_t f = 0; f < kFrames; f++) {
+    if (f == kOffAt) w.setQualityTier(QualityTier::kSinglePass);
+    if (f == kOnAt) w.setQualityTier(QualityTier::kFull);
+    const bool want = f < kOffAt || f >= kOnAt;
+
+    float frame[kN], in[kN], p1[kN], p2[kN], expect[kN];
+    fillFrame(frame, f, 0.05f, 0.2f, &seed);
+    toInt16Range(frame, in);
+    pass1.run(p1, in);
+
+    if (want) {
+      if (!active) {
+        float scratch[kN];
+        pass2.run(scratch, delay);  /* Re-prime on the frame it missed */
+      }
+      pass2.run(p2, p1);
+      for (size_t i = 0; i < kN; i++) {
+        float wt = static_cast<float>(i) * kFadeStep;
+        expect[i] = active ? p2[i] : delay[i] * (1.0f - wt) + p2[i] * wt;
+      }
+    } else if (active) {
+      pass2.run(p2, p1);
+      for (size_t i = 0; i < kN; i++) {
+        float wt = static_cast<float>(i) * kFadeStep;
+        expect[i] = p2[i] * (1.0f - wt) + delay[i] * wt;
+      }
+    } else {
+      std::memcpy(expect, delay, sizeof(expect));  /* One frame late, like pass 2 */
+    }
+    const bool ran = want || active;
+    std::memcpy(delay, p1, sizeof(delay));
+    active = want;
+
+    const uint64_t before = w.metrics().pass2Frames.load();
+    w.processFrame(frame);
+    const bool wrapperRan = w.metrics().pass2Frames.load() != before;
+    CHECK(wrapperRan == ran, "frame %zu: pass 2 ran=%d, expected %d", f, wrapperRan, ran);
+    float err = maxError(frame, expect);
+    CHECK(err <= kTolerance, "frame %zu: output off by %g", f, err);
+  }
+}
+
+void testAdaptiveSkipKeepsDelay() {
+  constexpr size_t kLoudFrames = 60;
+  constexpr size_t kFrames = 300;
+
+  RNNoiseWrapper w;
+  initPlain(w, SecondPassMode::kAdaptive);
+  RefPass pass1;
+  float prev[kN] = {};  /* Previous pass-1 frame */
+  size_t skipped = 0;
+  uint32_t seed = 7;
+
+  for (size_t f = 0; f < kFrames; f++) {
+    /* Noisy start, then a quiet room: pass 1 alone leaves nothing audible. */
+    float frame[kN], in[kN], p1[kN];
+    if (f < kLoudFrames) {
+      fillFrame(frame, f, 0.05f, 0.2f, &seed);
+    } else {
+      fillFrame(frame, f, 1e-4f, 0.0f, &seed);
+    }
+    toInt16Range(frame, in);
+    pass1.run(p1, in);
+
+    const uint64_t before = w.metrics().pass2Frames.load();
+    w.processFrame(frame);
+    if (w.metrics().pass2Frames.load() == before) {
+      skipped++;
+      float err = maxError(frame, prev);
+      CHECK(err <= kTolerance, "skipped frame %zu is not the delayed pass-1 frame (off by %g)",
+            f, err);
+    }
+    std::memcpy(prev, p1, sizeof(prev));
+  }
+  CHECK(skipped > 0, "adaptive pass 2 never skipped in a quiet room");
+}
+
+void testDigitalSilence() {
+  constexpr size_t kSignalFrames = 30;
+  constexpr size_t kSilentFrames = 50;
+  constexpr size_t kFrames = 2 * kSignalFrames + kSilentFrames;
+  constexpr size_t kFastFrames = kSilentFrames - kSilenceEntryFrames;
+
+  RNNoiseWrapper w;
+  initPlain(w, SecondPassMode::kAlways);
+  RefPass pass1, pass2;
+  uint32_t seed = 3;
+  float dutyBefore = 0.0f;
+
+  for (size_t f = 0; f < kFrames; f++) {
+    const bool silent = f >= kSignalFrames && f < kSignalFrames + kSilentFrames;
+    const bool fastPath = silent && f - kSignalFrames >= kSilenceEntryFrames;
+
+    float frame[kN];
+    if (silent) {
+      std::memset(frame, 0, sizeof(frame));
+    } else {
+      fillFrame(frame, f, 0.01f, 0.1f, &seed);
+    }
+    if (f == kSignalFrames + kSilenceEntryFrames) {
+      dutyBefore = w.metrics().pass2DutyCycle.load();
+    }
+
+    /* The fast path keeps the states where the last inferred frame left them. */
+    float expect[kN];
+    if (!fastPath) {
+      float in[kN], p1[kN];
+      toInt16Range(frame, in);
+      pass1.run(p1, in);
+      pass2.run(expect, p1);
+    }
+
+    const uint64_t before = w.metrics().pass2Frames.load();
+    w.processFrame(frame);
+    const bool ran = w.metrics().pass2Frames.load() != before;
+    CHECK(ran == !fastPath, "frame %zu: inference ran=%d on the %s path", f, ran,
+          fastPath ? "fast" : "normal");
+
+    if (fastPath) {
+      float peak = 0.0f;
+      for (size_t i = 0; i < kN; i++) peak = std::max(peak, std::fabs(frame[i]));
+      CHECK(peak == 0.0f, "frame %zu: fast path emitted %g", f, peak);
+    } else {
+      float err = maxError(frame, expect);
+      CHECK(err <= kTolerance, "frame %zu: output off by %g", f, err);
+    }
+  }
+
+  const AudioMetrics& m = w.metrics();
+  CHECK(m.silentFrames.load() == kFastFrames, "%llu fast-path frames, expected %zu",
+        static_cast<unsigned long long>(m.silentFrames.load()), kFastFrames);
+  CHECK(m.framesProcessed.load() == kFrames, "%llu frames processed",
+        static_cast<unsigned long long>(m.framesProcessed.load()));
+  /* Silence counts as skipped pass 2; the signal after it pulls the share back up. */
+  CHECK(m.pass2DutyCycle.load() < dutyBefore, "duty cycle %g did not drop from %g",
+        m.pass2DutyCycle.load(), dutyBefore);
+}
+
+void testPrewarmResets() {
+  Calibration c;
+  c.noiseFloor = 0.002f;
+  c.calibratedFrames = 50;
+  c.residualFloor = 0.0003f;
+  c.gateGain = 0.5f;
+
+  RNNoiseWrapper w;
+  w.prewarm(10);  /* Before init(): nothing to warm */
+  CHECK(w.metrics().framesProcessed.load() == 0, "prewarm ran without states");
+
+  CHECK(w.importCalibration(c), "calibration rejected");
+  CHECK(w.init(), "init failed");
+  w.setSecondPassMode(SecondPassMode::kAdaptive);
+  w.prewarm(50);
+
+  const AudioMetrics& m = w.metrics();
+  CHECK(m.framesProcessed.load() == 0, "%llu frames left in the metrics",
+        static_cast<unsigned long long>(m.framesProcessed.load()));
+  CHECK(m.pass2Frames.load() == 0 && m.silentFrames.load() == 0, "pass counters not reset");
+  CHECK(m.pass2DutyCycle.load() == 1.0f, "duty cycle %g", m.pass2DutyCycle.load());
+  CHECK(m.vadProbability.load() == 0.0f && m.inputRms.load() == 0.0f &&
+            m.outputRms.load() == 0.0f,
+        "level metrics not reset");
+  CHECK(m.noiseFloor.load() == c.noiseFloor && m.currentGain.load() == c.gateGain,
+        "metrics show floor %g gain %g, not the imported calibration",
+        m.noiseFloor.load(), m.currentGain.load());
+
+  /* The gate starts from the imported calibration, not from the synthetic noise. */
+  const Calibration after = w.exportCalibration();
+  CHECK(after.noiseFloor == c.noiseFloor && after.calibratedFrames == c.calibratedFrames &&
+            after.residualFloor == c.residualFloor && after.gateGain == c.gateGain,
+        "calibration after prewarm: floor %g frames %u residual %g gain %g",
+        after.noiseFloor, after.calibratedFrames, after.residualFloor, after.gateGain);
+
+  float frame[kN];
+  uint32_t seed = 5;
+  fillFrame(frame, 0, 0.01f, 0.1f, &seed);
+  w.processFrame(frame);
+  CHECK(m.framesProcessed.load() == 1 && m.pass2Frames.load() == 1,
+        "first real frame: %llu processed, %llu through pass 2",
+        static_cast<unsigned long long>(m.framesProcessed.load()),
+        static_cast<unsigned long long>(m.pass2Frames.load()));
+}
+
+}  // namespace
+
+int main() {
+  testSecondPassSwitching();
+  testAdaptiveSkipKeepsDelay();
+  testDigitalSilence();
+  testPrewarmResets();
+
+  if (g_failures) {
+    std::fprintf(stderr, "%d failure(s)\n", g_failures);
+    return EXIT_FAILURE;
+  }
+  std::printf("rnnoise_wrapper OK\n");
+  return EXIT_SUCCESS;
+}
@@ -0,0 +1,181 @@
+/**
+ * Stage plans and specialized chains.
+ *
+ * - StagePlan packing: order, membership, the fused flag, duplicate and
+ *   capacity rejection, name round-trips, the lean plan.
+ * - fusedPreGatePass with filters dropped must match running only the
+ *   remaining stages one after another, bit-for-bit, and must leave the
+ *   dropped filter's state untouched.
+ * - A StageChain must equal its stages applied one sweep at a time.
+ */
+
+#include <cmath>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <string>
+
+#include "filter_fixtures.h"
+#include "stage_chain.h"
+#include "test_util.h"
+
+using namespace ainoiceguard;
+using namespace ainoiceguard::test;
+
+namespace {
+
+bool sameState(const BiquadState& a, const BiquadState& b) {
+  return a.s1 == b.s1 && a.s2 == b.s2;
+}
+
+void testPlanPacking() {
+  StagePlan d = StagePlan::defaults();
+  CHECK(d.size() == 6, "defaults size %zu", d.size());
+  CHECK(d.fused(), "defaults must be fused");
+  CHECK(d.at(0) == StageId::kHighPass && d.at(5) == StageId::kComfortNoise,
+        "defaults order");
+  CHECK(StagePlan::fromPacked(d.packed()) == d, "packed round-trip");
+
+  StagePlan empty;
+  CHECK(empty.size() == 0 && empty.fused(), "empty plan is fused");
+
+  /* Canonical subset stays fused. */
+  StagePlan sub;
+  sub.append(StageId::kLowPass);
+  sub.append(StageId::kComfortNoise);
+  CHECK(sub.fused(), "canonical subset must be fused");
+  CHECK(sub.contains(StageId::kLowPass) && !sub.contains(StageId::kHighPass),
+        "membership");
+
+  /* Reordering or a custom stage drops to the per-stage path. */
+  StagePlan reordered;
+  reordered.append(StageId::kGate);
+  reordered.append(StageId::kHighPass);
+  CHECK(!reordered.fused(), "reordered plan must not be fused");
+  CHECK(reordered.at(0) == StageId::kGate && reordered.at(1) == StageId::kHighPass,
+        "reordered order");
+
+  StagePlan custom;
+  custom.append(StageId::kHighPass);
+  custom.append(StageId::kCustom0);
+  CHECK(!custom.fused(), "custom plan must not be fused");
+
+  /* Duplicates, invalid ids and overflow are rejected. */
+  CHECK(!sub.append(StageId::kLowPass), "duplicate accepted");
+  CHECK(!sub.append(StageId::kNone), "kNone accepted");
+  CHECK(!sub.append(static_cast<StageId>(7)), "invalid id accepted");
+
+  StagePlan full = StagePlan::defaults();
+  for (size_t c = 0; c < kMaxCustomStages; c++) {
+    CHECK(full.append(static_cast<StageId>(
+              static_cast<size_t>(StageId::kCustom0) + c)),
+          "custom %zu rejected", c);
+  }
+  CHECK(full.size() == 10, "full size %zu", full.size());
+
+  /* Lean: built-ins without the filter bank, canonical order, fused. */
+  StagePlan lean = full.lean();
+  CHECK(lean.size() == 5 && lean.fused(), "lean size %zu", lean.size());
+  CHECK(!lean.contains(StageId::kFilterBank) && !lean.contains(StageId::kCustom0),
+        "lean keeps the filter bank / custom stages");
+  CHECK(reordered.lean().fused() && reordered.lean().at(0) == StageId::kHighPass,
+        "lean must restore canonical order");
+
+  /* Names round-trip. */
+  for (size_t i = 0; i < full.size(); i++) {
+    StageId id = StageId::kNone;
+    CHECK(stageFromName(stageName(full.at(i)), &id) && id == full.at(i),
+          "name round-trip for %s", stageName(full.at(i)));
+  }
+  StageId id;
+  CHECK(!stageFromName("reverb", &id), "unknown name accepted");
+}
+
+void testPreGateSubsets() {
+  for (int mask = 0; mask < 4; mask++) {
+    for (float level : {1.0f, 0.5f}) {
+      BiquadState rh, rl, fh, fl;
+      makeFilters(rh, rl);
+      makeFilters(fh, fl);
+      const bool useHpf = mask & 1;
+      const bool useLpf = mask & 2;
+
+      for (uint32_t f = 0; f < 4; f++) {
+        float ref[kFrame], out[kFrame], original[kFrame];
+        makeFrame(ref, 11 + f);
+        for (size_t i = 0; i < kFrame; i++) {
+          out[i] = ref[i];
+          original[i] = ref[i] / 32767.0f * 0.9f;
+        }
+
+        /* Reference: remaining stages, one sweep each. */
+        for (size_t i = 0; i < kFrame; i++) {
+          float y = ref[i] * (1.0f / 32767.0f);
+          if (level < 1.0f) y = y * level + original[i] * (1.0f - level);
+          ref[i] = y;
+        }
+        if (useHpf) for (size_t i = 0; i < kFrame; i++) ref[i] = rh.process(ref[i]);
+        if (useLpf) for (size_t i = 0; i < kFrame; i++) ref[i] = rl.process(ref[i]);
+
+        fusedPreGatePass(out, original, kFrame, 1.0f / 32767.0f, level,
+                         useHpf ? &fh : nullptr, useLpf ? &fl : nullptr);
+
+        bool exact = true;
+        for (size_t i = 0; i < kFrame; i++) exact = exact && ref[i] == out[i];
+        CHECK(exact, "subset hpf=%d lpf=%d level=%g frame %u not bit-exact",
+              useHpf, useLpf, level, f);
+      }
+      CHECK(sameState(rh, fh) && sameState(rl, fl),
+            "filter state diverged (hpf=%d lpf=%d)", useHpf, useLpf);
+    }
+  }
+}
+
+void testChainEqualsSequence() {
+  float ref[kFrame], out[kFrame];
+  makeFrame(ref, 3);
+  for (size_t i = 0; i < kFrame; i++) {
+    ref[i] *= 1.0f / 32767.0f;
+    out[i] = ref[i];
+  }
+
+  StageFrame p;
+  p.gain = 0.3f;
+  p.clampThresh = 0.01f;
+  p.noiseScale = 0.7f;
+
+  ComfortNoise rcn, fcn;
+  for (size_t i = 0; i < kFrame; i++) ref[i] *= p.gain;
+  for (size_t i = 0; i < kFrame; i++) {
+    if (std::abs(ref[i]) < p.clampThresh) ref[i] = 0.0f;
+  }
+  for (size_t i = 0; i < kFrame; i++) ref[i] += rcn.sample() * p.noiseScale;
+  float refSum = 0.0f;
+  for (size_t i = 0; i < kFrame; i++) refSum += ref[i] * ref[i];
+
+  float sum = StageChain<GainStage, ClampStage, NoiseStage>(
+                  GainStage{}, ClampStage{}, NoiseStage(&fcn))
+                  .run(out, kFrame, p);
+
+  bool exact = true;
+  for (size_t i = 0; i < kFrame; i++) exact = exact && ref[i] == out[i];
+  CHECK(exact, "chain output differs from the stage sequence");
+  CHECK(sum == refSum, "chain energy %g vs %g", sum, refSum);
+  CHECK(rcn.state == fcn.state && rcn.prev == fcn.prev,
+        "noise state not written back");
+}
+
+}  // namespace
+
+int main() {
+  testPlanPacking();
+  testPreGateSubsets();
+  testChainEqualsSequence();
+
+  if (g_failures) {
+    std::fprintf(stderr, "%d failure(s)\n", g_failures);
+    return EXIT_FAILURE;
+  }
+  std::printf("stage plans and chains OK\n");
+  return EXIT_SUCCESS;
+}
@@ -0,0 +1,29 @@
+/**
+ * Shared harness for the native tests.
+ *
+ * CHECK(cond, fmt, ...) prints the failing file:line and message to stderr
+ * and counts the failure in g_failures without stopping the test, so one
+ * run reports every broken case. main() returns EXIT_FAILURE when
+ * g_failures is nonzero.
+ *
+ * Each test is its own executable, so the counter lives in the header.
+ */
+
+#ifndef AINOICEGUARD_TEST_UTIL_H
+#define AINOICEGUARD_TEST_UTIL_H
+
+#include <cstdio>
+
+inline int g_failures = 0;
+
+#define CHECK(cond, ...)                                         \
+  do {                                                           \
+    if (!(cond)) {                                               \
+      std::fprintf(stderr, "FAIL %s:%d: ", __FILE__, __LINE__);  \
+      std::fprintf(stderr, __VA_ARGS__);                         \
+      std::fprintf(stderr, "\n");                                \
+      g_failures++;                                              \
+    }                                                            \
+  } while (0)
+
+#endif  // AINOICEGUARD_TEST_UTIL_H
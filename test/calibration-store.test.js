@@ -0,0 +1,58 @@
+const test = require('node:test')
+const assert = require('node:assert/strict')
+const fs = require('fs')
+const os = require('os')
+const path = require('path')
+const { createCalibrationStore, deviceKey } = require('../electron/calibration-store')
+
+const sample = { noiseFloor: 0.0021, calibratedFrames: 200, residualFloor: 0.0004, gateGain: 0.0005 }
+
+function tempFile () {
+  const dir = fs.mkdtempSync(path.join(os.tmpdir(), 'calibration-'))
+  return path.join(dir, 'nested', 'calibration.json')
+}
+
+test('saves and loads calibration per device', () => {
+  const file = tempFile()
+  const store = createCalibrationStore(file)
+  assert.equal(store.load('USB Mic'), null)
+  assert.equal(store.save('USB Mic', { ...sample, extra: 'ignored' }), true)
+  assert.equal(store.save('default', { ...sample, noiseFloor: 0.01 }), true)
+
+  const reopened = createCalibrationStore(file)
+  assert.deepEqual(reopened.load('USB Mic'), sample)
+  assert.equal(reopened.load('default').noiseFloor, 0.01)
+  assert.equal(fs.existsSync(file + '.tmp'), false)
+})
+
+test('drops stale entries', () => {
+  let clock = 1000
+  const store = createCalibrationStore(tempFile(), { maxAgeMs: 500, now: () => clock })
+  store.save('mic', sample)
+  clock = 1400
+  assert.deepEqual(store.load('mic'), sample)
+  clock = 1600
+  assert.equal(store.load('mic'), null)
+})
+
+test('rejects malformed calibration and survives a corrupt file', () => {
+  const file = tempFile()
+  const store = createCalibrationStore(file)
+  assert.equal(store.save('mic', { ...sample, gateGain: NaN }), false)
+  assert.equal(store.save('mic', { noiseFloor: 0.1 }), false)
+  assert.equal(store.save('mic', null), false)
+
+  fs.mkdirSync(path.dirname(file), { recursive: true })
+  fs.writeFileSync(file, '{ not json')
+  assert.equal(store.load('mic'), null)
+  assert.equal(store.save('mic', sample), true)
+  assert.deepEqual(store.load('mic'), sample)
+})
+
+test('deviceKey uses the input device name', () => {
+  const devices = { inputs: [{ index: 3, name: 'USB Mic' }], outputs: [] }
+  assert.equal(deviceKey(devices, 3), 'USB Mic')
+  assert.equal(deviceKey(devices, -1), 'default')
+  assert.equal(deviceKey(devices, 7), 'default')
+  assert.equal(deviceKey(undefined, 3), 'default')
+})
@@ -0,0 +1,35 @@
+const test = require('node:test')
+const assert = require('node:assert/strict')
+const fs = require('fs')
+const os = require('os')
+const path = require('path')
+const { createJsonStore } = require('../electron/json-store')
+
+function tempFile () {
+  const dir = fs.mkdtempSync(path.join(os.tmpdir(), 'json-store-'))
+  return path.join(dir, 'nested', 'store.json')
+}
+
+test('round-trips entries through a temp file', () => {
+  const file = tempFile()
+  const store = createJsonStore(file, 1)
+  assert.deepEqual(store.read(), { version: 1, devices: {} })
+
+  const data = store.read()
+  data.devices.mic = { savedAt: 5, value: 1 }
+  store.write(data)
+  assert.deepEqual(createJsonStore(file, 1).read(), data)
+  assert.equal(fs.existsSync(file + '.tmp'), false)
+})
+
+test('reads a corrupt or other-version file as empty', () => {
+  const file = tempFile()
+  fs.mkdirSync(path.dirname(file), { recursive: true })
+  fs.writeFileSync(file, '{ not json')
+  assert.deepEqual(createJsonStore(file, 1).read(), { version: 1, devices: {} })
+
+  fs.writeFileSync(file, JSON.stringify({ version: 2, devices: { mic: {} } }))
+  assert.deepEqual(createJsonStore(file, 1).read(), { version: 1, devices: {} })
+  fs.writeFileSync(file, JSON.stringify({ version: 1, devices: null }))
+  assert.deepEqual(createJsonStore(file, 1).read(), { version: 1, devices: {} })
+})
@@ -0,0 +1,130 @@
+const test = require('node:test')
+const assert = require('node:assert/strict')
+const fs = require('fs')
+const os = require('os')
+const path = require('path')
+const {
+  candidateProfiles,
+  createProfileStore,
+  pickProfile,
+  profileKey,
+  runAutoTune
+} = require('../electron/latency-profiles')
+
+const devices = {
+  inputs: [{ index: 1, name: 'USB Mic', hostApi: 'ALSA', lowLatencyMs: 5, highLatencyMs: 40 }],
+  outputs: [{ index: 2, name: 'Headset', hostApi: 'ALSA', lowLatencyMs: 10, highLatencyMs: 60 }]
+}
+
+function tempFile () {
+  const dir = fs.mkdtempSync(path.join(os.tmpdir(), 'latency-profiles-'))
+  return path.join(dir, 'nested', 'latency-profiles.json')
+}
+
+/* Fake addon: a profile is clean when its host buffer is at least `minFrames`. */
+function fakeAddon (minFrames) {
+  let running = null
+  let xruns = 0
+  let underruns = 0
+  let frames = 0
+  const started = []
+  return {
+    started,
+    getDevices: () => devices,
+    start (inputIdx, outputIdx, options) {
+      assert.equal(running, null)
+      running = options
+      started.push(options)
+      return ''
+    },
+    stop () { running = null },
+    tick () {
+      frames += 100
+      if (running.framesPerBuffer < minFrames) {
+        xruns += 2
+        underruns += 4800
+      }
+    },
+    getCallbackTiming: () => ({
+      captureJitterMaxMs: 0.5,
+      captureJitterMeanMs: 0.1,
+      outputJitterMaxMs: 0.5,
+      outputJitterMeanMs: 0.1
+    }),
+    getAnomalies: () => ({
+      deadlineMisses: 0,
+      framesTimed: frames,
+      underrunSamples: underruns,
+      xruns: { inputUnderflow: 0, inputOverflow: xruns, outputUnderflow: 0, outputOverflow: 0, restarts: 0 }
+    }),
+    getLatency: () => ({
+      totalMs: running.inputLatencyMs + running.outputLatencyMs + running.framesPerBuffer / 24 + 20
+    })
+  }
+}
+
+test('profileKey includes device names and host API', () => {
+  assert.equal(profileKey(devices, 1, 2), 'USB Mic [ALSA] -> Headset [ALSA]')
+  assert.equal(profileKey(devices, -1, 2), 'default -> Headset [ALSA]')
+  assert.equal(profileKey(undefined, 1, 2), 'default -> default')
+})
+
+test('candidates are ordered by expected latency', () => {
+  const candidates = candidateProfiles(devices, 1, 2)
+  assert.equal(candidates.length, 6)
+  assert.deepEqual(candidates[0], { framesPerBuffer: 128, inputLatencyMs: 5, outputLatencyMs: 10 })
+  assert.deepEqual(candidates[5], { framesPerBuffer: 480, inputLatencyMs: 40, outputLatencyMs: 60 })
+
+  /* Default devices: no low/high split, one candidate per buffer size. */
+  assert.deepEqual(candidateProfiles(devices, -1, -1).map((c) => c.framesPerBuffer), [128, 256, 480])
+})
+
+test('auto-tune picks the lowest-latency clean profile', async () => {
+  const addon = fakeAddon(256)
+  const result = await runAutoTune(addon, 1, 2, {
+    trialMs: 1000,
+    warmupMs: 0,
+    sleep: async (ms) => { if (ms > 0) addon.tick() }
+  })
+  assert.equal(addon.started.length, 6)
+  assert.equal(result.trials.length, 6)
+  assert.equal(result.profile.framesPerBuffer, 256)
+  assert.equal(result.profile.inputLatencyMs, 5)
+  assert.equal(result.profile.outputLatencyMs, 10)
+})
+
+test('pickProfile returns null when nothing is stable', () => {
+  const trial = {
+    profile: { framesPerBuffer: 480, inputLatencyMs: 0, outputLatencyMs: 0 },
+    durationMs: 1000,
+    latencyMs: 30,
+    jitterMaxMs: 1,
+    xruns: 1,
+    restarts: 0,
+    underrunSamples: 0,
+    deadlineMisses: 0,
+    framesTimed: 100
+  }
+  assert.equal(pickProfile([trial]), null)
+  assert.equal(pickProfile([{ ...trial, xruns: 0, jitterMaxMs: 12 }]), null)
+  assert.equal(pickProfile([{ ...trial, xruns: 0 }]).framesPerBuffer, 480)
+})
+
+test('store saves, loads and removes profiles', () => {
+  const file = tempFile()
+  const store = createProfileStore(file)
+  const profile = { framesPerBuffer: 256, inputLatencyMs: 5, outputLatencyMs: 10, latencyMs: 41 }
+  assert.equal(store.load('k'), null)
+  assert.equal(store.save('k', profile), true)
+  assert.equal(store.save('bad', { framesPerBuffer: -1, inputLatencyMs: 0, outputLatencyMs: 0 }), false)
+
+  const reopened = createProfileStore(file)
+  assert.deepEqual(reopened.load('k'), { framesPerBuffer: 256, inputLatencyMs: 5, outputLatencyMs: 10 })
+  assert.equal(fs.existsSync(file + '.tmp'), false)
+  assert.equal(reopened.remove('k'), true)
+  assert.equal(reopened.load('k'), null)
+
+  fs.writeFileSync(file, '{ not json')
+  assert.equal(store.load('k'), null)
+  assert.equal(store.save('k', profile), true)
+})